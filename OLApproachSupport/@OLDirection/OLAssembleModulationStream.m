@@ -0,0 +1,53 @@
+function stream = OLAssembleModulationStream(directions, waveforms, varargin)
+% Assemble OLDirections and temporal waveforms into a modulation stream
+%
+% Syntax:
+%   stream = OLAssembleModulationStream(OLDirections, waveforms)
+%   stream = OLAssembleModulationStream(...,'cacheSize',200)
+%
+% Description:
+%    Like OLAssembleModulation, but rather than forming the primaries,
+%    predicted spds and starts/stops for every timepoint up front, return
+%    an OLModulationStream that produces the primaries and starts/stops
+%    of each timepoint when asked.  Memory use does not grow with the
+%    length of the modulation, and playback (e.g. with OLFlicker) can start
+%    as soon as the first frame is converted.
+%
+% Inputs:
+%    direction  - OLDirection objects specifying the directions to create
+%                 modulation of.
+%    waveform   - NxT matrix of differential scalars (in range [-1,1]) on
+%                 each of the N directions, at each timepoint T.
+%
+% Outputs:
+%    stream     - OLModulationStream object.
+%
+% Optional key/value pairs.
+%    'cacheSize' - Number of converted timepoints the stream keeps.
+%                  Default 200.
+%
+% See also:
+%    OLAssembleModulation, OLModulationStream, OLPrimaryBasis, OLFlicker
+
+% History:
+%    10/18/26      Wrote it.
+
+%% Input validation, initialization
+parser = inputParser();
+parser.addRequired('directions',@(x) isa(x,'OLDirection'));
+parser.addRequired('waveforms',@isnumeric);
+parser.addParameter('cacheSize',200,@isscalar);
+parser.parse(directions,waveforms,varargin{:});
+assert(size(waveforms,1) == numel(directions),'OneLightToolbox:OLApproachSupport:OLPrimaryWaveform:MismatchedSizes',...
+    'Number of directions does not match number of waveforms');
+if ~isscalar(directions)
+    assert(all(matchingCalibration(directions(1), directions(2:end))),'OneLightToolbox:OLApproachSupport:OLPrimaryWaveform:MismatchedCalibrations',...
+    'Directions do not share a calibration');
+end
+
+%% Basis primaries and waveforms, and the stream
+[primaryValues, basisWaveforms] = OLPrimaryBasis(directions, waveforms);
+stream = OLModulationStream(primaryValues, basisWaveforms, directions(1).calibration, ...
+    'cacheSize',parser.Results.cacheSize);
+
+end
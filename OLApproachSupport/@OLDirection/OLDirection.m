@@ -56,6 +56,8 @@ classdef (Abstract) OLDirection < handle & matlab.mixin.Heterogeneous
     methods (Sealed)
         primaryWaveform = OLPrimaryWaveform(directions, waveforms, varargin);
         modulation = OLAssembleModulation(directions, waveforms, varargin);
+        stream = OLAssembleModulationStream(directions, waveforms, varargin);
+        [primaryValues, waveforms] = OLPrimaryBasis(directions, waveforms);
         [excitations, SPDs] = ToReceptorExcitations(direction, receptors);
         [contrast, excitation, excitationDiff] = ToReceptorContrast(direction, receptors);
         
@@ -0,0 +1,54 @@
+function [primaryValues, waveforms] = OLPrimaryBasis(directions, waveforms)
+% Basis primaries and matching waveforms for OLDirections and waveforms
+%
+% Syntax:
+%   [primaryValues, basisWaveforms] = OLPrimaryBasis(OLDirection, waveforms)
+%
+% Description:
+%    Split each waveform into its positive and negative parts, and pair
+%    each part with the corresponding differential primaries of its
+%    direction, so that the primary waveform is
+%    primaryValues * basisWaveforms.  This is the first step of
+%    OLPrimaryWaveform, without forming the product.
+%
+% Inputs:
+%    directions      - OLDirection objects.
+%    waveforms       - Nxt matrix of scalars for each of the N directions
+%                      at each timepoint t.
+%
+% Outputs:
+%    primaryValues   - Px2N matrix of basis primaries.  Columns 1:N are
+%                      for the positive parts of the waveforms, and
+%                      N+1:2N for the negative parts.
+%    waveforms       - 2Nxt matrix of the (non-negative) positive and
+%                      negative parts of the waveforms.
+%
+% Optional key/value pairs:
+%    None.
+%
+% See also:
+%    OLPrimaryWaveform, OLAssembleModulationStream
+
+% History:
+%    01/29/18  jv  wrote it, as part of OLPrimaryWaveform.
+%    10/18/26      extracted from OLPrimaryWaveform.
+
+%% Split waveforms into positive and negative components
+waveformsPos = (waveforms >= 0) .* waveforms;
+waveformsNeg = (waveforms < 0) .* -waveforms;
+waveforms = [waveformsPos; waveformsNeg];
+
+%% Assemble primary values matrix
+% initialize empty primary values matrix
+primaryValues = zeros([directions(1).calibration.describe.numWavelengthBands, numel(directions)*2]);
+for i = 1:numel(directions)
+    if isa(directions(i),'OLDirection_unipolar')
+        primaryValues(:,i) = any(waveformsPos(i,:)) * directions(i).differentialPrimaryValues;
+        primaryValues(:,numel(directions)+i) = any(waveformsNeg(i,:)) * -directions(i).differentialPrimaryValues;
+    else
+        primaryValues(:,i) = directions(i).differentialPositive;
+        primaryValues(:,numel(directions)+i) = directions(i).differentialNegative;
+    end
+end
+
+end
@@ -35,6 +35,7 @@ function primaryWaveform = OLPrimaryWaveform(directions, waveforms, varargin)
 % History:
 %    01/29/18  jv  wrote it.
 %    03/09/18  jv  overloaded for OLDirection objects
+%    10/18/26      basis assembly moved to OLPrimaryBasis.
 
 %% Input validation
 parser = inputParser();
@@ -49,23 +50,8 @@ if ~isscalar(directions)
     'Directions do not share a calibration');
 end
 
-%% Split waveforms into positive and negative components
-waveformsPos = (waveforms >= 0) .* waveforms;
-waveformsNeg = (waveforms < 0) .* -waveforms;
-waveforms = [waveformsPos; waveformsNeg];
-
-%% Assemble primary values matrix
-% initialize empty primary values matrix
-primaryValues = zeros([directions(1).calibration.describe.numWavelengthBands, numel(directions)*2]);
-for i = 1:numel(directions)
-    if isa(directions(i),'OLDirection_unipolar')
-        primaryValues(:,i) = any(waveformsPos(i,:)) * directions(i).differentialPrimaryValues;
-        primaryValues(:,numel(directions)+i) = any(waveformsNeg(i,:)) * -directions(i).differentialPrimaryValues;
-    else
-        primaryValues(:,i) = directions(i).differentialPositive;
-        primaryValues(:,numel(directions)+i) = directions(i).differentialNegative;
-    end
-end
+%% Assemble primary values matrix, and matching waveforms
+[primaryValues, waveforms] = OLPrimaryBasis(directions, waveforms);
 
 %% Construct primary waveform
 primaryWaveform = OLPrimaryWaveform(primaryValues, waveforms);
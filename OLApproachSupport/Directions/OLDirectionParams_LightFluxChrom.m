@@ -147,10 +147,10 @@ classdef OLDirectionParams_LightFluxChrom < OLDirectionParams
                         backgroundPrimary = background.differentialPrimaryValues;
                         targetSpdPos = OLPrimaryToSpd(calibration,backgroundPrimary)*(1 + directionParams.desiredMaxContrast);
                         targetSpdNeg = OLPrimaryToSpd(calibration,backgroundPrimary)*(1 - directionParams.desiredMaxContrast);
-                        modulationPrimaryPos = OLSpdToPrimary(calibration,targetSpdPos, ...
-                            'lambda',directionParams.search.lambda,'primaryHeadroom',directionParams.search.primaryHeadroom);
-                        modulationPrimaryNeg = OLSpdToPrimary(calibration,targetSpdNeg, ...
+                        modulationPrimaries = OLSpdToPrimaryBatch(calibration,[targetSpdPos targetSpdNeg], ...
                             'lambda',directionParams.search.lambda,'primaryHeadroom',directionParams.search.primaryHeadroom);
+                        modulationPrimaryPos = modulationPrimaries(:,1);
+                        modulationPrimaryNeg = modulationPrimaries(:,2);
                     end
                               
                     % Update background
@@ -185,7 +185,7 @@ classdef OLDirectionParams_LightFluxChrom < OLDirectionParams
             %    that maximize contrast at a desired chromaticity and that
             %    represent a light flux modulation.  We can then find
             %    primaries for a background spd in between these, which is
-            %    done using OLSpdToPrimary. This results in the returned
+            %    done using OLSpdToPrimaryBatch. This results in the returned
             %    backgroundPrimary.
             %
             %    We also return the primary values (minBackgroundPrimary and
@@ -215,7 +215,7 @@ classdef OLDirectionParams_LightFluxChrom < OLDirectionParams
             % Optional key/value pairs:
             %    None.
             %
-            % See also: OLPrimaryInvSolveChrom, OLSpdToPrimary.
+            % See also: OLPrimaryInvSolveChrom, OLSpdToPrimaryBatch.
             
             % Input validation
             parser = inputParser();
@@ -286,17 +286,19 @@ classdef OLDirectionParams_LightFluxChrom < OLDirectionParams
                     % should have guaranteed that both min and max spds are
                     % in gamut.  But, this has been a bit fussy in the
                     % past.
-                    [backgroundPrimary,predBackgroundSpd,fractionalErrorBg] = OLSpdToPrimary(calibration,targetBackgroundSpd, ...
-                        'primaryHeadroom',params.search.primaryHeadroom,'primaryTolerance',params.search.primaryTolerance, ...
-                        'lambda',params.search.lambda, 'checkSpd',false, ...
-                        'spdToleranceFraction',params.search.spdToleranceFraction, ...
-                        'verbose',params.search.verbose);
-
-                    [modulationPrimaryPos,predModulationSpdPos,fractionalErrorPos] = OLSpdToPrimary(calibration,targetModulationSpdPos, ...
-                        'primaryHeadroom',params.search.primaryHeadroom,'primaryTolerance',params.search.primaryTolerance, ...
-                        'lambda',params.search.lambda, 'checkSpd',false, ...
-                        'spdToleranceFraction',params.search.spdToleranceFraction, ...
-                        'verbose',params.search.verbose);
+                    %
+                    % All the targets share the calibration, so they are
+                    % solved in one batch.  The batch solver never leaves
+                    % the gamut, so there is no tolerance to truncate to.
+                    [primaries,predSpds,fractionalErrors] = OLSpdToPrimaryBatch(calibration,[targetBackgroundSpd targetModulationSpdPos], ...
+                        'primaryHeadroom',params.search.primaryHeadroom, ...
+                        'lambda',params.search.lambda,'verbose',params.search.verbose);
+                    backgroundPrimary = primaries(:,1);
+                    predBackgroundSpd = predSpds(:,1);
+                    fractionalErrorBg = fractionalErrors(1);
+                    modulationPrimaryPos = primaries(:,2);
+                    predModulationSpdPos = predSpds(:,2);
+                    fractionalErrorPos = fractionalErrors(2);
                     
                     modulationPrimaryNeg = [];
                     
@@ -353,23 +355,22 @@ classdef OLDirectionParams_LightFluxChrom < OLDirectionParams
                     % should have guaranteed that both min and max spds are
                     % in gamut.  But, this has been a bit fussy in the
                     % past.
-                    [backgroundPrimary,predBackgroundSpd,fractionalErrorBg] = OLSpdToPrimary(calibration,targetBackgroundSpd, ...
-                        'primaryHeadroom',params.search.primaryHeadroom,'primaryTolerance',params.search.primaryTolerance, ...
-                        'lambda',params.search.lambda, 'checkSpd',false, ...
-                        'spdToleranceFraction',params.search.spdToleranceFraction, ...
-                        'verbose',params.search.verbose);
-
-                    [modulationPrimaryPos,predModulationSpdPos,fractionalErrorPos] = OLSpdToPrimary(calibration,targetModulationSpdPos, ...
-                        'primaryHeadroom',params.search.primaryHeadroom,'primaryTolerance',params.search.primaryTolerance, ...
-                        'lambda',params.search.lambda, 'checkSpd',false, ...
-                        'spdToleranceFraction',params.search.spdToleranceFraction, ...
-                        'verbose',params.search.verbose);
-                    
-                    [modulationPrimaryNeg,predModulationSpdNeg,fractionalErrorNeg] = OLSpdToPrimary(calibration,targetModulationSpdNeg, ...
-                        'primaryHeadroom',params.search.primaryHeadroom,'primaryTolerance',params.search.primaryTolerance, ...
-                        'lambda',params.search.lambda, 'checkSpd',false, ...
-                        'spdToleranceFraction',params.search.spdToleranceFraction, ...
-                        'verbose',params.search.verbose);
+                    %
+                    % All the targets share the calibration, so they are
+                    % solved in one batch.  The batch solver never leaves
+                    % the gamut, so there is no tolerance to truncate to.
+                    [primaries,predSpds,fractionalErrors] = OLSpdToPrimaryBatch(calibration,[targetBackgroundSpd targetModulationSpdPos targetModulationSpdNeg], ...
+                        'primaryHeadroom',params.search.primaryHeadroom, ...
+                        'lambda',params.search.lambda,'verbose',params.search.verbose);
+                    backgroundPrimary = primaries(:,1);
+                    predBackgroundSpd = predSpds(:,1);
+                    fractionalErrorBg = fractionalErrors(1);
+                    modulationPrimaryPos = primaries(:,2);
+                    predModulationSpdPos = predSpds(:,2);
+                    fractionalErrorPos = fractionalErrors(2);
+                    modulationPrimaryNeg = primaries(:,3);
+                    predModulationSpdNeg = predSpds(:,3);
+                    fractionalErrorNeg = fractionalErrors(3);
                     
                 otherwise
                     error('Unknown background polarType property provided');
@@ -3,7 +3,17 @@
 % 
 % For example usage, see OLPrintTemperature.m
 %
+% If a LJTemperatureLogger is running (see src/LJTemperatureLogger), it has
+% the device open, and open() reads its samples from shared memory instead
+% (deviceID 'Feed').  Any number of MATLAB sessions can do this at once, and
+% close() then leaves the device alone.  Pass 'useFeed', false to always
+% open the device.  measure() returns status -1 when the logger has
+% stopped, or its latest sample is older than maxFeedAge logger periods.
+%
 % 12/21/16  npc    Wrote it.
+% 10/18/26         Read from a running LJTemperatureLogger when there is one.
+% 10/18/26         Trace measure() with OLTrace.
+% 10/18/26         Do not return stale samples of a stopped logger.
 
 classdef LJTemperatureProbe < handle
     
@@ -19,7 +29,11 @@ classdef LJTemperatureProbe < handle
     
     % Private properties
     properties (Access = private)
-        somePrivateProp
+        useFeed = true;
+        feedName = '/LJTemperatureFeed';
+        
+        % Oldest logger sample measure() returns, in logger periods
+        maxFeedAge = 5;
     end
     
     % Public methods
@@ -29,13 +43,27 @@ classdef LJTemperatureProbe < handle
             % Parse optional arguments
             parser = inputParser;
             parser.addParameter('verbosity', 0, @isnumeric);
+            parser.addParameter('useFeed', true, @islogical);
+            parser.addParameter('feedName', '/LJTemperatureFeed', @ischar);
             %Execute the parser
             parser.parse(varargin{:});
             obj.verbosity = parser.Results.verbosity;
+            obj.useFeed = parser.Results.useFeed;
+            obj.feedName = parser.Results.feedName;
         end
         
         % Method to open a LabJackDevice
         function status = open(obj) 
+            % Use a running logger's samples if there is one
+            if (obj.useFeed && exist('LJTemperatureFeedMex', 'file') == 3)
+                [found, ~, running] = LJTemperatureFeedMex('latest', obj.feedName);
+                if (found && running)
+                    obj.deviceID = 'Feed';
+                    status = 1;
+                    return;
+                end
+            end
+            
             % First see if there is a UE9 connected
             isUE9 = LJTemperatureProbeUE9('identify');
             if (isUE9 == 1)
@@ -58,7 +86,11 @@ classdef LJTemperatureProbe < handle
         
         % Method to close a LabJackDevice
         function status = close(obj) 
-            if strcmp(obj.deviceID, 'UE9')
+            if strcmp(obj.deviceID, 'Feed')
+                % The logger owns the device
+                status = 1;
+                return;
+            elseif strcmp(obj.deviceID, 'UE9')
                 status = LJTemperatureProbeUE9('close');
             elseif strcmp(obj.deviceID, 'U3')
                 status = LJTemperatureProbeU3('close');
@@ -72,7 +104,24 @@ classdef LJTemperatureProbe < handle
         
         % Method to measure the temperature (single point)
         function [status, temperature] = measure(obj)
-            if strcmp(obj.deviceID, 'UE9')
+            span = OLTraceSpan('LJTemperatureProbe:measure'); %#ok<NASGU>
+            if strcmp(obj.deviceID, 'Feed')
+                % Latest sample from the logger, if it is still sampling
+                [~, sample, running, sampleRate] = LJTemperatureFeedMex('latest', obj.feedName);
+                if (~isempty(sample))
+                    % Sample times are seconds since 1970-01-01 UTC.  Allow
+                    % a second for the two clocks and the scheduling.
+                    sampleAge = posixtime(datetime('now', 'TimeZone', 'UTC')) - sample(2);
+                    isStale = (sampleAge > obj.maxFeedAge/sampleRate + 1);
+                end
+                if (isempty(sample) || ~running || isStale)
+                    status = -1;
+                    temperature = [NaN NaN];
+                else
+                    status = sample(5);
+                    temperature = sample(3:4);
+                end
+            elseif strcmp(obj.deviceID, 'UE9')
                 [status, temperature] = LJTemperatureProbeUE9('measure');
             elseif strcmp(obj.deviceID, 'U3')
                 [status, temperature] = LJTemperatureProbeU3('measure');
@@ -83,6 +132,19 @@ classdef LJTemperatureProbe < handle
                 fprintf('Could not read from LJdevice\n');
             end
         end
+        
+        % Method to get the logger's samples after a given sample number, as
+        % rows [sampleNumber time probe internal status] with time in
+        % seconds since 1970-01-01 UTC.  Only when reading from a logger.
+        function samples = history(obj, sinceSampleNumber)
+            if ~strcmp(obj.deviceID, 'Feed')
+                error('History is only available from a running LJTemperatureLogger');
+            end
+            if (nargin < 2)
+                sinceSampleNumber = 0;
+            end
+            [~, samples] = LJTemperatureFeedMex('since', sinceSampleNumber, obj.feedName);
+        end
     end  % Public methods
     
     methods (Access = private)
@@ -0,0 +1,36 @@
+% [temperature, time, status, running] = LJTemperatureLoggerLatest(sharedName)
+%
+% Latest sample of a running LJTemperatureLogger (see
+% src/LJTemperatureLogger), read from the shared memory in which it
+% publishes its samples by LJTemperatureFeedMex.  This does not touch the
+% LabJack, which the logger has open, takes microseconds, and works from
+% any number of MATLAB sessions at once.
+%
+% temperature is [probe internal] in Celsius, NaN if the read failed, and
+% time is in seconds since 1970-01-01 UTC, so that
+%   datetime(time, 'ConvertFrom', 'posixtime', 'TimeZone', 'local')
+% gives the time of the sample.  status is 0 for a good read and running
+% is false once the logger has stopped.  sharedName defaults to the
+% logger's default, /LJTemperatureFeed.
+%
+% 10/18/26         Wrote it.
+function [temperature, time, status, running] = LJTemperatureLoggerLatest(sharedName)
+
+    if (nargin < 1 || isempty(sharedName))
+        sharedName = '/LJTemperatureFeed';
+    end
+
+    [found, sample, running] = LJTemperatureFeedMex('latest', sharedName);
+    if (~found)
+        error('LJTemperatureLoggerLatest:NoLogger', 'No logger shared memory %s. Is LJTemperatureLogger running?', sharedName);
+    end
+    if (isempty(sample))
+        temperature = [NaN NaN];
+        time = NaN;
+        status = -1;
+        return;
+    end
+    time = sample(2);
+    temperature = sample(3:4);
+    status = sample(5);
+end
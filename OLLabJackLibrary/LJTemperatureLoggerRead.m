@@ -0,0 +1,67 @@
+% temperatureLog = LJTemperatureLoggerRead(fileNames)
+%
+% Read the binary log files written by LJTemperatureLogger (see
+% src/LJTemperatureLogger).  fileNames is a file name or a cell array of
+% them, e.g. from dir(fullfile(logDir,'TemperatureLog_*.ljt')), and the
+% samples of all of them are returned in time order, in fields
+%   time         - seconds since 1970-01-01 UTC
+%   temperature  - nSamples x 2, [probe internal] in Celsius
+%   status       - 0 for a good read, -1 (and NaN temperatures) if not
+%   sampleRate   - samples per second, from the first file
+% An incomplete block at the end of a file, as left by a logger that was
+% killed while writing, is skipped.
+%
+% 10/18/26         Wrote it.
+function temperatureLog = LJTemperatureLoggerRead(fileNames)
+
+    if (ischar(fileNames))
+        fileNames = {fileNames};
+    end
+
+    samples = cell(1, numel(fileNames));
+    temperatureLog.sampleRate = NaN;
+    for fileIndex = 1:numel(fileNames)
+        fid = fopen(fileNames{fileIndex}, 'r', 'ieee-le');
+        if (fid < 0)
+            error('LJTemperatureLoggerRead:CannotOpen', 'Cannot open %s', fileNames{fileIndex});
+        end
+        bytes = fread(fid, Inf, '*uint8')';
+        fclose(fid);
+
+        fileSamples = {};
+        position = 0;
+        while (position + 8 <= numel(bytes))
+            tag = char(bytes(position+(1:4)));
+            if (strcmp(tag, 'LJTL'))
+                % File header.  It is repeated if the logger started
+                % another file with the same name.
+                if (position + 32 > numel(bytes))
+                    break;
+                end
+                if (isnan(temperatureLog.sampleRate))
+                    temperatureLog.sampleRate = typecast(bytes(position+(17:24)), 'double');
+                end
+                position = position + 32;
+            elseif (strcmp(tag, 'LJTB'))
+                nSamples = double(typecast(bytes(position+(5:8)), 'uint32'));
+                blockEnd = position + 8 + 32*nSamples;
+                if (blockEnd > numel(bytes))
+                    break;
+                end
+                fileSamples{end+1} = reshape(typecast(bytes(position+9:blockEnd), 'double'), 4, nSamples); %#ok<AGROW>
+                position = blockEnd;
+            else
+                warning('LJTemperatureLoggerRead:BadFile', 'Unexpected data in %s, reading stopped there', fileNames{fileIndex});
+                break;
+            end
+        end
+        samples{fileIndex} = [zeros(4,0) fileSamples{:}];
+    end
+
+    samples = [zeros(4,0) samples{:}];
+    [~, order] = sort(samples(1,:));
+    samples = samples(:,order);
+    temperatureLog.time = samples(1,:)';
+    temperatureLog.temperature = samples(2:3,:)';
+    temperatureLog.status = samples(4,:)';
+end
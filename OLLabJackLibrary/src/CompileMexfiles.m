@@ -4,15 +4,20 @@ function CompileMexfiles
     if (compileMexFile)
         [dirName, ~] = fileparts(which(mfilename()));
         cd(dirName);
-        % Compile the U3 mexfile
-        %mex -v -output LJTemperatureProbeU3 LDFLAGS="\$LDFLAGS -weak_library /usr/local/Cellar/exodriver/2.5.3/lib/liblabjackusb.dylib -weak_library /usr/local/Cellar/libusb/1.0.21/lib/libusb-1.0.dylib" CFLAGS="\$CFLAGS -Wall -g -std=c11 -Wno-nullability-completeness" -I/usr/include -I/usr/local/Cellar/exodriver/2.5.3/include -I/usr/local/Cellar/libusb/1.0.21/include/libusb-1.0 "U3.c"
+        % Compile the U3 mexfile (LJTrace.h needs OLTrace.h, from OLLibrary/src).
+        % The LJTemperatureProbeU3/UE9 binaries here predate LJTrace.h, so
+        % they have no 'traceEvents' command until they are rebuilt.
+        %mex -v -output LJTemperatureProbeU3 LDFLAGS="\$LDFLAGS -weak_library /usr/local/Cellar/exodriver/2.5.3/lib/liblabjackusb.dylib -weak_library /usr/local/Cellar/libusb/1.0.21/lib/libusb-1.0.dylib" CFLAGS="\$CFLAGS -Wall -g -std=c11 -Wno-nullability-completeness" -I/usr/include -I/usr/local/Cellar/exodriver/2.5.3/include -I/usr/local/Cellar/libusb/1.0.21/include/libusb-1.0 -I../../OLLibrary/src "U3.c"
         
         % Compile the UE9 mexfile
-        %mex -v -output LJTemperatureProbeUE9  LDFLAGS="\$LDFLAGS -weak_library /usr/local/Cellar/exodriver/2.5.3/lib/liblabjackusb.dylib -weak_library /usr/local/Cellar/libusb/1.0.21/lib/libusb-1.0.dylib" CFLAGS="\$CFLAGS -Wall -g -std=c11 -Wno-nullability-completeness" -I/usr/include -I/usr/local/Cellar/exodriver/2.5.3/include -I/usr/local/Cellar/libusb/1.0.21/include/libusb-1.0 "UE9.c"
+        %mex -v -output LJTemperatureProbeUE9  LDFLAGS="\$LDFLAGS -weak_library /usr/local/Cellar/exodriver/2.5.3/lib/liblabjackusb.dylib -weak_library /usr/local/Cellar/libusb/1.0.21/lib/libusb-1.0.dylib" CFLAGS="\$CFLAGS -Wall -g -std=c11 -Wno-nullability-completeness" -I/usr/include -I/usr/local/Cellar/exodriver/2.5.3/include -I/usr/local/Cellar/libusb/1.0.21/include/libusb-1.0 -I../../OLLibrary/src "UE9.c"
     
         % Compile the U3IR mexfile
         mex -v -output u3IR  LDFLAGS="\$LDFLAGS -weak_library /usr/local/Cellar/exodriver/2.5.3/lib/liblabjackusb.dylib -weak_library /usr/local/Cellar/libusb/1.0.21/lib/libusb-1.0.dylib" CFLAGS="\$CFLAGS -Wall -g -std=c11 -Wno-nullability-completeness" -I/usr/include -I/usr/local/Cellar/exodriver/2.5.3/include -I/usr/local/Cellar/libusb/1.0.21/include/libusb-1.0 "u3IR.c"
 
+        % The reader of the LJTemperatureLogger shared memory,
+        % LJTemperatureFeedMex, is compiled by OLCompileMexfiles.
+
         return;
     end
 
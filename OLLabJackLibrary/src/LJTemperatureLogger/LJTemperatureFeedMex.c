@@ -0,0 +1,286 @@
+// *** Filename: LJTemperatureFeedMex.c
+// *** Purpose: Read the samples that a running LJTemperatureLogger
+//          publishes in shared memory.  The reader never writes to the
+//          shared memory and takes no locks, so any number of MATLAB
+//          sessions can read at once, without opening the LabJack.
+//
+//          [status, sample, running, sampleRate] = LJTemperatureFeedMex('latest' [, sharedName])
+//          [status, samples, running] = LJTemperatureFeedMex('since', sampleNumber [, sharedName])
+//          LJTemperatureFeedMex('close')
+//
+//          Samples are rows [sampleNumber time probe internal status],
+//          with sampleNumber counting from 1 since the logger started,
+//          time in seconds since 1970-01-01 UTC and temperatures in
+//          Celsius.  'since' returns the samples numbered above
+//          sampleNumber that are still in the ring, oldest first.  status
+//          is 1 if there is a logger's shared memory to read, 0 if not.
+//          running is true while the logger is sampling, and sampleRate
+//          the logger's samples per second (NaN without a logger).
+//          sharedName defaults to /LJTemperatureFeed.
+//
+//          The shared memory stays mapped between calls.  It is mapped
+//          again when the name refers to a different object, so that a
+//          restarted logger is picked up even if the old one was killed
+//          without clearing its running flag.  running is also false
+//          when the logger's process is gone.
+// *** Date: 10-18-2026
+// *** 10-18-2026: Remap by the object's device and inode rather than the
+//          running flag, and check that the logger process is alive.
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/types.h>
+#include <unistd.h>
+#include "mex.h"
+#include "matrix.h"
+#include "LJTemperatureShared.h"
+
+#define NAME_LENGTH     256
+#define SAMPLE_COLUMNS  (3 + LJ_CHANNELS)
+#define MAX_RETRIES     1000
+
+static const LJTemperatureShared *shared = NULL;
+static size_t sharedBytes = 0;
+static char sharedName[NAME_LENGTH] = "";
+static dev_t sharedDevice = 0;
+static ino_t sharedInode = 0;
+
+static void unmapShared(void)
+{
+    if (shared != NULL) {
+        munmap((void *)shared, sharedBytes);
+        shared = NULL;
+        sharedBytes = 0;
+    }
+}
+
+/* Whether the named shared memory is the object we have mapped */
+static int isMappedObject(const char *name)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return 0;
+    }
+    struct stat info;
+    const int same = (fstat(fd, &info) == 0 &&
+        info.st_dev == sharedDevice && info.st_ino == sharedInode);
+    close(fd);
+    return same;
+}
+
+/* Whether the logger that wrote the mapped memory is still sampling.  A
+   killed logger never clears its running flag, so look for its process. */
+static int loggerRunning(void)
+{
+    if (shared == NULL || !__atomic_load_n(&shared->running, __ATOMIC_ACQUIRE)) {
+        return 0;
+    }
+    return !(kill((pid_t)shared->pid, 0) != 0 && errno == ESRCH);
+}
+
+/* Map the named shared memory read only.  Returns NULL if there is none,
+   or if it is not (yet) a complete LJTemperatureLogger header. */
+static const LJTemperatureShared *mapShared(const char *name, size_t *bytes,
+                                            dev_t *device, ino_t *inode)
+{
+    int fd = shm_open(name, O_RDONLY, 0);
+    if (fd < 0) {
+        return NULL;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t)info.st_size < ljSharedBytes(1)) {
+        close(fd);
+        return NULL;
+    }
+    void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (map == MAP_FAILED) {
+        return NULL;
+    }
+    const LJTemperatureShared *candidate = (const LJTemperatureShared *)map;
+    if (memcmp(candidate->magic, LJ_SHARED_MAGIC, 4) != 0 ||
+        candidate->version != LJ_SHARED_VERSION ||
+        candidate->nChannels != LJ_CHANNELS ||
+        ljSharedBytes(candidate->capacity) > (size_t)info.st_size) {
+        munmap(map, (size_t)info.st_size);
+        return NULL;
+    }
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+    *bytes = (size_t)info.st_size;
+    *device = info.st_dev;
+    *inode = info.st_ino;
+    return candidate;
+}
+
+/* Make sure we have the current logger's shared memory mapped, if there
+   is one.  A stopped logger's memory is kept if no other is found. */
+static void updateMapping(const char *name)
+{
+    if (shared != NULL && strcmp(name, sharedName) == 0 && isMappedObject(name)) {
+        return;
+    }
+    size_t bytes = 0;
+    dev_t device = 0;
+    ino_t inode = 0;
+    const LJTemperatureShared *candidate = mapShared(name, &bytes, &device, &inode);
+    if (candidate != NULL) {
+        unmapShared();
+        shared = candidate;
+        sharedBytes = bytes;
+        sharedDevice = device;
+        sharedInode = inode;
+        snprintf(sharedName, sizeof(sharedName), "%s", name);
+    } else if (strcmp(name, sharedName) != 0) {
+        unmapShared();
+    }
+}
+
+/* Copy sample n (from 0) into row of out (column major, nRows rows).
+   Returns 0 if it was overwritten, or is being written. */
+static int readSample(uint64_t n, double *out, size_t row, size_t nRows)
+{
+    const LJTemperatureSlot *slot = &shared->slots[n % shared->capacity];
+    for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+        const uint64_t before = __atomic_load_n(&slot->sequence, __ATOMIC_ACQUIRE);
+        if (before != 2*n + 2) {
+            if (before > 2*n + 2 || before < 2*n) {
+                return 0;     /* overwritten by a newer sample, or never written */
+            }
+            continue;         /* being written right now */
+        }
+        double copy[SAMPLE_COLUMNS - 1];
+        copy[0] = slot->time;
+        for (int c = 0; c < LJ_CHANNELS; c++) {
+            copy[1 + c] = slot->value[c];
+        }
+        copy[1 + LJ_CHANNELS] = slot->status;
+        __atomic_thread_fence(__ATOMIC_ACQUIRE);
+        if (__atomic_load_n(&slot->sequence, __ATOMIC_RELAXED) != before) {
+            return 0;         /* overwritten while we copied it */
+        }
+        out[row] = (double)(n + 1);
+        for (int k = 0; k < SAMPLE_COLUMNS - 1; k++) {
+            out[row + (size_t)(k + 1) * nRows] = copy[k];
+        }
+        return 1;
+    }
+    return 0;
+}
+
+/* The latest sample as a 1 x SAMPLE_COLUMNS matrix, or 0 x SAMPLE_COLUMNS
+   if there is none.  If it is overwritten while we read it, which takes a
+   whole lap of the ring, the new latest one is read. */
+static mxArray *latestSample(void)
+{
+    double row[SAMPLE_COLUMNS];
+    for (int attempt = 0; attempt < MAX_RETRIES; attempt++) {
+        const uint64_t count = __atomic_load_n(&shared->count, __ATOMIC_ACQUIRE);
+        if (count == 0) {
+            break;
+        }
+        if (readSample(count - 1, row, 0, 1)) {
+            mxArray *sample = mxCreateDoubleMatrix(1, SAMPLE_COLUMNS, mxREAL);
+            memcpy(mxGetPr(sample), row, sizeof(row));
+            return sample;
+        }
+    }
+    return mxCreateDoubleMatrix(0, SAMPLE_COLUMNS, mxREAL);
+}
+
+/* The samples numbered above since that are still in the ring, one per
+   row, oldest first */
+static mxArray *samplesSince(double since)
+{
+    const uint64_t count = __atomic_load_n(&shared->count, __ATOMIC_ACQUIRE);
+    const uint64_t oldest = (count > shared->capacity) ? count - shared->capacity : 0;
+    uint64_t first = (since > 0) ? (uint64_t)since : 0;
+    if (first < oldest) {
+        first = oldest;
+    }
+    const size_t nWanted = (count > first) ? (size_t)(count - first) : 0;
+
+    /* Read into a buffer first, since some may be overwritten as we go */
+    double *buffer = mxMalloc((nWanted > 0 ? nWanted : 1) * SAMPLE_COLUMNS * sizeof(double));
+    size_t nGood = 0;
+    for (uint64_t n = first; n < count; n++) {
+        if (readSample(n, buffer, nGood, nWanted)) {
+            nGood++;
+        }
+    }
+    mxArray *samples = mxCreateDoubleMatrix(nGood, SAMPLE_COLUMNS, mxREAL);
+    double *out = mxGetPr(samples);
+    for (int k = 0; k < SAMPLE_COLUMNS; k++) {
+        memcpy(out + (size_t)k * nGood, buffer + (size_t)k * nWanted, nGood * sizeof(double));
+    }
+    mxFree(buffer);
+    return samples;
+}
+
+/* Getaway function */
+void mexFunction(int nlhs,      /* number of output (return) arguments */
+      mxArray *plhs[],          /* pointer to an array which will hold the output data, each element is of type: mxArray */
+      int nrhs,                 /* number of input arguments */
+      const mxArray *prhs[]     /* pointer to an array which holds the input data, each element is of type: const mxArray */
+      )
+{
+    mexAtExit(unmapShared);
+
+    char operandName[32];
+    if (nrhs < 1 || mxIsChar(prhs[0]) != 1) {
+        mexErrMsgTxt("LJTemperatureFeedMex: First argument must be 'latest', 'since' or 'close'.");
+    }
+    mxGetString(prhs[0], operandName, sizeof(operandName));
+
+    if (strcmp(operandName, "close") == 0) {
+        unmapShared();
+        sharedName[0] = '\0';
+        return;
+    }
+
+    const int isSince = (strcmp(operandName, "since") == 0);
+    if (!isSince && strcmp(operandName, "latest") != 0) {
+        mexErrMsgTxt("LJTemperatureFeedMex: First argument must be 'latest', 'since' or 'close'.");
+    }
+    const int nameArgument = isSince ? 2 : 1;
+    if (isSince && (nrhs < 2 || !mxIsNumeric(prhs[1]) || mxGetNumberOfElements(prhs[1]) != 1)) {
+        mexErrMsgTxt("LJTemperatureFeedMex: 'since' needs a sample number.");
+    }
+    char name[NAME_LENGTH] = LJ_SHARED_NAME;
+    if (nrhs > nameArgument) {
+        if (mxIsChar(prhs[nameArgument]) != 1) {
+            mexErrMsgTxt("LJTemperatureFeedMex: Shared memory name must be a string.");
+        }
+        mxGetString(prhs[nameArgument], name, sizeof(name));
+    }
+
+    updateMapping(name);
+    const int running = loggerRunning();
+    mxArray *samples;
+    if (shared == NULL) {
+        samples = mxCreateDoubleMatrix(0, SAMPLE_COLUMNS, mxREAL);
+    } else if (isSince) {
+        samples = samplesSince(mxGetScalar(prhs[1]));
+    } else {
+        samples = latestSample();
+    }
+
+    plhs[0] = mxCreateDoubleScalar(shared != NULL);
+    if (nlhs > 1) {
+        plhs[1] = samples;
+    } else {
+        mxDestroyArray(samples);
+    }
+    if (nlhs > 2) {
+        plhs[2] = mxCreateLogicalScalar(running);
+    }
+    if (nlhs > 3) {
+        plhs[3] = mxCreateDoubleScalar((shared != NULL) ? shared->sampleRate : mxGetNaN());
+    }
+}
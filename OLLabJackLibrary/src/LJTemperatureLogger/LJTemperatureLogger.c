@@ -0,0 +1,338 @@
+// *** Filename: LJTemperatureLogger.c
+// *** Purpose: Standalone temperature logger for the U3 LabJack with the
+//          EI-1034 probe.  Samples at a fixed rate, writes the samples to
+//          binary log files in blocks, starting a new file when the
+//          current one gets too big or too old, and publishes the samples
+//          in a POSIX shared memory ring (see LJTemperatureShared.h) that
+//          any number of MATLAB sessions can read with
+//          LJTemperatureFeedMex.
+//
+//          Usage:
+//            LJTemperatureLogger -d logDir [-p prefix] [-r rateHz]
+//                [-b blockSeconds] [-S maxFileMB] [-T maxFileMinutes]
+//                [-m sharedName] [-n ringSamples] [-v]
+//
+//          Defaults: prefix TemperatureLog, 10 Hz, 1 s blocks, 64 MB and
+//          60 minute files, shared memory /LJTemperatureFeed holding the
+//          last 36000 samples.  Stop it with Ctrl-C or kill; the current
+//          block is written first.  The shared memory is left in place,
+//          marked as not running, so the last samples can still be read.
+//
+//          Log file format (little endian, see LJTemperatureLoggerRead.m):
+//            header: char[4] "LJTL", uint32 version, uint32 nChannels,
+//                    uint32 0, double sampleRate, double startTime
+//            blocks: char[4] "LJTB", uint32 nSamples, then nSamples rows
+//                    of double [time probe internal status]
+//          Times are seconds since 1970-01-01 UTC, temperatures are in
+//          Celsius and NaN when a read failed (status -1).
+//
+//          The device code is U3.c, compiled with -DLJ_NO_MEX.  Build with
+//          the Makefile in this folder.
+// *** Date: 10-18-2026
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <errno.h>
+#include <fcntl.h>
+#include <math.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#include "LJTemperatureShared.h"
+
+/* From U3.c */
+int openUE3device();
+int closeUE3device();
+double readTemperature(double *tempData);
+
+#define MAX_BLOCK_SAMPLES   4096
+#define PATH_LENGTH         1024
+
+typedef struct {
+    const char *logDir;
+    const char *prefix;
+    const char *sharedName;
+    double ringSamples;
+    double sampleRate;
+    double blockSeconds;
+    double maxFileBytes;
+    double maxFileSeconds;
+    int verbose;
+} LoggerOptions;
+
+typedef struct {
+    FILE *fid;
+    double bytes;
+    double startTime;
+} LogFile;
+
+static volatile sig_atomic_t keepRunning = 1;
+
+static void stopLogging(int signalNumber)
+{
+    (void)signalNumber;
+    keepRunning = 0;
+}
+
+static double wallClockSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_REALTIME, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+static double monotonicSeconds(void)
+{
+    struct timespec t;
+    clock_gettime(CLOCK_MONOTONIC, &t);
+    return (double)t.tv_sec + 1e-9 * (double)t.tv_nsec;
+}
+
+static void sleepSeconds(double seconds)
+{
+    if (seconds <= 0) {
+        return;
+    }
+    struct timespec t;
+    t.tv_sec = (time_t)seconds;
+    t.tv_nsec = (long)((seconds - (double)t.tv_sec) * 1e9);
+    while (nanosleep(&t, &t) != 0 && errno == EINTR && keepRunning) {
+    }
+}
+
+//
+// Log files
+//
+static int openLogFile(LogFile *log, const LoggerOptions *options, double now)
+{
+    char fileName[PATH_LENGTH];
+    char stamp[32];
+    time_t seconds = (time_t)now;
+    struct tm local;
+    localtime_r(&seconds, &local);
+    strftime(stamp, sizeof(stamp), "%Y-%m-%d-%H-%M-%S", &local);
+    snprintf(fileName, sizeof(fileName), "%s/%s_%s.ljt", options->logDir, options->prefix, stamp);
+
+    log->fid = fopen(fileName, "ab");
+    if (log->fid == NULL) {
+        fprintf(stderr, "LJTemperatureLogger: cannot open %s: %s\n", fileName, strerror(errno));
+        return 0;
+    }
+    const uint32_t header[3] = {1, LJ_CHANNELS, 0};
+    const double headerTimes[2] = {options->sampleRate, now};
+    fwrite("LJTL", 1, 4, log->fid);
+    fwrite(header, sizeof(uint32_t), 3, log->fid);
+    fwrite(headerTimes, sizeof(double), 2, log->fid);
+    fflush(log->fid);
+    log->bytes = 32;
+    log->startTime = now;
+    if (options->verbose) {
+        printf("LJTemperatureLogger: logging to %s\n", fileName);
+    }
+    return 1;
+}
+
+static void closeLogFile(LogFile *log)
+{
+    if (log->fid != NULL) {
+        fclose(log->fid);
+        log->fid = NULL;
+    }
+}
+
+static int writeBlock(LogFile *log, const double *samples, uint32_t nSamples)
+{
+    if (nSamples == 0) {
+        return 1;
+    }
+    fwrite("LJTB", 1, 4, log->fid);
+    fwrite(&nSamples, sizeof(uint32_t), 1, log->fid);
+    size_t written = fwrite(samples, sizeof(double), 4 * (size_t)nSamples, log->fid);
+    if (fflush(log->fid) != 0 || written != 4 * (size_t)nSamples) {
+        fprintf(stderr, "LJTemperatureLogger: write failed: %s\n", strerror(errno));
+        return 0;
+    }
+    log->bytes += 8 + 32 * (double)nSamples;
+    return 1;
+}
+
+//
+// Shared memory
+//
+static LJTemperatureShared *openShared(const char *name, uint64_t capacity, double sampleRate)
+{
+    /* Start from a new object.  Readers still mapping one from an earlier
+       run see it marked as not running, and map this one instead. */
+    shm_unlink(name);
+    int fd = shm_open(name, O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        fprintf(stderr, "LJTemperatureLogger: cannot create shared memory %s: %s\n", name, strerror(errno));
+        return NULL;
+    }
+    const size_t bytes = ljSharedBytes(capacity);
+    if (ftruncate(fd, (off_t)bytes) != 0) {
+        fprintf(stderr, "LJTemperatureLogger: cannot size shared memory %s: %s\n", name, strerror(errno));
+        close(fd);
+        shm_unlink(name);
+        return NULL;
+    }
+    LJTemperatureShared *shared = mmap(NULL, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (shared == MAP_FAILED) {
+        fprintf(stderr, "LJTemperatureLogger: cannot map shared memory %s: %s\n", name, strerror(errno));
+        shm_unlink(name);
+        return NULL;
+    }
+    memset(shared, 0, bytes);
+    shared->version = LJ_SHARED_VERSION;
+    shared->nChannels = LJ_CHANNELS;
+    shared->pid = (uint32_t)getpid();
+    shared->sampleRate = sampleRate;
+    shared->capacity = capacity;
+    shared->running = 1;
+    /* The magic goes in last, so a reader never sees a half made header */
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    memcpy(shared->magic, LJ_SHARED_MAGIC, 4);
+    return shared;
+}
+
+static void publishSample(LJTemperatureShared *shared, const double *sample)
+{
+    const uint64_t n = shared->count;
+    LJTemperatureSlot *slot = &shared->slots[n % shared->capacity];
+    __atomic_store_n(&slot->sequence, 2*n + 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+    slot->time = sample[0];
+    for (int c = 0; c < LJ_CHANNELS; c++) {
+        slot->value[c] = sample[1 + c];
+    }
+    slot->status = sample[3];
+    __atomic_store_n(&slot->sequence, 2*n + 2, __ATOMIC_RELEASE);
+    __atomic_store_n(&shared->count, n + 1, __ATOMIC_RELEASE);
+}
+
+static void usage(void)
+{
+    fprintf(stderr,
+        "Usage: LJTemperatureLogger -d logDir [-p prefix] [-r rateHz] [-b blockSeconds]\n"
+        "           [-S maxFileMB] [-T maxFileMinutes] [-m sharedName] [-n ringSamples] [-v]\n");
+}
+
+int main(int argc, char *argv[])
+{
+    LoggerOptions options = {NULL, "TemperatureLog", LJ_SHARED_NAME, 36000, 10.0, 1.0, 64e6, 3600.0, 0};
+    int option;
+    while ((option = getopt(argc, argv, "d:p:r:b:S:T:m:n:v")) != -1) {
+        switch (option) {
+            case 'd': options.logDir = optarg; break;
+            case 'p': options.prefix = optarg; break;
+            case 'r': options.sampleRate = atof(optarg); break;
+            case 'b': options.blockSeconds = atof(optarg); break;
+            case 'S': options.maxFileBytes = 1e6 * atof(optarg); break;
+            case 'T': options.maxFileSeconds = 60 * atof(optarg); break;
+            case 'm': options.sharedName = optarg; break;
+            case 'n': options.ringSamples = atof(optarg); break;
+            case 'v': options.verbose = 1; break;
+            default: usage(); return 1;
+        }
+    }
+    if (options.logDir == NULL || !(options.sampleRate > 0) || !(options.blockSeconds > 0) || !(options.ringSamples >= 1)) {
+        usage();
+        return 1;
+    }
+
+    /* Samples per block, at least one */
+    uint32_t blockSamples = (uint32_t)ceil(options.blockSeconds * options.sampleRate);
+    if (blockSamples < 1) {
+        blockSamples = 1;
+    }
+    if (blockSamples > MAX_BLOCK_SAMPLES) {
+        blockSamples = MAX_BLOCK_SAMPLES;
+    }
+
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = stopLogging;
+    sigaction(SIGINT, &action, NULL);
+    sigaction(SIGTERM, &action, NULL);
+
+    if (openUE3device() != 1) {
+        fprintf(stderr, "LJTemperatureLogger: could not open the U3 device. Is it connected?\n");
+        return 1;
+    }
+    LJTemperatureShared *shared = openShared(options.sharedName, (uint64_t)options.ringSamples, options.sampleRate);
+    if (shared == NULL) {
+        closeUE3device();
+        return 1;
+    }
+    LogFile log = {NULL, 0, 0};
+    if (!openLogFile(&log, &options, wallClockSeconds())) {
+        closeUE3device();
+        return 1;
+    }
+
+    /* Sample on a fixed schedule, so that time spent reading and writing
+       does not add up to drift */
+    static double block[4 * MAX_BLOCK_SAMPLES];
+    uint32_t nInBlock = 0;
+    const double period = 1.0 / options.sampleRate;
+    const double scheduleStart = monotonicSeconds();
+    uint64_t sampleIndex = 0;
+    int ok = 1;
+    while (keepRunning && ok) {
+        double *sample = block + 4 * nInBlock;
+        double temperature[LJ_CHANNELS];
+        sample[0] = wallClockSeconds();
+        if (readTemperature(temperature) == 0) {
+            sample[1] = temperature[0];
+            sample[2] = temperature[1];
+            sample[3] = 0;
+        } else {
+            sample[1] = NAN;
+            sample[2] = NAN;
+            sample[3] = -1;
+        }
+        publishSample(shared, sample);
+        nInBlock++;
+
+        if (nInBlock == blockSamples) {
+            ok = writeBlock(&log, block, nInBlock);
+            if (options.verbose) {
+                printf("LJTemperatureLogger: %.2f %.2f C\n", sample[1], sample[2]);
+            }
+            nInBlock = 0;
+
+            /* Start a new file when this one is full or old enough */
+            if (ok && (log.bytes >= options.maxFileBytes || sample[0] - log.startTime >= options.maxFileSeconds)) {
+                closeLogFile(&log);
+                ok = openLogFile(&log, &options, wallClockSeconds());
+            }
+        }
+
+        /* Wait for the next sample time.  If we fell behind by more than
+           a sample, skip ahead rather than sampling in a burst. */
+        sampleIndex++;
+        double wait = scheduleStart + (double)sampleIndex * period - monotonicSeconds();
+        if (wait < -period) {
+            sampleIndex += (uint64_t)(-wait / period);
+            wait = scheduleStart + (double)sampleIndex * period - monotonicSeconds();
+        }
+        sleepSeconds(wait);
+    }
+
+    /* Write what we have and let readers know we stopped */
+    if (ok && log.fid != NULL) {
+        writeBlock(&log, block, nInBlock);
+    }
+    closeLogFile(&log);
+    __atomic_store_n(&shared->running, 0, __ATOMIC_RELEASE);
+    munmap(shared, ljSharedBytes(shared->capacity));
+    closeUE3device();
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,57 @@
+// *** Filename: LJTemperatureShared.h
+// *** Purpose: Layout of the POSIX shared memory object in which
+//          LJTemperatureLogger publishes its samples, and which
+//          LJTemperatureFeedMex reads.
+//
+//          The object is a header followed by a ring of capacity slots.
+//          Sample n (counting from 0) goes in slot n % capacity.  Each
+//          slot has its own sequence lock: the writer sets sequence to
+//          2n+1, writes the sample, and sets it to 2n+2, and then sets
+//          count in the header to n+1.  A reader that wants sample n reads
+//          sequence, the sample and sequence again, and has a good copy if
+//          both reads are 2n+2.  Otherwise the sample is being written or
+//          was overwritten by a newer one.  Readers never write, so any
+//          number of them can read at once without locks.
+// *** Date: 10-18-2026
+
+#ifndef LJ_TEMPERATURE_SHARED_H
+#define LJ_TEMPERATURE_SHARED_H
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define LJ_SHARED_MAGIC     "LJTS"
+#define LJ_SHARED_VERSION   2
+#define LJ_SHARED_NAME      "/LJTemperatureFeed"
+#define LJ_CHANNELS         2       /* probe, then U3 internal sensor, in Celsius */
+
+typedef struct {
+    uint64_t sequence;              /* 2n+1 while sample n is written, 2n+2 after */
+    double   time;                  /* seconds since 1970-01-01 UTC */
+    double   value[LJ_CHANNELS];    /* temperatures, NaN if the read failed */
+    double   status;                /* 0 if the read succeeded, -1 if not */
+} LJTemperatureSlot;                /* 40 bytes */
+
+typedef struct {
+    char     magic[4];              /*  0: "LJTS" */
+    uint32_t version;               /*  4: LJ_SHARED_VERSION */
+    uint32_t nChannels;             /*  8: LJ_CHANNELS */
+    uint32_t pid;                   /* 12: process id of the logger */
+    double   sampleRate;            /* 16: samples per second */
+    uint64_t capacity;              /* 24: number of slots */
+    uint64_t count;                 /* 32: number of samples completed */
+    uint32_t running;               /* 40: 1 while the logger is sampling */
+    uint32_t reserved;              /* 44 */
+    LJTemperatureSlot slots[];      /* 48 */
+} LJTemperatureShared;
+
+/* Fail to compile if the layout is not the one documented above */
+typedef char LJTemperatureSlotSizeCheck[(sizeof(LJTemperatureSlot) == 40) ? 1 : -1];
+typedef char LJTemperatureSharedSizeCheck[(offsetof(LJTemperatureShared, slots) == 48) ? 1 : -1];
+
+static inline size_t ljSharedBytes(uint64_t capacity)
+{
+    return offsetof(LJTemperatureShared, slots) + (size_t)capacity * sizeof(LJTemperatureSlot);
+}
+
+#endif
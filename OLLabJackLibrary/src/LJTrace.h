@@ -0,0 +1,38 @@
+// *** Filename: LJTrace.h
+// *** Purpose: Record every USB transaction of a LabJack mex file as a
+//          span of OLTrace.h ("LJUSB_Write", "LJUSB_Read").  Include it
+//          after U3.h or UE9.h, and compile with -I../../OLLibrary/src.
+//          From then on, the LJUSB_Write and LJUSB_Read calls of the file
+//          go through the wrappers below.  The mex file's 'traceEvents'
+//          command hands the spans to OLTraceExport.
+// *** Date: 10-18-2026
+
+#ifndef LJTRACE_H
+#define LJTRACE_H
+
+#include "labjackusb.h"
+
+/* A few hundred transactions a second, at most */
+#define OLTRACE_CAPACITY    16384
+#include "OLTrace.h"
+
+static inline unsigned long LJTraceWrite(HANDLE hDevice, const BYTE *pBuff, unsigned long count)
+{
+    OLTraceBegin("LJUSB_Write");
+    unsigned long n = LJUSB_Write(hDevice, pBuff, count);
+    OLTraceEnd("LJUSB_Write");
+    return n;
+}
+
+static inline unsigned long LJTraceRead(HANDLE hDevice, BYTE *pBuff, unsigned long count)
+{
+    OLTraceBegin("LJUSB_Read");
+    unsigned long n = LJUSB_Read(hDevice, pBuff, count);
+    OLTraceEnd("LJUSB_Read");
+    return n;
+}
+
+#define LJUSB_Write     LJTraceWrite
+#define LJUSB_Read      LJTraceRead
+
+#endif /* LJTRACE_H */
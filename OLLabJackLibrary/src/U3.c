@@ -5,6 +5,12 @@
 //			Many of the functions are extracted from 
 //			The u3Feedback.c file to communicate with the sensor
 // *** Date: 11-30-2016
+// ***
+// *** Compile with -DLJ_NO_MEX to leave out the mexFunction and use the
+// *** device functions from a standalone program (see LJTemperatureLogger).
+// ***
+// *** The mex file records its USB transactions with LJTrace.h
+// *** (10-18-2026).
 
 #include <stdio.h>
 #include <stdlib.h>
@@ -18,8 +24,11 @@
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include "U3.h"
+#ifndef LJ_NO_MEX
 #include "mex.h"
 #include "matrix.h"
+#include "LJTrace.h"
+#endif
 
 static struct termios termNew, termOrig;
 static int peek = -1;
@@ -40,6 +49,7 @@ int openUE3device();
 int closeUE3device();
 double readTemperature(double *tmpData);
 
+#ifndef LJ_NO_MEX
 /* Getaway function */
 void mexFunction(int nlhs,      /* number of output (return) arguments */
       mxArray *plhs[],          /* pointer to an array which will hold the output data, each element is of type: mxArray */
@@ -95,10 +105,16 @@ void mexFunction(int nlhs,      /* number of output (return) arguments */
         
         *status = 0; 
     }
+    else if (strcmp(operandName, "traceEvents")==0) {
+        /* USB transaction spans, for OLTraceExport */
+        plhs[1] = OLTraceEventsToMx();
+        *status = 0;
+    }
     else  {
         printf("Unknown command name, %s", operandName);
     }
 }
+#endif /* LJ_NO_MEX */
 
 // 
 // Function to check if there is a UE3 device attached to the computer
@@ -1,4 +1,5 @@
 /* LJTemperatureProbe.c - MEX driver for acquiring input from a LabJack temperature probe via a UE9 device
+   Records its USB transactions with LJTrace.h (10-18-2026).
 */
 
 #include "mex.h"
@@ -15,6 +16,7 @@
 #include <sys/ioctl.h>
 #include <sys/time.h>
 #include "UE9.h"
+#include "LJTrace.h"
 
 #define OPERAND_NAME_LENGTH    32
 
@@ -81,6 +83,11 @@ void mexFunction(int nlhs,      /* number of output (return) arguments */
         
         *status = 0; 
     }
+    else if (strcmp(operandName, "traceEvents")==0) {
+        /* USB transaction spans, for OLTraceExport */
+        plhs[1] = OLTraceEventsToMx();
+        *status = 0;
+    }
     else  {
         printf("Unknown command name, %s", operandName);
     }
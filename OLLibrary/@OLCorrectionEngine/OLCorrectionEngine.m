@@ -0,0 +1,106 @@
+classdef OLCorrectionEngine < handle
+    % OLCorrectionEngine - Warm-started solver for the spectrum correction loop
+    %
+    % Description:
+    %    OLCorrectToSPD measures the spectrum produced by some primaries,
+    %    then asks for primaries that move the spectrum a learning rate
+    %    fraction of the way towards the target.  Without this object each
+    %    iteration does that from scratch: a smoothed least squares solve
+    %    in OLLinearDeltaPrimaries, truncation, and then a bounded fmincon
+    %    search in OLIterativeDeltaPrimaries to undo the damage done by
+    %    truncation.
+    %
+    %    The engine instead solves the bounded problem directly.  Writing
+    %    x for the next primaries, p for the current ones, M for
+    %    pr650M and D for the first difference operator, it finds
+    %       argmin ||lr*(target - measured) - M*(x - p)||^2 + lambda^2*||D*(x - p)||^2
+    %    subject to 0 <= x <= 1, which is the fmincon objective of
+    %    OLIterativeDeltaPrimaries plus the smoothing term of
+    %    OLLinearDeltaPrimaries.  Posed in terms of x the bounds don't
+    %    change between iterations, so the normal equations matrix (see
+    %    OLSpdToPrimarySolver) is formed once, when the engine is created.
+    %    Each solve starts from p, which was the solution of the previous
+    %    iteration, so the primaries held at 0 or 1 last time are held
+    %    from the start and the active set search typically needs only a
+    %    step or two.
+    %
+    % OLCorrectionEngine Properties:
+    %   Calibration  - Calibration structure the engine was built for.
+    %   Smoothness   - Smoothing parameter lambda.
+    %   Solver       - Precomputed solver, from OLSpdToPrimarySolver.
+    %   NActiveSetChanges - Active set changes taken by each solve so far.
+    %
+    % OLCorrectionEngine Methods:
+    %   OLCorrectionEngine - Build the engine for a calibration.
+    %   initialPrimaries   - Primaries for the first iteration.
+    %   deltaPrimaries     - Change in primaries for the next iteration.
+    %
+    % See also:
+    %    OLCorrectToSPD, OLSpdToPrimarySolver, OLBoundedLeastSquares,
+    %    OLLinearDeltaPrimaries, OLIterativeDeltaPrimaries
+
+    % History:
+    %    10/18/26      Wrote it.
+
+    % Examples:
+    %{
+        demoCalFolder = fullfile(tbLocateToolbox('OneLightToolbox'),'OLDemoCal');
+        calibration = OLGetCalibrationStructure('CalibrationFolder',demoCalFolder,'CalibrationType','DemoCal');
+        targetSPD = OLPrimaryToSpd(calibration,.5*ones(calibration.describe.numWavelengthBands,1));
+
+        engine = OLCorrectionEngine(calibration,'smoothness',0.001);
+        primaries = engine.initialPrimaries(targetSPD);
+        measuredSPD = 1.05*OLPrimaryToSpd(calibration,primaries);
+        deltaPrimaries = engine.deltaPrimaries(primaries,measuredSPD,targetSPD,0.8);
+    %}
+
+    properties (SetAccess = private)
+        Calibration;
+        Smoothness;
+        Solver;
+        NActiveSetChanges = [];
+    end
+
+    methods
+        function obj = OLCorrectionEngine(calibration, varargin)
+            % Build the engine
+            %
+            %   engine = OLCorrectionEngine(calibration)
+            %   engine = OLCorrectionEngine(calibration,'smoothness',0.001)
+            parser = inputParser;
+            parser.addRequired('calibration',@isstruct);
+            parser.addParameter('smoothness', 0.001, @(x)validateattributes(x,{'numeric'},{'scalar','real','finite','nonnegative'}));
+            parser.parse(calibration,varargin{:});
+
+            obj.Calibration = calibration;
+            obj.Smoothness = parser.Results.smoothness;
+            obj.Solver = OLSpdToPrimarySolver(calibration,'lambda',obj.Smoothness);
+        end
+
+        function primaries = initialPrimaries(obj, targetSPD)
+            % Primaries for the first iteration, as OLSpdToPrimary
+            %
+            %   primaries = engine.initialPrimaries(targetSPD)
+            primaries = OLSpdToPrimary(obj.Calibration, targetSPD, 'solver', obj.Solver, ...
+                'primaryHeadroom', 0, 'lambda', obj.Smoothness);
+        end
+
+        function [deltaPrimaries, predictedSPD] = deltaPrimaries(obj, primariesUsed, measuredSPD, targetSPD, learningRate)
+            % Change in primaries for the next iteration
+            %
+            %   [deltaPrimaries, predictedSPD] = engine.deltaPrimaries(primariesUsed, measuredSPD, targetSPD, learningRate)
+            %
+            % Arguments are as for OLIterativeDeltaPrimaries, and
+            % primariesUsed + deltaPrimaries is always within [0,1], so
+            % there is nothing to truncate.
+            solver = obj.Solver;
+            f = solver.pr650MT*(learningRate*(targetSPD(:) - measuredSPD(:))) + solver.H*primariesUsed(:);
+            [nextPrimaries, info] = OLBoundedLeastSquares(solver.H, f, solver.lb, solver.ub, ...
+                'initialX', primariesUsed);
+            obj.NActiveSetChanges(end+1) = info.nIterations;
+
+            deltaPrimaries = nextPrimaries - primariesUsed(:);
+            predictedSPD = measuredSPD(:) + obj.Calibration.computed.pr650M*deltaPrimaries;
+        end
+    end
+end
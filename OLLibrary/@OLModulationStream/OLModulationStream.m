@@ -0,0 +1,203 @@
+classdef OLModulationStream < handle
+    % OLModulationStream - Produce the frames of a modulation on demand
+    %
+    % Description:
+    %    OLPrimaryWaveform forms primaryValues * waveform for every frame of
+    %    a modulation, and OLPrimaryToStartsStops then converts all of them,
+    %    before the first frame can be shown.  For long sessions at high
+    %    frame rates that is a lot of memory and a long wait.
+    %
+    %    A stream keeps only the basis primaries (P x N) and the waveform
+    %    scalars (N x nFrames), which are small, and computes the primaries
+    %    and starts/stops of a frame when they are asked for.  Converted
+    %    frames are kept in a fixed size cache, a ring indexed by frame
+    %    number, so memory use does not depend on the length of the
+    %    modulation.  A modulation no longer than the cache is converted
+    %    only once however many times it is played.
+    %
+    %    During playback, prefetchNext can be called while waiting for the
+    %    next frame to convert frames ahead of the last one requested, one
+    %    at a time, so that frames are ready when they are needed.  OLFlicker
+    %    does this when passed a stream.
+    %
+    % OLModulationStream Properties:
+    %   Calibration      - Calibration used for the conversion.
+    %   PrimaryValues    - P x N basis primaries.
+    %   Waveform         - N x nFrames waveform scalars.
+    %   NFrames          - Number of frames.
+    %   CacheSize        - Number of converted frames kept.
+    %   PrimaryTolerance - Gamut tolerance, as in OLPrimaryWaveform.
+    %
+    % OLModulationStream Methods:
+    %   OLModulationStream - Create a stream from basis primaries and waveform.
+    %   primaryFrames      - Primaries for some frames.
+    %   startsStops        - Starts and stops for some frames.
+    %   prefetchNext       - Convert the next frame not yet in the cache.
+    %   isCached           - Whether frames are in the cache.
+    %
+    % See also:
+    %    OLPrimaryWaveform, OLPrimaryToStartsStops, OLFlicker,
+    %    OLAssembleModulationStream
+
+    % History:
+    %    10/18/26      Wrote it.
+    %    10/18/26      Stop prefetching where the lookahead would evict a
+    %                  frame of its own, and added isCached.
+
+    % Examples:
+    %{
+        %% Ten minutes of 200 Hz flicker, without forming the whole waveform
+        calibration = OLGetCalibrationStructure('CalibrationFolder',fileparts(which('OLDemoCal.mat')),'CalibrationType','DemoCal');
+        P = calibration.describe.numWavelengthBands;
+        timebase = (0:200*600-1)/200;
+        waveform = [ones(size(timebase)) ; 0.4*sin(2*pi*2*timebase)];
+        primaryValues = [0.5*ones(P,1) linspace(-1,1,P)'];
+        stream = OLModulationStream(primaryValues, waveform, calibration);
+
+        % Same frames as converting everything up front
+        [starts, stops] = stream.startsStops(1:10);
+        [startsAll, stopsAll] = OLPrimaryToStartsStops(OLPrimaryWaveform(primaryValues,waveform(:,1:10)),calibration);
+        assert(isequal(starts,startsAll) && isequal(stops,stopsAll));
+    %}
+
+    properties (SetAccess = private)
+        Calibration;
+        PrimaryValues;
+        Waveform;
+        NFrames;
+        CacheSize;
+        PrimaryTolerance;
+    end
+
+    properties (Access = private)
+        % Gamma inversion lookup, built once for all frames.
+        GammaLUT;
+
+        % Ring of converted frames.  Frame k lives in slot
+        % mod(k-1,CacheSize)+1 and CachedFrame holds which frame is in
+        % each slot (0 for none).
+        CachedFrame;
+        CachedStarts;
+        CachedStops;
+
+        % Last frame asked for, which is where prefetching starts from.
+        LastRequested = 0;
+    end
+
+    methods
+        function obj = OLModulationStream(primaryValues, waveform, calibration, varargin)
+            % Create a stream
+            %
+            %   stream = OLModulationStream(primaryValues, waveform, calibration)
+            %   stream = OLModulationStream(...,'cacheSize',200,'primaryTolerance',1e-5)
+            %
+            % primaryValues and waveform are as for OLPrimaryWaveform, so
+            % frame k has primaries primaryValues*waveform(:,k).
+            parser = inputParser();
+            parser.addRequired('primaryValues',@isnumeric);
+            parser.addRequired('waveform',@isnumeric);
+            parser.addRequired('calibration',@isstruct);
+            parser.addParameter('cacheSize',200,@isscalar);
+            parser.addParameter('primaryTolerance',1e-5,@isnumeric);
+            parser.parse(primaryValues,waveform,calibration,varargin{:});
+            assert(size(primaryValues,2) == size(waveform,1),'OneLightToolbox:OLModulationStream:MismatchedSizes',...
+                'Number of primary basis vectors does not match number of waveforms');
+
+            obj.Calibration = calibration;
+            obj.PrimaryValues = primaryValues;
+            obj.Waveform = waveform;
+            obj.NFrames = size(waveform,2);
+            obj.CacheSize = parser.Results.cacheSize;
+            obj.PrimaryTolerance = parser.Results.primaryTolerance;
+
+            obj.GammaLUT = OLGammaInverseLUT(calibration);
+            nCols = calibration.describe.numColMirrors;
+            obj.CachedFrame = zeros(obj.CacheSize,1);
+            obj.CachedStarts = zeros(obj.CacheSize,nCols);
+            obj.CachedStops = zeros(obj.CacheSize,nCols);
+        end
+
+        function primary = primaryFrames(obj, frames)
+            % Primaries for some frames, as P x numel(frames)
+            %
+            %   primary = stream.primaryFrames(frames)
+            %
+            % Truncated within tolerance and checked, as by
+            % OLPrimaryWaveform.
+            [primary, inGamut] = OLGamutKernel(obj.PrimaryValues * obj.Waveform(:,frames), ...
+                [0 1], obj.PrimaryTolerance);
+            assert(inGamut,'OneLightToolbox:PrimaryWaveform:OutOfGamut',...
+                'Primary waveform is out of gamut');
+        end
+
+        function [starts, stops] = startsStops(obj, frames)
+            % Starts and stops for some frames, as numel(frames) x nCols
+            %
+            %   [starts, stops] = stream.startsStops(frames)
+            %
+            % Frames not already in the cache are converted together, and
+            % put in the cache.
+            frames = frames(:);
+            slots = mod(frames-1,obj.CacheSize)+1;
+            cached = (obj.CachedFrame(slots) == frames);
+            starts = zeros(numel(frames),size(obj.CachedStarts,2));
+            stops = zeros(numel(frames),size(obj.CachedStops,2));
+            starts(cached,:) = obj.CachedStarts(slots(cached),:);
+            stops(cached,:) = obj.CachedStops(slots(cached),:);
+            if any(~cached)
+                [newFrames,~,whichNew] = unique(frames(~cached));
+                [newStarts,newStops] = obj.convert(newFrames);
+                starts(~cached,:) = newStarts(whichNew,:);
+                stops(~cached,:) = newStops(whichNew,:);
+            end
+            obj.LastRequested = frames(end);
+        end
+
+        function converted = prefetchNext(obj)
+            % Convert the next frame after the last one asked for that is not in the cache
+            %
+            %   converted = stream.prefetchNext()
+            %
+            % Looks up to CacheSize-1 frames ahead, wrapping around at the
+            % end of the modulation, but stops before the first frame whose
+            % slot is taken by an earlier frame of the lookahead, which
+            % happens across the wrap when NFrames is not a multiple of
+            % CacheSize.  Returns false if there was nothing to convert.
+            lookAhead = min(obj.CacheSize-1, obj.NFrames-1);
+            frames = mod(obj.LastRequested + (0:lookAhead-1)', obj.NFrames) + 1;
+            slots = mod(frames-1,obj.CacheSize)+1;
+            [~,firstUse] = unique(slots,'stable');
+            clash = find(firstUse' ~= 1:numel(firstUse), 1);
+            if ~isempty(clash)
+                frames = frames(1:clash-1);
+                slots = slots(1:clash-1);
+            end
+            next = find(obj.CachedFrame(slots) ~= frames, 1);
+            converted = ~isempty(next);
+            if converted
+                obj.convert(frames(next));
+            end
+        end
+
+        function cached = isCached(obj, frames)
+            % Whether frames are in the cache, as a logical array like frames
+            %
+            %   cached = stream.isCached(frames)
+            slots = mod(frames-1,obj.CacheSize)+1;
+            cached = reshape(obj.CachedFrame(slots),size(frames)) == frames;
+        end
+    end
+
+    methods (Access = private)
+        function [starts, stops] = convert(obj, frames)
+            % Convert frames and put them in the cache.  When there are
+            % more frames than fit, the later ones win.
+            [starts, stops] = OLPrimaryToStartsStops(obj.primaryFrames(frames), obj.Calibration, ...
+                'gammaLUT', obj.GammaLUT);
+            slots = mod(frames-1,obj.CacheSize)+1;
+            obj.CachedFrame(slots) = frames;
+            obj.CachedStarts(slots,:) = starts;
+            obj.CachedStops(slots,:) = stops;
+        end
+    end
+end
@@ -0,0 +1,295 @@
+classdef OLTimeSeriesStore < handle
+    % OLTimeSeriesStore - Time series of spectra kept on disk, appended as they are measured
+    %
+    % Description:
+    %    State tracking measurements (power fluctuation and spectral shift
+    %    SPDs, temperatures) used to be collected column by column in the
+    %    cal struct and saved all at once, so that a monitoring run that
+    %    lasted days was lost if it did not finish, and an analysis of one
+    %    hour of it had to load every spectrum.
+    %
+    %    A store is a directory holding one time series, a sample being a
+    %    time and a column of NValues values (e.g. an SPD).  Each sample is
+    %    written to disk when it is appended, without reading or rewriting
+    %    what is already there.  The times and the values are kept apart:
+    %      header.bin          'OLTS', uint32 version, uint32 NValues,
+    %                          uint32 ChunkSize, double Created (datenum)
+    %                          and double S(1:3) (NaN if not given).
+    %      times.bin           The times, one double per sample.
+    %      values_000001.bin   The values of samples 1 to ChunkSize, one
+    %      values_000002.bin   column of NValues doubles per sample, and
+    %      ...                 so on.
+    %    Everything is little endian.
+    %
+    %    Times must not decrease, so the times are the index of the store:
+    %    they are read once when the store is opened (8 bytes a sample),
+    %    and a time window is found by searching them.  Only the chunks
+    %    that hold the samples in the window are then read, and only the
+    %    part of them that does.
+    %
+    %    The values of a sample are written before its time, so a sample
+    %    counts only once both are complete.  Whatever a crash leaves
+    %    after the last complete sample is ignored, and overwritten by the
+    %    next append.  Other MATLAB sessions can read a store while it is
+    %    being appended to; the samples added since they opened it are
+    %    picked up by their next query.
+    %
+    % OLTimeSeriesStore Properties:
+    %   Directory - Directory holding the store.
+    %   NValues   - Number of values in a sample.
+    %   ChunkSize - Number of samples in a values file.
+    %   S         - Wavelength sampling of the values, if they are spectra.
+    %   Created   - When the store was created, as a datenum.
+    %   Count     - Number of samples.
+    %
+    % OLTimeSeriesStore Methods:
+    %   OLTimeSeriesStore - Open a store, creating it if needed.
+    %   append            - Add samples at the end.
+    %   range             - Samples in a time window.
+    %   samples           - Samples by number.
+    %   times             - Times of all samples.
+    %
+    % See also:
+    %    OLCalibrator.TakeStateMeasurements,
+    %    OLCalibrator.LoadStateMeasurements
+
+    % History:
+    %    10/18/26      Wrote it.
+
+    % Examples:
+    %{
+        %% Append spectra one at a time, then read back an hour's worth
+        S = [380 2 201];
+        store = OLTimeSeriesStore(tempname,'nValues',S(3),'S',S,'chunkSize',64);
+        for k = 1:300
+            store.append(60*k, rand(S(3),1));
+        end
+        [t, spd] = store.range(3600, 7200);
+        assert(isequal(t, 3600:60:7200) && isequal(size(spd), [S(3) 61]));
+
+        % Opening it again finds the same samples
+        store = OLTimeSeriesStore(store.Directory);
+        assert(store.Count == 300);
+    %}
+
+    properties (SetAccess = private)
+        Directory;
+        NValues;
+        ChunkSize;
+        S;
+        Created;
+        Count = 0;
+    end
+
+    properties (Access = private)
+        % Times of the samples, which index the store
+        Times = zeros(1,0);
+    end
+
+    properties (Constant, Access = private)
+        Version = 1;
+    end
+
+    methods
+        function obj = OLTimeSeriesStore(directory, varargin)
+            % Open a store, creating it if there is none
+            %
+            %   store = OLTimeSeriesStore(directory)
+            %   store = OLTimeSeriesStore(directory,'nValues',201,'S',[380 2 201],'chunkSize',1024)
+            %
+            % nValues is needed to create a store.  When opening an
+            % existing one it is checked against the store, if given.
+            parser = inputParser();
+            parser.addRequired('directory',@ischar);
+            parser.addParameter('nValues',[],@(x) isempty(x) || (isscalar(x) && x >= 1));
+            parser.addParameter('S',[],@(x) isempty(x) || numel(x) == 3);
+            parser.addParameter('chunkSize',1024,@(x) isscalar(x) && x >= 1);
+            parser.parse(directory,varargin{:});
+            obj.Directory = directory;
+
+            if exist(fullfile(directory,'header.bin'),'file')
+                obj.readHeader();
+                assert(isempty(parser.Results.nValues) || parser.Results.nValues == obj.NValues, ...
+                    'OneLightToolbox:OLTimeSeriesStore:MismatchedSizes', ...
+                    '%s holds samples of %d values, not %d', directory, obj.NValues, parser.Results.nValues);
+                obj.refresh();
+            else
+                assert(~isempty(parser.Results.nValues),'OneLightToolbox:OLTimeSeriesStore:NoStore', ...
+                    'There is no store in %s, and nValues is needed to create one', directory);
+                obj.NValues = parser.Results.nValues;
+                obj.ChunkSize = parser.Results.chunkSize;
+                obj.S = parser.Results.S;
+                obj.Created = now;
+                obj.writeHeader();
+            end
+        end
+
+        function append(obj, t, values)
+            % Add samples at the end of the store
+            %
+            %   store.append(t, values)
+            %
+            % t has the times of the samples, which must not decrease nor
+            % be earlier than the last sample already there, and values
+            % the samples as NValues x numel(t).
+            t = t(:)';
+            assert(size(values,1) == obj.NValues && size(values,2) == numel(t), ...
+                'OneLightToolbox:OLTimeSeriesStore:MismatchedSizes', ...
+                'Values must be %d x numel(t)', obj.NValues);
+            % Last time already there, none in a new store
+            assert(all(diff([obj.Times(max(end,1):end) t]) >= 0), ...
+                'OneLightToolbox:OLTimeSeriesStore:TimeNotIncreasing', ...
+                'Times must not decrease');
+            if isempty(t)
+                return;
+            end
+
+            % Values first, a chunk at a time
+            first = obj.Count + 1;
+            last = obj.Count + numel(t);
+            for chunk = obj.chunkOf(first):obj.chunkOf(last)
+                inChunk = max(first, (chunk-1)*obj.ChunkSize+1):min(last, chunk*obj.ChunkSize);
+                offset = 8*obj.NValues*(inChunk(1) - (chunk-1)*obj.ChunkSize - 1);
+                obj.writeAt(obj.chunkFileName(chunk), offset, values(:,inChunk-obj.Count));
+            end
+
+            % Then the times, which makes them count
+            obj.writeAt(fullfile(obj.Directory,'times.bin'), 8*obj.Count, t);
+            obj.Times = [obj.Times t];
+            obj.Count = last;
+        end
+
+        function [t, values] = range(obj, tStart, tEnd)
+            % Samples whose times are in [tStart, tEnd]
+            %
+            %   [t, values] = store.range(tStart, tEnd)
+            %
+            % t is 1 x n and values NValues x n, oldest first.
+            obj.refresh();
+            first = find(obj.Times >= tStart, 1);
+            last = find(obj.Times <= tEnd, 1, 'last');
+            if isempty(first) || isempty(last) || last < first
+                t = zeros(1,0);
+                values = zeros(obj.NValues,0);
+                return;
+            end
+            [t, values] = obj.samples(first, last);
+        end
+
+        function [t, values] = samples(obj, first, last)
+            % Samples first to last, counting from 1
+            %
+            %   [t, values] = store.samples(first, last)
+            obj.refresh();
+            assert(first >= 1 && last <= obj.Count, 'OneLightToolbox:OLTimeSeriesStore:OutOfRange', ...
+                'Samples %d to %d are not all in a store of %d', first, last, obj.Count);
+            t = obj.Times(first:last);
+            values = zeros(obj.NValues, max(last-first+1,0));
+            for chunk = obj.chunkOf(first):obj.chunkOf(last)
+                inChunk = max(first, (chunk-1)*obj.ChunkSize+1):min(last, chunk*obj.ChunkSize);
+                if isempty(inChunk)
+                    continue;
+                end
+                offset = 8*obj.NValues*(inChunk(1) - (chunk-1)*obj.ChunkSize - 1);
+                fid = fopen(obj.chunkFileName(chunk), 'r', 'ieee-le');
+                if (fid < 0)
+                    error('OneLightToolbox:OLTimeSeriesStore:CannotOpen', 'Cannot open %s', obj.chunkFileName(chunk));
+                end
+                fseek(fid, offset, 'bof');
+                values(:,inChunk-first+1) = fread(fid, [obj.NValues numel(inChunk)], 'double');
+                fclose(fid);
+            end
+        end
+
+        function t = times(obj)
+            % Times of all samples
+            %
+            %   t = store.times()
+            obj.refresh();
+            t = obj.Times;
+        end
+    end
+
+    methods (Access = private)
+        function refresh(obj)
+            % Pick up samples appended since the times were last read
+            timesFileName = fullfile(obj.Directory,'times.bin');
+            info = dir(timesFileName);
+            if isempty(info) || floor(info.bytes/8) <= obj.Count
+                return;
+            end
+            fid = fopen(timesFileName, 'r', 'ieee-le');
+            fseek(fid, 8*obj.Count, 'bof');
+            newTimes = fread(fid, [1 floor(info.bytes/8)-obj.Count], 'double');
+            fclose(fid);
+            obj.Times = [obj.Times newTimes];
+            obj.Count = numel(obj.Times);
+        end
+
+        function readHeader(obj)
+            fileName = fullfile(obj.Directory,'header.bin');
+            fid = fopen(fileName, 'r', 'ieee-le');
+            if (fid < 0)
+                error('OneLightToolbox:OLTimeSeriesStore:CannotOpen', 'Cannot open %s', fileName);
+            end
+            magic = fread(fid, [1 4], '*char');
+            sizes = fread(fid, [1 3], 'uint32');
+            numbers = fread(fid, [1 4], 'double');
+            fclose(fid);
+            if (~strcmp(magic,'OLTS') || numel(numbers) < 4 || sizes(1) ~= obj.Version)
+                error('OneLightToolbox:OLTimeSeriesStore:BadHeader', '%s is not a time series store header', fileName);
+            end
+            obj.NValues = sizes(2);
+            obj.ChunkSize = sizes(3);
+            obj.Created = numbers(1);
+            obj.S = numbers(2:4);
+            if any(isnan(obj.S))
+                obj.S = [];
+            end
+        end
+
+        function writeHeader(obj)
+            if ~exist(obj.Directory,'dir')
+                mkdir(obj.Directory);
+            end
+            S = nan(1,3);
+            if ~isempty(obj.S)
+                S = obj.S(:)';
+            end
+            fileName = fullfile(obj.Directory,'header.bin');
+            fid = fopen(fileName, 'w', 'ieee-le');
+            if (fid < 0)
+                error('OneLightToolbox:OLTimeSeriesStore:CannotOpen', 'Cannot open %s for writing', fileName);
+            end
+            fwrite(fid, 'OLTS', 'char');
+            fwrite(fid, [obj.Version obj.NValues obj.ChunkSize], 'uint32');
+            fwrite(fid, [obj.Created S], 'double');
+            fclose(fid);
+        end
+
+        function chunk = chunkOf(obj, sample)
+            chunk = floor((sample-1)/obj.ChunkSize) + 1;
+        end
+
+        function fileName = chunkFileName(obj, chunk)
+            fileName = fullfile(obj.Directory, sprintf('values_%06d.bin', chunk));
+        end
+    end
+
+    methods (Static, Access = private)
+        function writeAt(fileName, offset, data)
+            % Write doubles at a byte offset, over anything already there
+            if exist(fileName,'file')
+                fid = fopen(fileName, 'r+', 'ieee-le');
+            else
+                fid = fopen(fileName, 'w', 'ieee-le');
+            end
+            if (fid < 0)
+                error('OneLightToolbox:OLTimeSeriesStore:CannotOpen', 'Cannot open %s for writing', fileName);
+            end
+            fseek(fid, offset, 'bof');
+            fwrite(fid, data, 'double');
+            fclose(fid);
+        end
+    end
+end
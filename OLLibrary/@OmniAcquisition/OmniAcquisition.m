@@ -0,0 +1,287 @@
+classdef OmniAcquisition < handle
+    % OmniAcquisition - Keep acquiring OmniDriver spectra into a ring buffer
+    %
+    % Description:
+    %    OmniDriver.getSpectrum waits for the spectrometer, for an
+    %    integration and the Java calls around it, every time it is
+    %    called.  An acquisition instead pulls spectra from the spectrometer
+    %    on its own schedule, from a timer, and keeps the last BufferSize of
+    %    them in a ring.  Code that wants a spectrum asks for the latest ones
+    %    with latest, which returns at once from the ring, so a loop that
+    %    plots or checks spectra no longer waits on the spectrometer.
+    %
+    %    As each spectrum comes in, it is normalized by integration time,
+    %    the dark spectrum (see setDark) is subtracted, and the running
+    %    average of the last AveragingWindow valid, unsaturated spectra is
+    %    updated, so averaging costs one addition and one subtraction per
+    %    spectrum.  Saturated and invalid spectra are kept in the ring,
+    %    flagged, and left out of the average.  Changing the integration
+    %    time starts the average again, and drops the dark spectrum if it
+    %    was taken at another integration time.
+    %
+    %    The timer runs on the MATLAB thread, when MATLAB is waiting (pause,
+    %    drawnow, uiwait and the like).  The spectrometer is then busy for
+    %    an acquisition, but the code asking for spectra never is.
+    %
+    % OmniAcquisition Properties:
+    %   Driver          - OmniDriver object acquired from.
+    %   BufferSize      - Number of spectra kept.
+    %   AveragingWindow - Number of spectra in the running average.
+    %   Period          - Seconds between acquisitions.
+    %   NAcquired       - Number of spectra acquired so far.
+    %   IsRunning       - True while acquiring.
+    %
+    % OmniAcquisition Methods:
+    %   OmniAcquisition - Create an acquisition for an OmniDriver.
+    %   start           - Start acquiring.
+    %   stop            - Stop acquiring.
+    %   latest          - The latest spectra, and their averages and flags.
+    %   setDark         - Use the current average as the dark spectrum.
+    %   acquire         - Acquire one spectrum now.
+    %
+    % See also:
+    %    OmniDriver, OmniScope
+
+    % History:
+    %    10/18/26      Wrote it.
+
+    % Examples:
+    %{
+        %% Average of the last 10 spectra, without waiting for them
+        od = OmniDriver;
+        acquisition = OmniAcquisition(od,'averagingWindow',10);
+        acquisition.start();
+        pause(2);
+        [~, averaged, info] = acquisition.latest(1);
+        plot(od.Wavelengths, averaged);
+        acquisition.stop();
+    %}
+
+    properties (SetAccess = private)
+        Driver;
+        BufferSize;
+        AveragingWindow;
+        Period;
+        NAcquired = 0;
+    end
+
+    properties (Dependent = true)
+        IsRunning;
+    end
+
+    properties (Access = private)
+        Timer = [];
+
+        % Ring of spectra.  Spectrum n lives in row mod(n-1,BufferSize)+1.
+        Spectra;
+        Averaged;
+        Times;
+        IntegrationTimes;
+        Saturated;
+        Valid;
+
+        % Running average, as the sum of the spectra in it and their
+        % numbers, oldest first.
+        AverageSum;
+        AverageMembers = zeros(0,1);
+
+        % Dark spectrum (per microsecond) and the integration time it was
+        % taken at.
+        Dark = [];
+        DarkIntegrationTime = [];
+    end
+
+    methods
+        function obj = OmniAcquisition(od, varargin)
+            % Create an acquisition
+            %
+            %   acquisition = OmniAcquisition(od)
+            %   acquisition = OmniAcquisition(od,'bufferSize',100,'averagingWindow',10,'period',0.01)
+            %
+            % Does not start acquiring, see start.
+            parser = inputParser();
+            parser.addRequired('od',@(x) isa(x,'OmniDriver'));
+            parser.addParameter('bufferSize',100,@isscalar);
+            parser.addParameter('averagingWindow',10,@isscalar);
+            parser.addParameter('period',0.01,@isscalar);
+            parser.parse(od,varargin{:});
+            assert(parser.Results.averagingWindow <= parser.Results.bufferSize, ...
+                'OneLightToolbox:OmniAcquisition:WindowTooLarge', ...
+                'The averaging window must fit in the buffer');
+            assert(od.IsOpen,'OneLightToolbox:OmniAcquisition:NotOpen', ...
+                'Not connected to the spectrometer.');
+
+            obj.Driver = od;
+            obj.BufferSize = parser.Results.bufferSize;
+            obj.AveragingWindow = parser.Results.averagingWindow;
+            obj.Period = parser.Results.period;
+
+            nPixels = od.NumPixels;
+            obj.Spectra = zeros(obj.BufferSize,nPixels);
+            obj.Averaged = zeros(obj.BufferSize,nPixels);
+            obj.Times = zeros(obj.BufferSize,1);
+            obj.IntegrationTimes = zeros(obj.BufferSize,1);
+            obj.Saturated = false(obj.BufferSize,1);
+            obj.Valid = false(obj.BufferSize,1);
+            obj.AverageSum = zeros(1,nPixels);
+        end
+
+        function delete(obj)
+            obj.stop();
+        end
+
+        function start(obj)
+            % Start acquiring
+            %
+            %   acquisition.start()
+            if obj.IsRunning
+                return;
+            end
+            obj.Timer = timer('Name','OmniAcquisitionTimer', ...
+                'Period',obj.Period, ...
+                'ExecutionMode','fixedSpacing', ...
+                'BusyMode','drop', ...
+                'TasksToExecute',inf, ...
+                'TimerFcn',@(~,~) obj.acquire());
+            start(obj.Timer);
+        end
+
+        function stop(obj)
+            % Stop acquiring
+            %
+            %   acquisition.stop()
+            %
+            % The spectra acquired are kept.
+            if ~isempty(obj.Timer) && isvalid(obj.Timer)
+                stop(obj.Timer);
+                delete(obj.Timer);
+            end
+            obj.Timer = [];
+        end
+
+        function value = get.IsRunning(obj)
+            value = ~isempty(obj.Timer) && isvalid(obj.Timer) && strcmp(obj.Timer.Running,'on');
+        end
+
+        function [spectra, averaged, info] = latest(obj, n)
+            % The latest spectra, oldest first
+            %
+            %   [spectra, averaged, info] = acquisition.latest()
+            %   [spectra, averaged, info] = acquisition.latest(n)
+            %
+            % spectra are the last n spectra (default 1), n x NumPixels,
+            % per microsecond and dark corrected, and averaged the running
+            % average as it was when each came in (NaN if there was none
+            % yet).  Fewer are returned if fewer are in the ring.  info has
+            % fields number (1 for the first acquired), t (mglGetSecs),
+            % integrationTime, saturated and valid, one element for each.
+            if (nargin < 2)
+                n = 1;
+            end
+            numbers = (max(obj.NAcquired-min(n,obj.BufferSize),0)+1:obj.NAcquired)';
+            rows = mod(numbers-1,obj.BufferSize)+1;
+            spectra = obj.Spectra(rows,:);
+            averaged = obj.Averaged(rows,:);
+            info.number = numbers;
+            info.t = obj.Times(rows);
+            info.integrationTime = obj.IntegrationTimes(rows);
+            info.saturated = obj.Saturated(rows);
+            info.valid = obj.Valid(rows);
+        end
+
+        function setDark(obj)
+            % Use the current running average as the dark spectrum
+            %
+            %   acquisition.setDark()
+            %
+            % Take it with the light off.  Spectra acquired from now on, at
+            % the same integration time, have it subtracted.
+            assert(~isempty(obj.AverageMembers),'OneLightToolbox:OmniAcquisition:NoAverage', ...
+                'No spectra to take the dark spectrum from.');
+            dark = obj.AverageSum/numel(obj.AverageMembers);
+            if ~isempty(obj.Dark)
+                % The average already had the old dark spectrum taken off
+                dark = dark + obj.Dark;
+            end
+            obj.Dark = dark;
+            obj.DarkIntegrationTime = obj.IntegrationTimes(mod(obj.AverageMembers(end)-1,obj.BufferSize)+1);
+            obj.resetAverage();
+        end
+
+        function acquire(obj)
+            % Acquire one spectrum and put it in the ring
+            %
+            %   acquisition.acquire()
+            %
+            % This is what the timer calls.  Failed acquisitions are kept
+            % as invalid spectra rather than thrown.
+            integrationTime = obj.Driver.IntegrationTime;
+            try
+                [specData, isSaturated] = obj.Driver.getSpectrum(true);
+                isValid = true;
+            catch e
+                if ~strcmp(e.identifier,'OmniDriver:getSpectrum:Invalid')
+                    obj.stop();
+                    rethrow(e);
+                end
+                specData = NaN(1,size(obj.Spectra,2));
+                isSaturated = false;
+                isValid = false;
+            end
+
+            n = obj.NAcquired + 1;
+            row = mod(n-1,obj.BufferSize)+1;
+            spectrum = specData(:)' / integrationTime;
+            if ~isempty(obj.Dark) && obj.DarkIntegrationTime ~= integrationTime
+                obj.Dark = [];
+                obj.DarkIntegrationTime = [];
+            end
+            if ~isempty(obj.Dark)
+                spectrum = spectrum - obj.Dark;
+            end
+
+            % The average starts again when the integration time changes.
+            % Spectra still in the average are still in the ring, since the
+            % window fits in it.
+            if ~isempty(obj.AverageMembers) && ...
+                    obj.IntegrationTimes(mod(obj.AverageMembers(end)-1,obj.BufferSize)+1) ~= integrationTime
+                obj.resetAverage();
+            end
+            if ~isempty(obj.AverageMembers) && obj.AverageMembers(1) <= n-obj.BufferSize
+                obj.dropOldestFromAverage();
+            end
+            if isValid && ~isSaturated
+                if numel(obj.AverageMembers) == obj.AveragingWindow
+                    obj.dropOldestFromAverage();
+                end
+                obj.AverageSum = obj.AverageSum + spectrum;
+                obj.AverageMembers(end+1,1) = n;
+            end
+
+            obj.Spectra(row,:) = spectrum;
+            if isempty(obj.AverageMembers)
+                obj.Averaged(row,:) = NaN;
+            else
+                obj.Averaged(row,:) = obj.AverageSum/numel(obj.AverageMembers);
+            end
+            obj.Times(row) = mglGetSecs;
+            obj.IntegrationTimes(row) = integrationTime;
+            obj.Saturated(row) = isSaturated;
+            obj.Valid(row) = isValid;
+            obj.NAcquired = n;
+        end
+    end
+
+    methods (Access = private)
+        function resetAverage(obj)
+            obj.AverageSum = zeros(1,size(obj.Spectra,2));
+            obj.AverageMembers = zeros(0,1);
+        end
+
+        function dropOldestFromAverage(obj)
+            oldest = mod(obj.AverageMembers(1)-1,obj.BufferSize)+1;
+            obj.AverageSum = obj.AverageSum - obj.Spectra(oldest,:);
+            obj.AverageMembers(1) = [];
+        end
+    end
+end
@@ -82,7 +82,7 @@ classdef OmniDriver < handle
 		end
 		
 		[specData,isSaturated] = getSpectrum(obj,ignoreSaturationError)
-		integrationTime = findIntegrationTime(obj, increment, factor, minTime, maxTime)
+		[integrationTime, searchTrace] = findIntegrationTime(obj, increment, factor, minTime, maxTime)
 	end
 	
 	methods (Access = private)
@@ -1,4 +1,4 @@
-function integrationTime = findIntegrationTime(obj, increment, factor, minTime, maxTime)
+function [integrationTime, searchTrace] = findIntegrationTime(obj, increment, factor, minTime, maxTime)
 % findIntegrationTime - Finds the largest integration time without saturation.
 %
 % Syntax:
@@ -7,6 +7,7 @@ function integrationTime = findIntegrationTime(obj, increment, factor, minTime,
 % integrationTime = obj.findIntegrationTime(increment, factor)
 % integrationTime = obj.findIntegrationTime(increment, factor, minTime)
 % integrationTime = obj.findIntegrationTime(increment, factor, minTime, maxTime)
+% [integrationTime, searchTrace] = obj.findIntegrationTime(...)
 %
 % Description:
 % The spectrometer can vary the integration time of spectral measurements.
@@ -15,17 +16,38 @@ function integrationTime = findIntegrationTime(obj, increment, factor, minTime,
 % to find the largest integration time within the specified or default
 % bounds before it gets saturated.
 %
+% Counts grow linearly with integration time until they saturate, so each
+% unsaturated spectrum tells us when the peak pixel would reach
+% obj.MaxIntensity: from its peak count through zero for the first one,
+% and from the line through the two longest unsaturated times after
+% that, which takes out any dark offset.  The next time tested is just
+% below that prediction.  The largest unsaturated and the smallest
+% saturated time tested bracket the answer.  When a predicted time
+% saturated, or the prediction is past a time that did, the next time
+% tested is the fraction 1/factor of the way up the bracket instead.  The
+% search stops when the bracket is no wider than increment, usually after
+% three or four spectra.
+%
 % Input:
-% increment (scalar) - The integer number of microseconds to step.
-%     Default: 1000
-% factor (scal) - The number to divide by between tests.
-%     Default: 2
+% increment (scalar) - The integer number of microseconds to resolve the
+%     integration time to. Default: 1000
+% factor (scal) - Where to test in the bracket when the prediction can't
+%     be used, 2 for the middle. Default: 2
 % minTime (scalar) - The starting integration time of the search in
 %     microseconds. Default: The value of obj.MinIntegrationTime
 % maxTime (scalar) - The max integration time of the search in microseconds.
-%     Default: The value of obj.MaxIntegrationTime
+%     Default: 200000
+%
+% Output:
+% integrationTime (scalar) - The largest integration time tested that
+%     doesn't saturate.
+% searchTrace (struct array) - One element per spectrum taken, with fields
+%     integrationTime, peak (largest count), saturated, and predicted
+%     (the time we predicted saturation at when choosing this time, NaN
+%     when not chosen from a prediction).
 %
 % 7/19/12 kds, pl, ms Edited to make more efficient
+% 10/18/26            Choose the times to test from a linear model of the peak counts.
 
 %% Basic checks
 assert(nargin >= 1 && nargin <= 5, 'OmniDriver:findIntegrationTime:NumInputs', ...
@@ -39,7 +61,7 @@ end
 if ~exist('factor', 'var') || isempty(factor)
     factor = 2;
 end
-if ~exist ('minTime', 'var') || isempty(increment)
+if ~exist ('minTime', 'var') || isempty(minTime)
 	minTime = obj.MinIntegrationTime;
 end
 if ~exist('maxTime', 'var') || isempty(maxTime)
@@ -66,118 +88,88 @@ assert(maxTime >= obj.MinIntegrationTime && maxTime <= obj.MaxIntegrationTime, .
 assert(minTime <= maxTime, 'OmniDriver:findIntegrationTime:InvalidInput', ...
 	'MinTime must be less than or equal to MaxTime.');
 
-%% Create initial list of integration times.
-% We start at max and come down by a fixed
-% factor until we are not saturated.
-maxToMinPower = log(maxTime/minTime)/log(factor);
-fractionsOfMaxTime = 1./factor.^(0:1:maxToMinPower);
-timesToTest = round(maxTime * fractionsOfMaxTime);
-if ~any(timesToTest == minTime)
-    timesToTest(end+1) = minTime;
-end
-
 %% Make a copy of the original integration time so we can restore it before
 % we leave this function.
 integrationTime0 = obj.IntegrationTime;
+maxIntensity = obj.MaxIntensity;
 
 %% Start our great mission
 if obj.Debug
 	fprintf('- Finding integration time\n');
 end
+searchTrace = struct('integrationTime', {}, 'peak', {}, 'saturated', {}, 'predicted', {});
 
 %% But, firt test that minimum possible integration time doesn't saturate.  If it
 % does, don't bother testing other times.
-obj.IntegrationTime = minTime;
-if obj.Debug
-    fprintf('- Testing time %d\n', minTime);
+testTime(minTime, NaN);
+if searchTrace(1).saturated
+    obj.IntegrationTime = integrationTime0;
+    error('OmniDriver:findIntegrationTime:Saturated', 'Cannot find an integration time.');
 end
 
-try
-    obj.getSpectrum;
-catch se
-    % If we get a saturated error on the minimum tested value, throw an
-    % error.
-    if strcmp(se.identifier, 'OmniDriver:getSpectrum:Saturated')
-        error('Cannot find an integration time.');
-    else
-        rethrow(se);
+%% Narrow the bracket [lo,hi) down.  hi is maxTime+1 until something saturates.
+lo = minTime;
+hi = maxTime + 1;
+while (hi - lo > increment)
+    predicted = predictSaturationTime;
+    nextTime = min(round(predicted - increment/2), maxTime);
+    lastMissed = searchTrace(end).saturated && ~isnan(searchTrace(end).predicted);
+    if (~lastMissed && nextTime < lo + increment)
+        % Predicted to saturate just above lo.  See if it does.
+        nextTime = lo + increment;
+    elseif (lastMissed || nextTime >= hi)
+        % The last prediction saturated, or this one is past a time that
+        % did, so the counts aren't behaving linearly up here.
+        predicted = NaN;
+        nextTime = round(lo + (hi - lo)/factor);
     end
-end
-            
-%% Loop over our test integration times.  Jump out of the loop when we find
-% the saturation point.
-for i = 1:length(timesToTest)
-	% Set the test integration time.
-	obj.IntegrationTime = timesToTest(i);
-	if obj.Debug
-		fprintf('- Testing time %d\n', timesToTest(i));
-	end
-	
-	try
-		obj.getSpectrum;
-	catch se
-		% If we're still above the saturation point, drop the integration
-		% time back down a little bit then take another measurement.
-		if strcmp(se.identifier, 'OmniDriver:getSpectrum:Saturated')
-			% If we saturate, skip the rest of the loop and try the next
-			% lower integration time.
-			continue;
-		else
-			rethrow(se);
-		end
-    end
-    
-    % If we reach this point, then the current integration time doesn't
-    % produce saturation. But because we were using multiplicative
-    % decrease, we may not be as high as we would like.  So now
-    % we creep back up linearly to a good value.
-    if i == 1
-        % If the highest value we try doesn't saturate, we can use it.
-        integrationTime = timesToTest(i);
-        break
+    nextTime = max(lo + 1, min(nextTime, hi - 1));
+    testTime(nextTime, predicted);
+    if searchTrace(end).saturated
+        hi = nextTime;
     else
-        % Now we want to try incrementing until we reach
-        % saturation or get back to the lowest value that we know produces
-        % saturation.
-        newTimesToTest = timesToTest(i):increment:timesToTest(i-1);
-        for j = 2:numel(newTimesToTest)
-            % Set the test integration time.
-            obj.IntegrationTime = newTimesToTest(j);
-            if obj.Debug
-                fprintf('- Testing time %d\n', newTimesToTest(j));
-            end
-            
-            try
-                obj.getSpectrum;
-            catch se
-                % If we've reached the saturation point, use the last 
-                % integration time that didn't hit saturation.
-                if strcmp(se.identifier, 'OmniDriver:getSpectrum:Saturated')
-                    integrationTime = newTimesToTest(j-1);
-                    break;
-                else
-                    rethrow(se);
-                end
-            end
-        end
-        
-        % If we successfully found an integration time that doesn't
-        % saturate, we want to stop testing and use it.
-        if exist('integrationTime','var') && (integrationTime == newTimesToTest(j-1))
-            break
+        lo = nextTime;
+        if (lo == maxTime)
+            break;
         end
     end
 end
+integrationTime = lo;
 
-%% Reset the original integration time.
 if obj.Debug
-    if (exist('integrationTime','var'))
-        fprintf('- Found integration time of %d\n', integrationTime);
-    else
-        fprintf('- Did not find a working integration time, returning passed value\n');
-        integrationTime = integrationTime0;
-    end
+    fprintf('- Found integration time of %d after %d spectra\n', integrationTime, numel(searchTrace));
 end
 
-%% We think this line has no purpose
+%% Reset the original integration time.
 obj.IntegrationTime = integrationTime0;
+
+    function testTime(timeToTest, predicted)
+        % Take a spectrum at this time and add it to the trace.
+        obj.IntegrationTime = timeToTest;
+        if obj.Debug
+            fprintf('- Testing time %d\n', timeToTest);
+        end
+        [specData, isSaturated] = obj.getSpectrum(true);
+        searchTrace(end+1) = struct('integrationTime', timeToTest, 'peak', max(specData), ...
+            'saturated', logical(isSaturated), 'predicted', predicted);
+    end
+
+    function predicted = predictSaturationTime
+        % When the peak would reach maxIntensity, from the unsaturated
+        % spectra with the longest times.
+        good = searchTrace(~[searchTrace.saturated]);
+        [times, order] = sort([good.integrationTime]);
+        peaks = [good(order).peak];
+        slope = peaks(end) / times(end);
+        offset = 0;
+        if (numel(times) >= 2 && times(end) > times(end-1) && peaks(end) > peaks(end-1))
+            slope = (peaks(end) - peaks(end-1)) / (times(end) - times(end-1));
+            offset = peaks(end) - slope*times(end);
+        end
+        if (slope > 0)
+            predicted = (maxIntensity - offset) / slope;
+        else
+            predicted = Inf;
+        end
+    end
+end
@@ -21,7 +21,10 @@ function [specData,isSaturated] = getSpectrum(obj,ignoreSaturationError)
 % OmniDriver:getSpectrum:Invalid
 % OmniDriver:getSpectrum:NotOpen
 
+% 10/18/26      Trace the time spent here, with OLTrace.
+
 assert(obj.IsOpen, 'OmniDriver:getSpectrum:NotOpen', 'Not connected to the spectrometer.');
+span = OLTraceSpan('OmniDriver:getSpectrum'); %#ok<NASGU>
 
 specData = obj.Wrapper.getSpectrum(obj.TargetSpectrometer)';
 
@@ -15,6 +15,8 @@ classdef OneLight < hgsetget
 	%    NumCols - Number of columns of mirrors in the device.
 	%    NumRows - Number of rows of mirrors in the device.
 	%    OutputPatternBuffer - Buffer whose pattern is to displayed.
+	%    DifferentialUpdates - Skip/limit pattern sends to columns that changed.
+	%    DeltaStats - Counts of patterns, changed columns and bytes saved.
 	%
 	% OneLight Methods:
 	%    OneLight - Constructor.
@@ -30,6 +32,12 @@ classdef OneLight < hgsetget
     %               features we don't generally use, so this may not be
     %               totally robust.
     % 09/25/17 dhb  Add 'plotWhenSimulating' key/value pair.
+    % 10/18/26      Add 'differentialUpdates' key/value pair.
+    % 10/18/26      Simulated device model with transfer latency, pattern
+    %               buffers, trigger delay and a binary pattern trace.
+    % 10/18/26      Trace the OneLightEngine calls, see private/tracedEngine.
+    % 10/18/26      Keep the simulated trace across close and open, and sleep
+    %               through most of the simulated latencies.
 	
 	properties (Dependent = true)
         LampStatus;
@@ -54,6 +62,32 @@ classdef OneLight < hgsetget
         Simulate;
         PlotWhenSimulating;
         SimFig;
+        SimLine;
+        DifferentialUpdates;
+        DeltaStats;
+	end
+	
+	% Last pattern sent to the input pattern buffer, used by
+	% differential updates.  Empty when unknown.
+	properties (Access = private)
+		LastStarts = [];
+		LastStops = [];
+	end
+	
+	% State of the simulated device.  See the 'sim*' key/value pairs of
+	% the constructor.
+	properties (Access = private)
+		SimTransferLatencySecs = 0;
+		SimBufferSwitchLatencySecs = 0;
+		SimTriggerMode = 0;
+		SimTriggerDelaySecs = 0;
+		SimTraceFile = '';
+		SimTraceFid = -1;
+		SimStartTime;
+		SimInputBuffer = 0;
+		SimOutputBuffer = 0;
+		SimBufferStarts = {};
+		SimBufferStops = {};
 	end
 	
 	properties (SetAccess = private, Dependent = true)
@@ -81,14 +115,45 @@ classdef OneLight < hgsetget
             % 'plotWhenSimulating' (logical) - When simulating, make a plot to show what the
             %                                  mirrors are doing?  Default true.  Turn off to
             %                                  get more realistic timing in simulation.
+            % 'differentialUpdates' (logical) - Compare each pattern passed to setMirrors
+            %                                  with the last one sent and only send/plot
+            %                                  what changed.  Default false.
+            %
+            % The following only matter when simulating.  They model the device closely
+            % enough that timing of playback code can be tested without hardware.
+            % 'simTransferLatencySecs' (scalar) - Time setMirrors and setAll block for,
+            %                                  to model the USB transfer.  Default 0.
+            % 'simBufferSwitchLatencySecs' (scalar) - Time setting OutputPatternBuffer
+            %                                  blocks for.  Default 0.
+            % 'simNumPatternBuffers' (scalar) - Number of pattern buffers.  Default 4.
+            % 'simTriggerMode' (scalar)      - Value reported as InputTriggerMode.  When
+            %                                  non-zero, a pattern sent to the buffer being
+            %                                  displayed only shows after simTriggerDelaySecs.
+            %                                  Default 0.
+            % 'simTriggerDelaySecs' (scalar) - See simTriggerMode.  Default 0.
+            % 'simTraceFile' (string)        - If not empty, every pattern received by the
+            %                                  simulated device is appended to this binary
+            %                                  file.  The file is started anew when the
+            %                                  object is first opened, and kept across close
+            %                                  and open.  Read it with
+            %                                  OLReadSimulatedPatternTrace.  Default ''.
             
             % Parse key/value pairs
             p = inputParser;
             p.addParameter('deviceID', 0, @isscalar);
             p.addParameter('simulate', false, @islogical);
             p.addParameter('plotWhenSimulating', true, @islogical);
+            p.addParameter('differentialUpdates', false, @islogical);
+            p.addParameter('simTransferLatencySecs', 0, @isscalar);
+            p.addParameter('simBufferSwitchLatencySecs', 0, @isscalar);
+            p.addParameter('simNumPatternBuffers', 4, @isscalar);
+            p.addParameter('simTriggerMode', 0, @isscalar);
+            p.addParameter('simTriggerDelaySecs', 0, @isscalar);
+            p.addParameter('simTraceFile', '', @ischar);
             p.parse(varargin{:});
             params = p.Results;
+            obj.DifferentialUpdates = params.differentialUpdates;
+            obj.resetDeltaStats;
 			
             % Check if we're simulating
             if (params.simulate)
@@ -96,11 +161,18 @@ classdef OneLight < hgsetget
                 obj.PlotWhenSimulating = params.plotWhenSimulating;
                 obj.DeviceID = params.deviceID;
                 obj.LampCurrent = 240;
-                obj.NumPatternBuffers = 4;
+                obj.NumPatternBuffers = params.simNumPatternBuffers;
+                obj.SimBufferStarts = cell(1, obj.NumPatternBuffers);
+                obj.SimBufferStops = cell(1, obj.NumPatternBuffers);
                 obj.InputPatternBuffer = 0;
                 obj.OutputPatternBuffer = 0;
                 obj.NumRows = 768;
                 obj.NumCols = 1024;
+                obj.SimTransferLatencySecs = params.simTransferLatencySecs;
+                obj.SimBufferSwitchLatencySecs = params.simBufferSwitchLatencySecs;
+                obj.SimTriggerMode = params.simTriggerMode;
+                obj.SimTriggerDelaySecs = params.simTriggerDelaySecs;
+                obj.SimTraceFile = params.simTraceFile;
                 obj.open;
                 return;
             else
@@ -112,7 +184,7 @@ classdef OneLight < hgsetget
 			% error if no devices are connected so we catch it to make the
 			% error a bit more informative.
 			try
-				numDevices = OneLightEngine(OneLightFunctions.GetDeviceCount.UInt32);
+				numDevices = tracedEngine('GetDeviceCount', OneLightFunctions.GetDeviceCount.UInt32);
 			catch e
 				error('No devices detected, turn the OneLight device on or make sure the cable is connected.');
 			end
@@ -133,15 +205,15 @@ classdef OneLight < hgsetget
             obj.LampCurrent = 240;
 			
 			% Get the number of pattern buffers on the device.
-			obj.NumPatternBuffers = OneLightEngine(OneLightFunctions.GetMaxPatternBuffers.UInt32, obj.DeviceID);
+			obj.NumPatternBuffers = tracedEngine('GetMaxPatternBuffers', OneLightFunctions.GetMaxPatternBuffers.UInt32, obj.DeviceID);
 			
 			% Make pattern buffer 0 to be the starting input and output.
 			obj.InputPatternBuffer = 0;
 			obj.OutputPatternBuffer = 0;
 			
 			% Get the number of mirror rows and columns.
-			obj.NumRows = OneLightEngine(OneLightFunctions.GetNumRows.UInt32, obj.DeviceID);
-			obj.NumCols = OneLightEngine(OneLightFunctions.GetNumCols.UInt32, obj.DeviceID);
+			obj.NumRows = tracedEngine('GetNumRows', OneLightFunctions.GetNumRows.UInt32, obj.DeviceID);
+			obj.NumCols = tracedEngine('GetNumCols', OneLightFunctions.GetNumCols.UInt32, obj.DeviceID);
 		end
 		
 		open(obj)
@@ -149,6 +221,8 @@ classdef OneLight < hgsetget
 		shutdown(obj)
 		setMirrors(obj, starts, stops)
 		setAll(obj, allOn)
+		resetDeltaStats(obj)
+		[starts, stops] = getSimulatedPattern(obj, buffer)
 		%timingData = flickerBuffers(obj, bufferSettings, bufferPattern, flickerRate, duration)
 	end
 	
@@ -164,7 +238,7 @@ classdef OneLight < hgsetget
 		function value = get.InputTriggerStatus(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetInputTrgrStatus.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetInputTrgrStatus', OneLightFunctions.GetInputTrgrStatus.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -177,12 +251,12 @@ classdef OneLight < hgsetget
 		function value = get.InputTriggerMode(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetInputTrgrMode.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetInputTrgrMode', OneLightFunctions.GetInputTrgrMode.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
             else
-                value = 0;
+                value = obj.SimTriggerMode;
             end
 		end
 		
@@ -190,12 +264,12 @@ classdef OneLight < hgsetget
 		function value = get.OutputPatternBuffer(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetOutputPatternBuffer.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetOutputPatternBuffer', OneLightFunctions.GetOutputPatternBuffer.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
             else
-                value = 0;
+                value = obj.SimOutputBuffer;
             end
         end
         
@@ -207,15 +281,18 @@ classdef OneLight < hgsetget
                 value, obj.NumPatternBuffers);         
             if (~obj.Simulate)
                 if obj.IsOpen
-                    OneLightEngine(OneLightFunctions.SetOutputPatternBuffer.UInt32, obj.DeviceID, value);
+                    tracedEngine('SetOutputPatternBuffer', OneLightFunctions.SetOutputPatternBuffer.UInt32, obj.DeviceID, value);
                 end   
+            else
+                obj.simulateLatency(obj.SimBufferSwitchLatencySecs);
+                obj.SimOutputBuffer = value;
             end
         end
 		
 		% IsOpen
 		function value = get.IsOpen(obj)
             if (~obj.Simulate)
-                value = logical(OneLightEngine(OneLightFunctions.IsOpen.UInt32, obj.DeviceID));
+                value = logical(tracedEngine('IsOpen', OneLightFunctions.IsOpen.UInt32, obj.DeviceID));
             else
                 value = 1;
             end
@@ -225,7 +302,7 @@ classdef OneLight < hgsetget
         function value = get.InputTriggerDelay(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetInputTrgrDelay.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetInputTrgrDelay', OneLightFunctions.GetInputTrgrDelay.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -238,7 +315,7 @@ classdef OneLight < hgsetget
         function value = get.InputTriggerHold(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetInputTrgrHold.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetInputTrgrHold', OneLightFunctions.GetInputTrgrHold.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -253,7 +330,7 @@ classdef OneLight < hgsetget
                 'Input trigger hold value %d is out of the allowable range [0,16000000]', value);  
             if (~obj.Simulate)
                 if obj.IsOpen
-                    OneLightEngine(OneLightFunctions.SetInputTrgrHold.UInt32, obj.DeviceID, value);
+                    tracedEngine('SetInputTrgrHold', OneLightFunctions.SetInputTrgrHold.UInt32, obj.DeviceID, value);
                 end
             end
         end
@@ -265,7 +342,7 @@ classdef OneLight < hgsetget
 			% stored requested value.
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetLampCurrent.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetLampCurrent', OneLightFunctions.GetLampCurrent.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -281,7 +358,7 @@ classdef OneLight < hgsetget
                 'Lamp current value of %d is out the allowable range of [0,255].', value);
             if (~obj.Simulate)
                 if obj.IsOpen
-                    OneLightEngine(OneLightFunctions.SetLampCurrent.UInt32, obj.DeviceID, value);
+                    tracedEngine('SetLampCurrent', OneLightFunctions.SetLampCurrent.UInt32, obj.DeviceID, value);
                 end
             end
         end
@@ -302,7 +379,7 @@ classdef OneLight < hgsetget
             %   dmdLampStatusLostLamp = 8
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetLampStatus.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetLampStatus', OneLightFunctions.GetLampStatus.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -321,9 +398,9 @@ classdef OneLight < hgsetget
             %   dmdFan3 = 2
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value0 = OneLightEngine(OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 0);
-                    %value1 = OneLightEngine(OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 1);
-                    %value2 = OneLightEngine(OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 2);
+                    value0 = tracedEngine('GetFanSpeed', OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 0);
+                    %value1 = tracedEngine('GetFanSpeed', OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 1);
+                    %value2 = tracedEngine('GetFanSpeed', OneLightFunctions.GetFanSpeed.UInt32, obj.DeviceID, 2);
                     value = [value0];
                 else
                     value = [];
@@ -338,7 +415,7 @@ classdef OneLight < hgsetget
         function value = get.SerialNumber(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetSerialNumber.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetSerialNumber', OneLightFunctions.GetSerialNumber.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -354,7 +431,7 @@ classdef OneLight < hgsetget
             % stored requested value.
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetCurrentMonitor.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetCurrentMonitor', OneLightFunctions.GetCurrentMonitor.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -369,7 +446,7 @@ classdef OneLight < hgsetget
             % stored requested value.
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetVoltageMonitor.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetVoltageMonitor', OneLightFunctions.GetVoltageMonitor.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
@@ -382,12 +459,12 @@ classdef OneLight < hgsetget
 		function value = get.InputPatternBuffer(obj)
             if (~obj.Simulate)
                 if obj.IsOpen
-                    value = OneLightEngine(OneLightFunctions.GetInputPatternBuffer.UInt32, obj.DeviceID);
+                    value = tracedEngine('GetInputPatternBuffer', OneLightFunctions.GetInputPatternBuffer.UInt32, obj.DeviceID);
                 else
                     value = [];
                 end
             else
-                value = 0;
+                value = obj.SimInputBuffer;
             end
         end
         
@@ -399,9 +476,34 @@ classdef OneLight < hgsetget
             value, obj.NumPatternBuffers);
             if (~obj.Simulate)
                 if obj.IsOpen
-                    OneLightEngine(OneLightFunctions.SetInputPatternBuffer.UInt32, obj.DeviceID, value);
+                    tracedEngine('SetInputPatternBuffer', OneLightFunctions.SetInputPatternBuffer.UInt32, obj.DeviceID, value);
                 end
+            else
+                obj.SimInputBuffer = value;
             end
+            
+            % We don't know what is in the new buffer.
+            obj.LastStarts = [];
+            obj.LastStops = [];
+		end
+	end
+	
+	% Private methods used by the simulated device.
+	methods (Access = private)
+		simulatePatternReceived(obj, starts, stops)
+		
+		function simulateLatency(~, latencySecs)
+			% Sleep for most of the latency, and busy wait only for the
+			% last couple of milliseconds, which pause does not time
+			% accurately.
+			if (latencySecs > 0)
+				t = tic;
+				if (latencySecs > 0.002)
+					pause(latencySecs - 0.002);
+				end
+				while (toc(t) < latencySecs)
+				end
+			end
 		end
 	end
 end
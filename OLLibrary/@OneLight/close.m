@@ -11,10 +11,13 @@ function close(obj)
 % powered up again or the connection will fail.
 
 % 09/25/17 dhb  Respect new PlotWhenSimulating property.
+% 10/18/26      Close the simulated pattern trace.
+% 10/18/26      Trace the OneLightEngine calls.
+% 10/18/26      Forget the last pattern sent, so the next is sent in full.
 
 if (~obj.Simulate)
     if obj.IsOpen
-        OneLightEngine(OneLightFunctions.Close.UInt32, obj.DeviceID);
+        tracedEngine('Close', OneLightFunctions.Close.UInt32, obj.DeviceID);
     end
 else
     if (obj.PlotWhenSimulating)
@@ -23,4 +26,12 @@ else
         catch
         end
     end
+    if (obj.SimTraceFid >= 0)
+        fclose(obj.SimTraceFid);
+        obj.SimTraceFid = -1;
+    end
 end
+
+% The device does not hold the last pattern sent by setMirrors any more.
+obj.LastStarts = [];
+obj.LastStops = [];
@@ -9,9 +9,10 @@ function closeAll
 % computer.  This will throw an error if no devices are detected.
 
 % 09/25/17 dhb  Respect new PlotWhenSimulating property.
+% 10/18/26      Trace the OneLightEngine calls.
 
 if (~obj.Simulate)
-    OneLightEngine(OneLightFunctions.CloseAll.UInt32);
+    tracedEngine('CloseAll', OneLightFunctions.CloseAll.UInt32);
 else
     if (obj.PlotWhenSimulating)
         try
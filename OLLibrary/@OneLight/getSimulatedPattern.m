@@ -0,0 +1,30 @@
+function [starts, stops] = getSimulatedPattern(obj, buffer)
+% getSimulatedPattern - Get the pattern held in a simulated pattern buffer.
+%
+% Syntax:
+% [starts, stops] = obj.getSimulatedPattern
+% [starts, stops] = obj.getSimulatedPattern(buffer)
+%
+% Description:
+% Only available in simulation mode.  Returns the starts and stops last
+% received by the given pattern buffer, so that code driving the device can
+% check what the device would be showing.  Both are empty if nothing has
+% been sent to that buffer.
+%
+% Input:
+% buffer (scalar) - Pattern buffer, 0 based.  Defaults to the output
+%                   pattern buffer.
+
+% 10/18/26  Wrote it.
+
+assert(obj.Simulate, 'OneLight:getSimulatedPattern:NotSimulating', ...
+    'Patterns can only be read back from a simulated device.');
+if (nargin < 2)
+    buffer = obj.SimOutputBuffer;
+end
+assert(buffer >= 0 && buffer < obj.NumPatternBuffers, ...
+    'OneLight:getSimulatedPattern:InvalidBuffer', ...
+    'Buffer %d is invalid.  Valid range is [0,%d].', buffer, obj.NumPatternBuffers-1);
+
+starts = obj.SimBufferStarts{buffer+1};
+stops = obj.SimBufferStops{buffer+1};
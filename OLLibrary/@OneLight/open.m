@@ -12,14 +12,44 @@ function open(obj)
 % max of 255.
 
 % 09/25/17 dhb  Respect new PlotWhenSimulating property.
+% 10/18/26      Start the simulated device clock and trace file.
+% 10/18/26      Append to the trace when opened again.
+% 10/18/26      Trace the OneLightEngine calls.
+% 10/18/26      Forget the last pattern sent, so the next is sent in full.
 
 % Don't try to re-open a connection, and simulate if simulating.
 if (~obj.Simulate)
     if ~obj.IsOpen
-        OneLightEngine(OneLightFunctions.Open.UInt32, obj.DeviceID);
+        tracedEngine('Open', OneLightFunctions.Open.UInt32, obj.DeviceID);
     end
 else
     if (obj.PlotWhenSimulating)
         obj.SimFig = figure; clf;
     end
+    
+    % The first open starts the simulated device clock and a new trace,
+    % with its header: magic, version, then the device geometry needed
+    % to read the records back.  Opening again after a close goes on
+    % with the same clock, and appends to the trace.
+    isFirstOpen = isempty(obj.SimStartTime);
+    if (isFirstOpen)
+        obj.SimStartTime = tic;
+    end
+    if (~isempty(obj.SimTraceFile) && obj.SimTraceFid < 0)
+        if (isFirstOpen)
+            obj.SimTraceFid = fopen(obj.SimTraceFile, 'w', 'ieee-le');
+        else
+            obj.SimTraceFid = fopen(obj.SimTraceFile, 'a', 'ieee-le');
+        end
+        assert(obj.SimTraceFid >= 0, 'OneLight:open:SimTraceFile', ...
+            'Could not open simulated pattern trace file %s', obj.SimTraceFile);
+        if (isFirstOpen)
+            fwrite(obj.SimTraceFid, 'OLSIMTRC', 'char');
+            fwrite(obj.SimTraceFid, [1 obj.NumCols obj.NumRows obj.NumPatternBuffers], 'uint32');
+        end
+    end
 end
+
+% The device does not hold the last pattern sent by setMirrors any more.
+obj.LastStarts = [];
+obj.LastStops = [];
@@ -0,0 +1,25 @@
+function varargout = tracedEngine(functionName, functionCode, varargin)
+% tracedEngine - Calls OneLightEngine inside an OLTrace span.
+%
+% Syntax:
+% value = tracedEngine('GetNumRows', OneLightFunctions.GetNumRows.UInt32, obj.DeviceID)
+%
+% Description:
+% Every call the OneLight object makes to OneLightEngine goes through here,
+% so that a trace shows each call as a span named 'OneLightEngine:' followed
+% by functionName, the name of the OneLightFunctions member passed as
+% functionCode.  When tracing is off, this adds two cheap OLTrace calls.
+%
+% See also OLTrace.
+
+% 10/18/26      Wrote it.
+
+spanName = ['OneLightEngine:' functionName];
+OLTrace('begin', spanName);
+try
+    [varargout{1:nargout}] = OneLightEngine(functionCode, varargin{:});
+catch e
+    OLTrace('end', spanName);
+    rethrow(e);
+end
+OLTrace('end', spanName);
@@ -0,0 +1,25 @@
+function resetDeltaStats(obj)
+% resetDeltaStats - Clears the differential update statistics.
+%
+% Syntax:
+% obj.resetDeltaStats
+%
+% Description:
+% Zeros the counters in the DeltaStats property.  The record of the last
+% pattern sent is left alone, so the next call to setMirrors can still skip
+% unchanged columns.
+%
+% DeltaStats fields:
+% nPatterns        - Number of calls to setMirrors.
+% nPatternsSkipped - Number of patterns identical to the last one sent.
+% nChangedColumns  - Total number of columns that changed.
+% bytesFull        - Bytes that full uint16 starts/stops patterns would take.
+% bytesDelta       - Bytes a delta encoding of just the changed column
+%                    runs would take.  SendPattern only takes full
+%                    patterns, so this is not what is sent.
+% bytesSaved       - Bytes not sent, those of the skipped patterns.
+%
+% See also OLDeltaEncodeStartsStops.
+
+obj.DeltaStats = struct('nPatterns', 0, 'nPatternsSkipped', 0, 'nChangedColumns', 0, ...
+    'bytesFull', 0, 'bytesDelta', 0, 'bytesSaved', 0);
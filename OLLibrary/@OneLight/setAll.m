@@ -10,11 +10,21 @@ function setAll(obj, allOn)
 % Input:
 % allOn (logical) - True = all on, false = all off.
 
+% 10/18/26      Trace the OneLightEngine calls.
+
 narginchk(2, 2);
 
 % Validate the input.
 assert(isscalar(allOn), 'OneLight:setAll:InvalidInput', 'Input must be a logical scalar.');
 
 if (~obj.Simulate)
-    OneLightEngine(OneLightFunctions.SetAll.UInt32, obj.DeviceID, logical(allOn));
+    tracedEngine('SetAll', OneLightFunctions.SetAll.UInt32, obj.DeviceID, logical(allOn));
+elseif (allOn)
+    obj.simulatePatternReceived(zeros(1,obj.NumCols), (obj.NumRows-1)*ones(1,obj.NumCols));
+else
+    obj.simulatePatternReceived((obj.NumRows+1)*ones(1,obj.NumCols), zeros(1,obj.NumCols));
 end
+
+% The device no longer holds the last pattern sent by setMirrors.
+obj.LastStarts = [];
+obj.LastStops = [];
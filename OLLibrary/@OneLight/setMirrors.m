@@ -22,18 +22,37 @@ function setMirrors(obj, starts, stops)
 % To turn all the mirrors in a column off, set start to NumRows+1 and stops to 0.  Sigh.
 % This is inferred from the C++ source code for method setAll in OLEngine.cpp.
 %
+% If the object was created with 'differentialUpdates' true, the pattern is
+% compared with the last one sent to the input pattern buffer.  A pattern
+% identical to the last one is not sent at all, and in simulation only the
+% changed columns are redrawn.  The engine's SendPattern call only takes
+% full patterns, so a pattern with any change is sent in full to the
+% hardware, and the only bytes actually saved are those of skipped
+% patterns.  Counts of changed columns and bytes are accumulated in the
+% DeltaStats property (see resetDeltaStats); bytesDelta there is what a
+% delta encoding would need, not what is sent.
+%
+% A skipped pattern is not passed to the simulated device either, so it
+% does not appear in the simulated pattern trace (see
+% OLReadSimulatedPatternTrace).
+%
 % Input:
 % starts (1xNumCols) - Vector defining the start row for each column.
 % stops (1xNumCols) - Vector defining the stop row for each column.
 % 
-% See also OLSettingsToStartsStops.
+% See also OLSettingsToStartsStops, OLChangedColumnRanges.
 
 % 01/17/14  dhb, ms  Comment tuning.
 % 09/25/17  dhb      Add option not to plot when simulating, based on object property
 %                    PlotWhenSimulating.
-% 
+% 10/18/26           Differential updates.
+% 10/18/26           Pass pattern to the simulated device model.
+% 10/18/26           Trace the time spent here.
+% 10/18/26           Remember the last pattern only after it was sent.
+% 10/18/26           Count only skipped patterns as bytes saved.
 
 assert(nargin == 3, 'OneLight:setMirrors:NumInputs', 'Invalid number of inputs.');
+span = OLTraceSpan('OneLight:setMirrors'); %#ok<NASGU>
 
 % Validate the start/stop vector lengths.
 assert(length(starts) == obj.NumCols, 'OneLight:setMirrors:OutOfBounds', ...
@@ -41,20 +60,60 @@ assert(length(starts) == obj.NumCols, 'OneLight:setMirrors:OutOfBounds', ...
 assert(length(stops) == obj.NumCols, 'OneLight:setMirrors:OutOfBounds', ...
 	'Length of "stops" must be %d', obj.NumCols);
 
+% Work out what changed since the last pattern.
+if (obj.DifferentialUpdates)
+    ranges = OLChangedColumnRanges(obj.LastStarts, obj.LastStops, starts, stops);
+    nChangedColumns = sum(ranges(:,2)-ranges(:,1)+1);
+    bytesFull = 2*2*obj.NumCols;
+    bytesDelta = 2*2*(nChangedColumns + size(ranges,1));
+    obj.DeltaStats.nPatterns = obj.DeltaStats.nPatterns + 1;
+    obj.DeltaStats.nChangedColumns = obj.DeltaStats.nChangedColumns + nChangedColumns;
+    obj.DeltaStats.bytesFull = obj.DeltaStats.bytesFull + bytesFull;
+    obj.DeltaStats.bytesDelta = obj.DeltaStats.bytesDelta + bytesDelta;
+    if isempty(ranges)
+        obj.DeltaStats.nPatternsSkipped = obj.DeltaStats.nPatternsSkipped + 1;
+        obj.DeltaStats.bytesSaved = obj.DeltaStats.bytesSaved + bytesFull;
+        return;
+    end
+else
+    ranges = [1 obj.NumCols];
+end
+
 % All starts and stops have to be converted to unsigned 16-bit integers.
 if (~obj.Simulate)
-    OneLightEngine(OneLightFunctions.SendPattern.UInt32, obj.DeviceID, uint16(starts), uint16(stops));
+    tracedEngine('SendPattern', OneLightFunctions.SendPattern.UInt32, obj.DeviceID, uint16(starts), uint16(stops));
 else
+    obj.simulatePatternReceived(starts, stops);
     if (obj.PlotWhenSimulating)
         if ~isvalid(obj.SimFig)
             obj.SimFig = figure();
         end
-        figure(obj.SimFig); clf;
-        hold on;
-        plot(stops-starts,'ko','MarkerSize',2);
-        ylim([-1000 1000]);
-        drawnow;
-        hold off;
+        
+        % When only part of the pattern changed and we've already got the
+        % plot up, just update the changed points.
+        if (obj.DifferentialUpdates && ~isempty(obj.SimLine) && isvalid(obj.SimLine))
+            yData = get(obj.SimLine,'YData');
+            for r = 1:size(ranges,1)
+                cols = ranges(r,1):ranges(r,2);
+                yData(cols) = stops(cols)-starts(cols);
+            end
+            set(obj.SimLine,'YData',yData);
+            drawnow;
+        else
+            figure(obj.SimFig); clf;
+            hold on;
+            obj.SimLine = plot(stops-starts,'ko','MarkerSize',2);
+            ylim([-1000 1000]);
+            drawnow;
+            hold off;
+        end
     end
 end
-    
\ No newline at end of file
+
+% Remember the pattern only once the device has it, so a failed send is
+% not taken for the device's state.
+if (obj.DifferentialUpdates)
+    obj.LastStarts = starts;
+    obj.LastStops = stops;
+end
+
@@ -8,8 +8,15 @@ function shutdown(obj)
 % Shuts down the device.  Should be called prior to physically turning it
 % off.
 
+% 10/18/26      Trace the OneLightEngine calls.
+% 10/18/26      Forget the last pattern sent, so the next is sent in full.
+
 if (~obj.Simulate)
     if obj.IsOpen
-        OneLightEngine(OneLightFunctions.Shutdown.UInt32, obj.DeviceID);
+        tracedEngine('Shutdown', OneLightFunctions.Shutdown.UInt32, obj.DeviceID);
     end
 end
+
+% The device does not hold the last pattern sent by setMirrors any more.
+obj.LastStarts = [];
+obj.LastStops = [];
@@ -0,0 +1,43 @@
+function simulatePatternReceived(obj, starts, stops)
+% simulatePatternReceived - Model the device receiving a pattern.
+%
+% Syntax:
+% obj.simulatePatternReceived(starts, stops)
+%
+% Description:
+% Used in simulation mode in place of the engine's SendPattern call.  Blocks
+% for the simulated transfer latency, stores the pattern in the current
+% input pattern buffer and, if a trace file was requested, appends a record
+% for the pattern to it.
+%
+% A pattern sent to the buffer that is being output is displayed as soon as
+% it arrives, or after the simulated trigger delay when the simulated trigger
+% mode is non-zero.  A pattern sent to any other buffer is not displayed, and
+% its display time is recorded as NaN.
+%
+% See also OLReadSimulatedPatternTrace.
+
+% 10/18/26  Wrote it.
+
+obj.simulateLatency(obj.SimTransferLatencySecs);
+receivedSecs = toc(obj.SimStartTime);
+
+obj.SimBufferStarts{obj.SimInputBuffer+1} = starts;
+obj.SimBufferStops{obj.SimInputBuffer+1} = stops;
+
+if (obj.SimTraceFid < 0)
+    return;
+end
+
+if (obj.SimInputBuffer ~= obj.SimOutputBuffer)
+    displaySecs = NaN;
+elseif (obj.SimTriggerMode ~= 0)
+    displaySecs = receivedSecs + obj.SimTriggerDelaySecs;
+else
+    displaySecs = receivedSecs;
+end
+
+fwrite(obj.SimTraceFid, [receivedSecs displaySecs], 'double');
+fwrite(obj.SimTraceFid, [obj.SimInputBuffer obj.SimOutputBuffer], 'uint8');
+fwrite(obj.SimTraceFid, starts, 'uint16');
+fwrite(obj.SimTraceFid, stops, 'uint16');
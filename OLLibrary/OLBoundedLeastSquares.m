@@ -0,0 +1,160 @@
+function [x, info] = OLBoundedLeastSquares(H, f, lb, ub, varargin)
+% Solve a box constrained least squares problem from its normal equations
+%
+% Syntax:
+%   x = OLBoundedLeastSquares(H, f, lb, ub)
+%   x = OLBoundedLeastSquares(H, f, lb, ub, 'initialX', x0)
+%   [x, info] = OLBoundedLeastSquares(...)
+%
+% Description:
+%    Find x that minimizes ||C*x - d||^2 subject to lb <= x <= ub, given
+%    H = C'*C and f = C'*d.  Working from H and f rather than C and d
+%    means that the expensive part of setting up the problem, which
+%    depends only on the calibration, can be done once and reused for
+%    many targets.  See OLSpdToPrimarySolver.
+%
+%    The method is the active set method of Stark and Parker (1995),
+%    "Bounded-variable least-squares: an algorithm and applications".
+%    Variables are either free or held at one of their bounds.  The
+%    problem restricted to the free variables is solved exactly; if that
+%    solution leaves the box, we step as far towards it as we can and hold
+%    the variables that hit a bound.  Once the free problem is solved
+%    within the box, the held variable whose gradient most strongly says
+%    it wants to move into the box is released, until no such variable is
+%    left.
+%
+%    For the problems we solve (~50 primaries), each step is a small dense
+%    solve and the whole search typically takes a few ms.  Passing the
+%    solution of a nearby problem as initialX usually starts the search
+%    with the right variables held, so that very few steps are needed.
+%
+%    H must be positive definite, which it is when C has full column rank
+%    or includes a smoothing penalty.
+%
+% Inputs:
+%    H            - NxN positive definite matrix, C'*C.
+%    f            - Nx1 vector, C'*d.
+%    lb           - Nx1 vector of lower bounds.
+%    ub           - Nx1 vector of upper bounds.
+%
+% Outputs:
+%    x            - Nx1 solution.
+%    info         - Struct with fields:
+%                     nIterations - Number of active set changes.
+%                     atLower     - Logical, variables held at lower bound.
+%                     atUpper     - Logical, variables held at upper bound.
+%                     converged   - True if optimality conditions were met
+%                                   within maxIterations.
+%
+% Optional key/value pairs:
+%    'initialX'      - Nx1 vector to start from. It is moved into the box
+%                      first. Default is the midpoint of the box.
+%    'tolerance'     - Scalar. Relative tolerance on the gradient used to
+%                      decide optimality. Default 1e-10.
+%    'maxIterations' - Scalar. Default 10*N.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLSpdToPrimarySolver, OLSpdToPrimary
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Compare with lsqlin on a random problem
+    C = rand(200,50); d = C*(2*rand(50,1)-0.5);
+    lb = zeros(50,1); ub = ones(50,1);
+    x = OLBoundedLeastSquares(C'*C, C'*d, lb, ub);
+    xlsqlin = lsqlin(C,d,[],[],[],[],lb,ub,[],optimset('Display','off'));
+    assert(max(abs(x-xlsqlin)) < 1e-5);
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('H',@isnumeric);
+parser.addRequired('f',@isnumeric);
+parser.addRequired('lb',@isnumeric);
+parser.addRequired('ub',@isnumeric);
+parser.addParameter('initialX',[],@isnumeric);
+parser.addParameter('tolerance',1e-10,@isscalar);
+parser.addParameter('maxIterations',[],@(x) isempty(x) || isscalar(x));
+parser.parse(H,f,lb,ub,varargin{:});
+
+n = numel(f);
+f = f(:); lb = lb(:); ub = ub(:);
+maxIterations = parser.Results.maxIterations;
+if (isempty(maxIterations))
+    maxIterations = 10*n;
+end
+gradientTolerance = parser.Results.tolerance * max(norm(f,Inf), norm(H,Inf)*max(norm([lb ; ub],Inf),1));
+
+%% Starting point and active set
+x = parser.Results.initialX;
+if (isempty(x))
+    x = (lb+ub)/2;
+end
+x = min(max(x(:),lb),ub);
+atLower = (x <= lb);
+atUpper = (x >= ub) & ~atLower;
+
+%% Search
+info.converged = false;
+nIterations = 0;
+while (nIterations < maxIterations)
+    % Solve for the free variables with the others held at their bounds,
+    % stepping back into the box whenever the solution leaves it.
+    while (true)
+        free = ~(atLower | atUpper);
+        if (~any(free))
+            break;
+        end
+        z = x;
+        z(free) = H(free,free) \ (f(free) - H(free,~free)*x(~free));
+        outside = free & ((z < lb) | (z > ub));
+        if (~any(outside))
+            x = z;
+            break;
+        end
+
+        % Step as far towards z as we can and hold whatever hits a bound.
+        % The variables that leave the box first are the ones that hit.
+        step = z - x;
+        belowBox = outside & (z < lb);
+        aboveBox = outside & (z > ub);
+        alpha = inf(n,1);
+        alpha(belowBox) = (lb(belowBox) - x(belowBox))./step(belowBox);
+        alpha(aboveBox) = (ub(aboveBox) - x(aboveBox))./step(aboveBox);
+        alphaMin = min(max(min(alpha),0),1);
+        hit = outside & (alpha <= alphaMin + 1e-12);
+        x = x + alphaMin*step;
+        x(hit & belowBox) = lb(hit & belowBox);
+        x(hit & aboveBox) = ub(hit & aboveBox);
+        atLower = atLower | (hit & belowBox);
+        atUpper = atUpper | (hit & aboveBox);
+        nIterations = nIterations + 1;
+    end
+
+    % Check optimality for held variables.  A variable at its lower bound
+    % wants to move in if the gradient of the error is negative there, and
+    % one at its upper bound if it is positive.
+    gradient = H*x - f;
+    violation = zeros(n,1);
+    violation(atLower) = -gradient(atLower);
+    violation(atUpper) = gradient(atUpper);
+    [worstViolation,release] = max(violation);
+    if (worstViolation <= gradientTolerance)
+        info.converged = true;
+        break;
+    end
+    atLower(release) = false;
+    atUpper(release) = false;
+    nIterations = nIterations + 1;
+end
+
+info.nIterations = nIterations;
+info.atLower = atLower;
+info.atUpper = atUpper;
+
+end
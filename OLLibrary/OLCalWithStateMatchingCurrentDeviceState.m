@@ -3,6 +3,10 @@ function cal = OLCalWithStateMatchingCurrentDeviceState(cal0, referenceFullONSPD
 % Syntax:
 % cal = OLCalWithStateMatchingCurrentDeviceState(cal0, referenceFullONSPD, referenceCombSPD);
 %
+% To start from the calibration whose state is closest to the current one,
+% find it with OLFindCalibrations(..., 'MatchState', {referenceFullONSPD, referenceCombSPD, S}),
+% which does not open any calibration files.
+%
 % 8/23/16  npc      Wrote it.
 %
 
@@ -0,0 +1,38 @@
+function summary = OLCalibrationStateSummary(fullOnSPD, combSPD, S)
+% Summarize the OneLight state of a pair of state tracking measurements
+%
+% Syntax:
+%   summary = OLCalibrationStateSummary(fullOnSPD, combSPD, S)
+%
+% Description:
+%    Two numbers that place a power fluctuation (full on) SPD and a
+%    spectral shift (comb) SPD, so that calibrations can be compared with
+%    each other and with the current state of the device without their
+%    spectra: the total power of the full on SPD, and the centroid of the
+%    comb SPD.  The index of calibrations keeps the summary of the first
+%    state measurements of each calibration, which are the ones
+%    OLCalWithStateMatchingCurrentDeviceState adjusts from.
+%
+%    Summaries are compared by stateDistance = |log(power ratio)|/0.01 +
+%    |centroid difference|/0.1 nm, so that a 1% change in power counts the
+%    same as a 0.1 nm spectral shift.
+%
+% Inputs:
+%    fullOnSPD  - Full on SPD, as in cal.raw.powerFluctuationMeas.measSpd.
+%    combSPD    - Comb SPD, as in cal.raw.spectralShiftsMeas.measSpd.
+%    S          - Wavelength sampling of the SPDs.
+%
+% Outputs:
+%    summary    - Struct with fields fullOnPower and combCentroid (nm).
+%
+% See also:
+%    OLFindCalibrations, OLCalWithStateMatchingCurrentDeviceState
+
+% History:
+%    10/18/26      Wrote it.
+
+wls = SToWls(S);
+summary.fullOnPower = sum(fullOnSPD(:));
+summary.combCentroid = sum(wls(:) .* combSPD(:)) / sum(combSPD(:));
+
+end
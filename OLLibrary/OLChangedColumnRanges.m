@@ -0,0 +1,62 @@
+function ranges = OLChangedColumnRanges(prevStarts, prevStops, starts, stops)
+% Find the runs of mirror columns whose starts/stops differ between frames
+%
+% Syntax:
+%   ranges = OLChangedColumnRanges(prevStarts, prevStops, starts, stops)
+%
+% Description:
+%    Compare a starts/stops pattern with a previous one and return the
+%    contiguous runs of columns in which either the start or the stop
+%    value changed.  This is the information needed to send or record only
+%    the part of a pattern that differs from what is already in the
+%    device.
+%
+%    If the previous pattern is empty, the whole pattern is treated as
+%    changed.
+%
+% Inputs:
+%    prevStarts - 1xnCols vector. Previously sent starts, or [].
+%    prevStops  - 1xnCols vector. Previously sent stops, or [].
+%    starts     - 1xnCols vector. New starts.
+%    stops      - 1xnCols vector. New stops.
+%
+% Outputs:
+%    ranges     - Kx2 matrix. Each row gives the first and last column
+%                 (1-based, inclusive) of a run of changed columns.  Empty
+%                 (0x2) if nothing changed.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLDeltaEncodeStartsStops, OneLight.setMirrors
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    prevStarts = zeros(1,8); prevStops = 10*ones(1,8);
+    starts = prevStarts; stops = prevStops;
+    stops([2 3 7]) = 11;
+    ranges = OLChangedColumnRanges(prevStarts,prevStops,starts,stops);
+    assert(isequal(ranges,[2 3 ; 7 7]));
+%}
+
+nCols = numel(starts);
+if (isempty(prevStarts) || isempty(prevStops))
+    ranges = [1 nCols];
+    return;
+end
+assert(numel(prevStarts) == nCols && numel(prevStops) == nCols && numel(stops) == nCols, ...
+    'OneLightToolbox:OLChangedColumnRanges:SizeMismatch', ...
+    'Previous and new starts/stops must all have the same length');
+
+%% Find edges of runs of changed columns
+changed = (starts(:) ~= prevStarts(:)) | (stops(:) ~= prevStops(:));
+edges = diff([false ; changed ; false]);
+ranges = [find(edges == 1) find(edges == -1)-1];
+
+end
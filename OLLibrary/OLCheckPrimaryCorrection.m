@@ -25,6 +25,7 @@ function OLCheckPrimaryCorrection(correctionDebuggingData, calibration, receptor
 
 % 06/18/17  dhb  Update header comment.  Rename.
 % 09/01/17  mab  Start generalizing by having it read protocol params.
+% 10/18/26       Redo deltas with OLCorrectionEngine when that was used.
 
 %% Start afresh with figures
 close all;
@@ -73,6 +74,11 @@ targetSPD = correctionDebuggingData.targetSPD;
 SPDMeasuredAll = [];
 primaryUsedAll = [];
 
+useCorrectionEngine = isfield(correctionDebuggingData,'useCorrectionEngine') && correctionDebuggingData.useCorrectionEngine;
+if (useCorrectionEngine)
+    engine = OLCorrectionEngine(calibration,'smoothness',correctionDebuggingData.smoothness);
+end
+
 for ii = 1:nIterationsMeasured
     % Pull out some data for convenience
     spectrumMeasuredScaled = lightlevelScalar*correctionDebuggingData.SPDMeasured(:,ii);
@@ -92,10 +98,15 @@ for ii = 1:nIterationsMeasured
     else
         learningRateThisIter = correctionDebuggingData.learningRate;
     end
-    deltaPrimaryAgain = OLLinearDeltaPrimaries(primaryUsed,spectrumMeasuredScaled,targetSPD,learningRateThisIter,correctionDebuggingData.smoothness,calibration);
-    if (correctionDebuggingData.iterativeSearch)
+    if (useCorrectionEngine)
         [deltaPrimaryAgain,nextSpectrumPredictedTruncatedLearningRateAgain] = ...
-            OLIterativeDeltaPrimaries(deltaPrimaryAgain,primaryUsed,spectrumMeasuredScaled,targetSPD,learningRateThisIter,calibration);
+            engine.deltaPrimaries(primaryUsed,spectrumMeasuredScaled,targetSPD,learningRateThisIter);
+    else
+        deltaPrimaryAgain = OLLinearDeltaPrimaries(primaryUsed,spectrumMeasuredScaled,targetSPD,learningRateThisIter,correctionDebuggingData.smoothness,calibration);
+        if (correctionDebuggingData.iterativeSearch)
+            [deltaPrimaryAgain,nextSpectrumPredictedTruncatedLearningRateAgain] = ...
+                OLIterativeDeltaPrimaries(deltaPrimaryAgain,primaryUsed,spectrumMeasuredScaled,targetSPD,learningRateThisIter,calibration);
+        end
     end
     nextSpectrumPredicted = OLPredictSpdFromDeltaPrimaries(deltaPrimaryAgain,primaryUsed,spectrumMeasuredScaled,calibration);
 
@@ -92,6 +92,7 @@ function [primary, inGamut, gamutMargin] = OLCheckPrimaryGamut(primary,varargin)
 %   04/12/18  dhb  Wrote it.
 %   12/19/18  jv   Extracted OLGamutMargins, OLCheckPrimaryValues,
 %                  OLTruncateGamutTolerance
+%   10/18/26       Truncate, check and get margins with OLGamutKernel.
 
 % Examples:
 
@@ -211,21 +212,16 @@ end
 % Headroom is effectively just shrinking the gamut
 gamutMinMax = gamutMinMax + p.Results.primaryHeadroom * [1 -1];
 
-%% Truncate primaries by gamut tolerance
-primary = OLTruncateGamutTolerance(primary,gamutMinMax,p.Results.primaryTolerance);
-
-%% Get gamut margins
-gamutMargins = OLGamutMargins(primary(:), gamutMinMax);
+%% Truncate primaries by gamut tolerance, check if in gamut, get margin
+[primary, inGamut, gamutMargins] = OLGamutKernel(primary,gamutMinMax,p.Results.primaryTolerance);
 gamutMargin = max(-gamutMargins);
 
-%% Check if in gamut, get margin
-inGamut = OLCheckPrimaryValues(primary(:), gamutMinMax);
-
 %% Error if necessary
 if (p.Results.checkPrimaryOutOfRange && ~inGamut)
     error('At least one primary values is out of gamut');
-else
-    % In this case, force primaries to be within gamut
+elseif (~inGamut)
+    % In this case, force primaries to be within gamut.  Primaries that
+    % are in gamut would be left alone, so only do this when needed.
     primary = OLTruncatePrimaryValues(primary,gamutMinMax);
 end
 
@@ -2,10 +2,23 @@
 %
 % Syntax:
 % [spectralShifts, refPeaks, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(theCurrentSPD, theReferenceSPD, combPeaks, spectralAxis)
+% [spectralShifts, refPeaks, fitParams, paramNames, referenceFitParams] = OLComputeSpectralShiftBetweenCombSPDs(..., 'referenceFitParams', referenceFitParams)
+%
+% The peaks are fit by OLFitTwoSidedExponentials, all at once.  The fits
+% of the current SPD start from the fits of the reference SPD, which are
+% returned as referenceFitParams.  When the same reference is used for
+% many measurements, pass them back in with the 'referenceFitParams' key
+% and the reference is not fit again.
 %
 % 8/22/16   npc     Wrote it.
+% 10/18/26          Fit all peaks at once, warm started from the reference fit.
 %
-function [spectralShifts, refPeaks, fitParams, paramNames] = OLComputeSpectralShiftBetweenCombSPDs(theCurrentSPD, theReferenceSPD, combPeaks, spectralAxis)
+function [spectralShifts, refPeaks, fitParams, paramNames, referenceFitParams] = OLComputeSpectralShiftBetweenCombSPDs(theCurrentSPD, theReferenceSPD, combPeaks, spectralAxis, varargin)
+    
+    parser = inputParser;
+    parser.addParameter('referenceFitParams', [], @isnumeric);
+    parser.parse(varargin{:});
+    referenceFitParams = parser.Results.referenceFitParams;
     
     paramNames = {...
         'offset (mWatts)', ...
@@ -15,8 +28,15 @@ function [spectralShifts, refPeaks, fitParams, paramNames] = OLComputeSpectralSh
         'right side sigma (nm)', ...
         'exponent'};
     
-    % Fit each of the combPeaks separately
-    for peakIndex = 1:numel(combPeaks)
+    % Select the data around each of the combPeaks
+    nPeaks = numel(combPeaks);
+    xData = cell(1, nPeaks);
+    dataIndices = cell(1, nPeaks);
+    refPeaks = zeros(1, nPeaks);
+    initialParams = zeros(nPeaks, 6);
+    paramLowerBounds = zeros(nPeaks, 6);
+    paramUpperBounds = zeros(nPeaks, 6);
+    for peakIndex = 1:nPeaks
         % nominal peak
         peak = combPeaks(peakIndex);
         
@@ -29,55 +49,26 @@ function [spectralShifts, refPeaks, fitParams, paramNames] = OLComputeSpectralSh
         % Select spectral region to fit
         dataIndicesToFit = sort(find(abs(spectralAxis - peak) <= 15));
         dataIndicesToFit = dataIndicesToFit(find(theReferenceSPD(dataIndicesToFit) > 0.1*maxComb));
+        dataIndices{peakIndex} = dataIndicesToFit;
+        xData{peakIndex} = spectralAxis(dataIndicesToFit);
         
-        xData = spectralAxis(dataIndicesToFit);
-        xDataHiRes = (xData(1):0.1:xData(end))';
-        
-        initialParams    = [0   5   peak     6.28   6.28  2.0];
-        paramLowerBounds = [0   0   peak-30  1.00   1.00  1.5]; 
-        paramUpperBounds = [0  100  peak+30 30.00  30.00  10.0];
-        
-        % Fit the reference SPD peak
-        spdData = 1000*theReferenceSPD(dataIndicesToFit);  % in milliWatts
-        fitParamsRef = fitGaussianToData(xData, spdData, initialParams, paramLowerBounds, paramUpperBounds);
-        refPeak(peakIndex) = fitParamsRef(3);
-        
-        % Fit the current SPD peak
-        spdData = 1000*theCurrentSPD(dataIndicesToFit);  % in milliWatts
-        fitParams(peakIndex,:) = fitGaussianToData(xData, spdData, initialParams, paramLowerBounds, paramUpperBounds);
-        currentPeak(peakIndex) = fitParams(peakIndex,3);
-        
-        spectralShifts(peakIndex) = currentPeak(peakIndex) - refPeak(peakIndex);
+        initialParams(peakIndex,:)    = [0   5   peak     6.28   6.28  2.0];
+        paramLowerBounds(peakIndex,:) = [0   0   peak-30  1.00   1.00  1.5]; 
+        paramUpperBounds(peakIndex,:) = [0  100  peak+30 30.00  30.00  10.0];
     end % peakIndex
-
-end
-
-function solution = fitGaussianToData(xData, yData, initialParams, paramLowerBounds, paramUpperBounds)
-    Aeq = [];
-    beq = [];
-    A = [];
-    b = [];
-    nonlcon = [];
-    options = optimoptions('fmincon');
-    options = optimset('Display', 'off');
-    solution = fmincon(@functionToMinimize, initialParams,A, b,Aeq,beq, paramLowerBounds, paramUpperBounds, nonlcon, options);
     
-    function rmsResidual = functionToMinimize(params)
-        yfit = twoSidedExponential(xData, params);
-        rmsResidual  = sum((yfit - yData) .^2);
+    % Fit the reference SPD peaks, unless we were given the fits
+    if (isempty(referenceFitParams))
+        spdData = cellfun(@(indices) 1000*theReferenceSPD(indices), dataIndices, 'UniformOutput', false);  % in milliWatts
+        referenceFitParams = OLFitTwoSidedExponentials(xData, spdData, initialParams, paramLowerBounds, paramUpperBounds);
     end
-end
+    refPeak = referenceFitParams(:,3)';
+    
+    % Fit the current SPD peaks, starting from the reference fits
+    spdData = cellfun(@(indices) 1000*theCurrentSPD(indices), dataIndices, 'UniformOutput', false);  % in milliWatts
+    fitParams = OLFitTwoSidedExponentials(xData, spdData, referenceFitParams, paramLowerBounds, paramUpperBounds);
+    currentPeak = fitParams(:,3)';
+    
+    spectralShifts = currentPeak - refPeak;
 
-function g = twoSidedExponential(wavelength, params)
-    offset = params(1);
-    gain = params(2);
-    peakWavelength = params(3);
-    leftSigmaWavelength = params(4);
-    rightSigmaWavelength = params(5);
-    exponent = params(6);
-    leftIndices = find(wavelength < peakWavelength);
-    rightIndices = find(wavelength >= peakWavelength);
-    g1 = offset + gain*exp(-0.5*(abs((wavelength(leftIndices)-peakWavelength)/leftSigmaWavelength)).^exponent);    
-    g2 = offset + gain*exp(-0.5*(abs((wavelength(rightIndices)-peakWavelength)/rightSigmaWavelength)).^exponent);
-    g = cat(1, g1, g2);
-end
\ No newline at end of file
+end
@@ -57,13 +57,27 @@ function [correctedPrimaryValues, measuredSPD, detailedData] = OLCorrectToSPD(ta
 %                                 Default .001.
 %    'iterativeSearch'          - Do iterative search with fmincon on each
 %                                 measurement interation? Default is true.
+%                                 Ignored when 'useCorrectionEngine' is
+%                                 true, since the engine solves the
+%                                 bounded problem exactly.
+%    'useCorrectionEngine'      - Find the primaries for each iteration
+%                                 with an OLCorrectionEngine, which sets
+%                                 up the problem once and warm starts
+%                                 each solve from the previous one,
+%                                 instead of OLLinearDeltaPrimaries
+%                                 followed by OLIterativeDeltaPrimaries.
+%                                 Default is false.
+%    'deltaPrimaryTolerance'    - Stop iterating once no primary changes
+%                                 by more than this. Default is 0, which
+%                                 always runs nIterations iterations.
 %    'temperatureProbe'         - LJTemperatureProbe object to drive a
 %                                 LabJack temperature probe. Default empty.
 %    'measureStateTrackingSPDs' - Make state tracking measurements?
 %                                 Default false.
 %
 % See also:
-%    OLValidatePrimaryValues, OLLinearDeltaPrimaries, OLIterativeDeltaPrimaries
+%    OLValidatePrimaryValues, OLLinearDeltaPrimaries, OLIterativeDeltaPrimaries,
+%    OLCorrectionEngine
 %
 
 % History:
@@ -73,6 +87,7 @@ function [correctedPrimaryValues, measuredSPD, detailedData] = OLCorrectToSPD(ta
 %    06/30/18  npc  implemented state tracking SPD recording
 %    08/16/18  jv   OLCorrectToSPD
 %    08/28/18  jv   pass lightelevelScalar as optional keyword argument.
+%    10/18/26       optional OLCorrectionEngine; optional early stop.
 
 % Examples:
 %{
@@ -102,6 +117,8 @@ parser.addParameter('learningRateDecrease',true,@islogical);
 parser.addParameter('asympLearningRateFactor',0.5,@(x)validateattributes(x,{'numeric'},{'scalar','real','finite','positive'}));
 parser.addParameter('smoothness', 0.001, @(x)validateattributes(x,{'numeric'},{'scalar','real','finite','nonnegative'}));
 parser.addParameter('iterativeSearch',true, @islogical);
+parser.addParameter('useCorrectionEngine',false, @islogical);
+parser.addParameter('deltaPrimaryTolerance', 0, @(x)validateattributes(x,{'numeric'},{'scalar','real','finite','nonnegative'}));
 parser.addParameter('temperatureProbe',[],@(x) isempty(x) || isa(x,'LJTemperatureProbe'));
 parser.addParameter('measureStateTrackingSPDs', false, @islogical);
 parser.KeepUnmatched = true;
@@ -115,6 +132,7 @@ smoothness = parser.Results.smoothness;
 iterativeSearch = parser.Results.iterativeSearch;
 temperatureProbe = parser.Results.temperatureProbe;
 lightlevelScalar = parser.Results.lightlevelScalar;
+useCorrectionEngine = parser.Results.useCorrectionEngine;
 
 %% Measure state-tracking SPDs
 stateTrackingData = struct();
@@ -140,9 +158,14 @@ if (parser.Results.measureStateTrackingSPDs)
 end
 
 %% Find initial primary values
-initialPrimaryValues = OLSpdToPrimary(calibration, targetSPD, ...
-    'primaryHeadroom',0,...
-    'lambda',parser.Results.smoothness);
+if useCorrectionEngine
+    engine = OLCorrectionEngine(calibration,'smoothness',smoothness);
+    initialPrimaryValues = engine.initialPrimaries(targetSPD);
+else
+    initialPrimaryValues = OLSpdToPrimary(calibration, targetSPD, ...
+        'primaryHeadroom',0,...
+        'lambda',parser.Results.smoothness);
+end
 
 %% Correct
 temperaturesForAllIterations = cell(1, nIterations);
@@ -166,14 +189,20 @@ for iter = 1:nIterations
         learningRateThisIter = learningRate;
     end
     
-    % Find delta primaries using small signal linear methods.
-    deltaPrimary = OLLinearDeltaPrimaries(primariesThisIter,lightlevelScalar*measuredSPD,targetSPD,learningRateThisIter,smoothness,calibration);
-    
-    % Optionally use fmincon to improve the truncated learning
-    % rate delta primaries by iterative search.
-    if iterativeSearch
-        deltaPrimary = OLIterativeDeltaPrimaries(deltaPrimary,primariesThisIter,lightlevelScalar*measuredSPD,targetSPD,learningRateThisIter,calibration);
+    if useCorrectionEngine
+        % Bounded solve, warm started from this iteration's primaries
+        deltaPrimary = engine.deltaPrimaries(primariesThisIter,lightlevelScalar*measuredSPD,targetSPD,learningRateThisIter);
+    else
+        % Find delta primaries using small signal linear methods.
+        deltaPrimary = OLLinearDeltaPrimaries(primariesThisIter,lightlevelScalar*measuredSPD,targetSPD,learningRateThisIter,smoothness,calibration);
+
+        % Optionally use fmincon to improve the truncated learning
+        % rate delta primaries by iterative search.
+        if iterativeSearch
+            deltaPrimary = OLIterativeDeltaPrimaries(deltaPrimary,primariesThisIter,lightlevelScalar*measuredSPD,targetSPD,learningRateThisIter,calibration);
+        end
     end
+    converged = max(abs(deltaPrimary)) < parser.Results.deltaPrimaryTolerance;
     
     % Compute and store the settings to use next time through
     nextPrimary = primariesThisIter + deltaPrimary;
@@ -184,6 +213,12 @@ for iter = 1:nIterations
     primaryUsed(:,iter) = primariesThisIter;
     deltaPrimary(:,iter) = deltaPrimary;
     nextPrimary(:,iter) = nextPrimary;
+
+    % Stop early if the primaries have stopped moving
+    if converged
+        temperaturesForAllIterations = temperaturesForAllIterations(1:iter);
+        break;
+    end
 end
 
 %% Store information about correction for return
@@ -201,6 +236,10 @@ detailedData.learningRateDecrease = learningRateDecrease;
 detailedData.asympLearningRateFactor = asympLearningRateFactor;
 detailedData.smoothness = smoothness;
 detailedData.iterativeSearch = iterativeSearch;
+detailedData.useCorrectionEngine = useCorrectionEngine;
+if useCorrectionEngine
+    detailedData.activeSetChanges = engine.NActiveSetChanges;
+end
 
 % Store target spectra and initial primaries used.  This information is
 % useful for debugging the seeking procedure.
@@ -0,0 +1,47 @@
+function [starts, stops] = OLDeltaDecodeStartsStops(deltas, nCols)
+% Rebuild full starts/stops matrices from a delta-encoded sequence
+%
+% Syntax:
+%   [starts, stops] = OLDeltaDecodeStartsStops(deltas, nCols)
+%
+% Description:
+%    Inverse of OLDeltaEncodeStartsStops.  Each frame starts as a copy of
+%    the previous one, and the changed column runs are written over it.
+%
+% Inputs:
+%    deltas - nFrames x 1 struct array, as returned by
+%             OLDeltaEncodeStartsStops.
+%    nCols  - Scalar. Number of mirror columns.
+%
+% Outputs:
+%    starts - nFrames x nCols matrix of starts.
+%    stops  - nFrames x nCols matrix of stops.
+%
+% Optional key/value pairs:
+%    None.
+%
+% See also:
+%    OLDeltaEncodeStartsStops
+
+% History:
+%    10/18/26      Wrote it.
+
+nFrames = numel(deltas);
+starts = zeros(nFrames,nCols);
+stops = zeros(nFrames,nCols);
+for k = 1:nFrames
+    if (k > 1)
+        starts(k,:) = starts(k-1,:);
+        stops(k,:) = stops(k-1,:);
+    end
+    nextCol = 1;
+    for r = 1:size(deltas(k).ranges,1)
+        cols = deltas(k).ranges(r,1):deltas(k).ranges(r,2);
+        n = numel(cols);
+        starts(k,cols) = deltas(k).starts(nextCol:nextCol+n-1);
+        stops(k,cols) = deltas(k).stops(nextCol:nextCol+n-1);
+        nextCol = nextCol + n;
+    end
+end
+
+end
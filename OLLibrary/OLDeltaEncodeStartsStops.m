@@ -0,0 +1,100 @@
+function [deltas, stats] = OLDeltaEncodeStartsStops(starts, stops)
+% Encode a starts/stops sequence as changes relative to the previous frame
+%
+% Syntax:
+%   deltas = OLDeltaEncodeStartsStops(starts, stops)
+%   [deltas, stats] = OLDeltaEncodeStartsStops(starts, stops)
+%
+% Description:
+%    Successive frames of a smooth modulation differ in only a few mirror
+%    columns.  This routine compares each frame with the one before it and
+%    keeps only the runs of columns that changed, along with their new
+%    starts and stops.  The first frame is always stored in full.
+%
+%    The byte counts in stats assume that starts and stops are sent as
+%    uint16, as setMirrors does, and that each changed run costs one
+%    uint16 pair for its first and last column.
+%
+%    Use OLDeltaDecodeStartsStops to get the full matrices back.
+%
+% Inputs:
+%    starts - nFrames x nCols matrix of starts, as returned by
+%             OLPrimaryToStartsStops.
+%    stops  - nFrames x nCols matrix of stops.
+%
+% Outputs:
+%    deltas - nFrames x 1 struct array with fields:
+%               ranges - Kx2 runs of changed columns, see
+%                        OLChangedColumnRanges.
+%               starts - 1xM starts for the changed columns, in column
+%                        order, where M is the number of changed columns.
+%               stops  - 1xM stops for the changed columns.
+%    stats  - Struct with fields nFrames, nCols, nUnchangedFrames,
+%             nChangedColumns, bytesFull, bytesDelta and bytesSaved.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLDeltaDecodeStartsStops, OLChangedColumnRanges
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    calibration = OLGetCalibrationStructure('CalibrationFolder',fileparts(which('OLDemoCal.mat')),'CalibrationType','DemoCal');
+    P = calibration.describe.numWavelengthBands;
+    timebase = linspace(0,1,200);
+    primaryWaveform = OLPrimaryWaveform(.5*ones(P,1), .5+.5*sin(2*pi*timebase));
+    [starts,stops] = OLPrimaryToStartsStops(primaryWaveform,calibration);
+    [deltas,stats] = OLDeltaEncodeStartsStops(starts,stops);
+    [starts2,stops2] = OLDeltaDecodeStartsStops(deltas,size(starts,2));
+    assert(isequal(starts,starts2) && isequal(stops,stops2));
+%}
+
+assert(isequal(size(starts),size(stops)), ...
+    'OneLightToolbox:OLDeltaEncodeStartsStops:SizeMismatch', ...
+    'starts and stops matrices must be the same size');
+[nFrames, nCols] = size(starts);
+
+%% Encode
+deltas = repmat(struct('ranges',zeros(0,2),'starts',[],'stops',[]),nFrames,1);
+nChangedColumns = 0;
+nRanges = 0;
+nUnchangedFrames = 0;
+for k = 1:nFrames
+    if (k == 1)
+        ranges = OLChangedColumnRanges([], [], starts(k,:), stops(k,:));
+    else
+        ranges = OLChangedColumnRanges(starts(k-1,:), stops(k-1,:), starts(k,:), stops(k,:));
+    end
+    cols = zeros(1,sum(ranges(:,2)-ranges(:,1)+1));
+    nextCol = 1;
+    for r = 1:size(ranges,1)
+        n = ranges(r,2)-ranges(r,1)+1;
+        cols(nextCol:nextCol+n-1) = ranges(r,1):ranges(r,2);
+        nextCol = nextCol + n;
+    end
+    deltas(k).ranges = ranges;
+    deltas(k).starts = starts(k,cols);
+    deltas(k).stops = stops(k,cols);
+
+    nChangedColumns = nChangedColumns + numel(cols);
+    nRanges = nRanges + size(ranges,1);
+    nUnchangedFrames = nUnchangedFrames + isempty(ranges);
+end
+
+%% Stats
+bytesPerValue = 2;
+stats.nFrames = nFrames;
+stats.nCols = nCols;
+stats.nUnchangedFrames = nUnchangedFrames;
+stats.nChangedColumns = nChangedColumns;
+stats.bytesFull = 2 * bytesPerValue * nFrames * nCols;
+stats.bytesDelta = 2 * bytesPerValue * (nChangedColumns + nRanges);
+stats.bytesSaved = stats.bytesFull - stats.bytesDelta;
+
+end
@@ -0,0 +1,151 @@
+function calEntries = OLFindCalibrations(varargin)
+% Find calibrations by type, date, box or state, without opening calibration files
+%
+% Syntax:
+%   calEntries = OLFindCalibrations('CalibrationType','BoxDLiquidShortCableDEyePiece1_ND04')
+%   calEntries = OLFindCalibrations('CalibrationType',calType,'CalibrationDate','latest')
+%   calEntries = OLFindCalibrations('Box','BoxD','CalibrationDate',[datenum(2018,1,1) now])
+%   calEntries = OLFindCalibrations('CalibrationType',calType,'MatchState',{fullOnSPD,combSPD,S})
+%
+% Description:
+%    Look up calibrations in the calibration index (see
+%    OLUpdateCalibrationIndex), which is brought up to date first.  That
+%    opens only calibration files that changed since they were indexed.
+%
+%    The entries of a calibration type, and of a date range within it, are
+%    found by binary search on the index keys, so the cost of a lookup
+%    grows with the log of the number of calibrations.  Filtering by box,
+%    or by date without a type, goes through the entries found.
+%
+%    With 'MatchState', the entries are sorted by how close the state of
+%    the OneLight when their first state measurements were taken is to the
+%    given state, closest first, measured as in OLCalibrationStateSummary.
+%    Entries without state measurements are dropped.
+%
+% Inputs:
+%    None.
+%
+% Outputs:
+%    calEntries          - Struct array of index entries, sorted by type
+%                          and then date, or by state distance.  Fields are
+%                          as described in OLUpdateCalibrationIndex, plus
+%                          stateDistance with 'MatchState'.  Use
+%                          calNumber to pick the calibration out of the
+%                          calibration file.
+%
+% Optional key/value pairs:
+%    'CalibrationFolder' - String. Folder of the calibration files.
+%                          Default '' uses getpref('OneLightToolbox', 'OneLightCalData').
+%    'CalibrationType'   - String. Only calibrations of this type.  Default
+%                          '' for all types.
+%    'CalibrationDate'   - Only calibrations with this date string, or with
+%                          a datenum in [from to], or 'latest' for the
+%                          latest of each type.  Default '' for all dates.
+%    'Box'               - String. Only calibrations of this box, e.g.
+%                          'BoxD'. Default '' for all boxes.
+%    'MatchState'        - Cell array {fullOnSPD, combSPD, S} of the state
+%                          to match, e.g. freshly measured with the power
+%                          fluctuation and spectral shift stimuli. Default
+%                          {} does not match.
+%    'WriteCacheFiles'   - Boolean. Let OLUpdateCalibrationIndex write the
+%                          index and calibration containers to the
+%                          calibration folder. Default true.
+%
+% See also:
+%    OLUpdateCalibrationIndex, OLGetCalibrationStructure,
+%    OLCalWithStateMatchingCurrentDeviceState
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      Added 'WriteCacheFiles'.
+
+%% Input validation
+parser = inputParser();
+parser.addParameter('CalibrationFolder','',@ischar);
+parser.addParameter('CalibrationType','',@ischar);
+parser.addParameter('CalibrationDate','',@(x) ischar(x) || (isnumeric(x) && numel(x) == 2));
+parser.addParameter('Box','',@ischar);
+parser.addParameter('MatchState',{},@(x) iscell(x) && (isempty(x) || numel(x) == 3));
+parser.addParameter('WriteCacheFiles',true,@islogical);
+parser.parse(varargin{:});
+params = parser.Results;
+
+if (isempty(params.CalibrationFolder))
+    calFolder = getpref('OneLightToolbox', 'OneLightCalData');
+else
+    calFolder = params.CalibrationFolder;
+end
+calibrationIndex = OLUpdateCalibrationIndex(calFolder,'WriteCacheFiles',params.WriteCacheFiles);
+keys = calibrationIndex.keys;
+
+%% Range of entries of the type, and of the dates within it
+dateRange = [-Inf Inf];
+if (isnumeric(params.CalibrationDate))
+    dateRange = params.CalibrationDate;
+elseif (~any(strcmp(params.CalibrationDate,{'','latest'})))
+    dateRange = datenum(params.CalibrationDate) + [0 0];
+end
+
+if (isempty(params.CalibrationType))
+    selected = 1:numel(calibrationIndex.entries);
+    dateNums = [calibrationIndex.entries.dateNum];
+    selected = selected(dateNums >= dateRange(1) & dateNums <= dateRange(2));
+else
+    typeRank = find(strcmp(calibrationIndex.calTypes,params.CalibrationType));
+    if (isempty(typeRank))
+        selected = [];
+    else
+        first = lowerBound(keys, typeRank*1e6 + max(dateRange(1),0));
+        last = lowerBound(keys, nextKey(typeRank*1e6 + min(dateRange(2),1e6-1))) - 1;
+        selected = first:last;
+    end
+end
+calEntries = calibrationIndex.entries(selected);
+
+%% The rest of the conditions
+if (~isempty(params.Box))
+    calEntries = calEntries(strcmp({calEntries.box},params.Box));
+end
+if (ischar(params.CalibrationDate) && ~any(strcmp(params.CalibrationDate,{'','latest'})))
+    % Same datenum, but also the same string
+    calEntries = calEntries(strcmp({calEntries.date},params.CalibrationDate));
+end
+if (strcmp(params.CalibrationDate,'latest') && ~isempty(calEntries))
+    % Entries are sorted by date within type, so the last of each type
+    isLast = [~strcmp({calEntries(1:end-1).calType},{calEntries(2:end).calType}) true];
+    calEntries = calEntries(isLast);
+end
+
+if (~isempty(params.MatchState))
+    summary = OLCalibrationStateSummary(params.MatchState{:});
+    calEntries = calEntries(~isnan([calEntries.fullOnPower]));
+    stateDistance = abs(log([calEntries.fullOnPower]/summary.fullOnPower))/0.01 + ...
+        abs([calEntries.combCentroid] - summary.combCentroid)/0.1;
+    [stateDistance, order] = sort(stateDistance);
+    calEntries = calEntries(order);
+    for k = 1:numel(calEntries)
+        calEntries(k).stateDistance = stateDistance(k);
+    end
+end
+
+end
+
+function k = lowerBound(keys, value)
+% Index of the first key that is not less than value, numel(keys)+1 if none
+lo = 1;
+hi = numel(keys) + 1;
+while (lo < hi)
+    mid = floor((lo + hi)/2);
+    if (keys(mid) < value)
+        lo = mid + 1;
+    else
+        hi = mid;
+    end
+end
+k = lo;
+end
+
+function key = nextKey(key)
+% Smallest key after key, so the upper end of a range is inclusive
+key = key + eps(key);
+end
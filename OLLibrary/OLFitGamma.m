@@ -1,11 +1,21 @@
-function [fit_out,x,fitComment] = OLFitGamma(values_in,measurements,values_out,fitType)
+function [fit_out,x,fitComment] = OLFitGamma(values_in,measurements,values_out,fitType,varargin)
 % [fit_out,x,fitComment] = OLFitGamma(values_in,measurements,values_out,fitType)
+% [fit_out,x,fitComment] = OLFitGamma(...,'fitMethod','fmincon')
 %
 % This is like PTB FitGamma with some restrictions for OneLight, plus some additional
 % fit options pulled out of CalibrateFitGamma. The PTB stuff has grown crufty over the
 % years and we are paying the price for that by having to port over something we
 % need in a hurry.
 %
+% measurements may have one column per band, and fit_out then has one
+% column per band too.  For the betacdf fit types all bands are fit
+% together: by default with a Levenberg-Marquardt search that evaluates
+% the model and its (finite difference) Jacobian for every band in one
+% vectorized call, so fitting all the bands of a calibration costs about
+% as much as fitting one.  x then has one row of parameters per band.
+% For the other fit types each band is passed to FitGamma in turn, and for
+% more than one band x is a cell array with one entry per band.
+%
 % fitType:
 %   Numeric values are passed through to PTB function FitGamma.
 %   String values:
@@ -16,11 +26,18 @@ function [fit_out,x,fitComment] = OLFitGamma(values_in,measurements,values_out,f
 %     'betacdfquad' - The input to the double betacdf is passed through a quadratic function
 %         with control points (0,0), (1,1), and and fit parameters (x,y).       
 %
+% Optional key/value pairs:
+%   'fitMethod' - How to fit the betacdf types. 'lm' (default) for the
+%                 batched Levenberg-Marquardt search, 'fmincon' for the
+%                 original fmincon search, one band at a time.
+%
 % 3/14/14  dhb, ms  Cobbled together.
+% 10/18/26          Fit all bands at once, with Levenberg-Marquardt by default.
 % 
-if (size(measurements,2) > 1)
-    error('Only know how to deal with one band at a time.  Sorry.');
-end
+p = inputParser;
+p.addParameter('fitMethod','lm',@(x) any(strcmp(x,{'lm','fmincon'})));
+p.parse(varargin{:});
+nBands = size(measurements,2);
 
 if (ischar(fitType))
     switch (fitType)
@@ -31,9 +48,12 @@ if (ischar(fitType))
             if (~exist('betacdf','file'))
                 error('Fitting with the betacdf requires the stats toolbox\n');
             end
-            mGammaMassaged = MakeGammaMonotonic(HalfRect(measurements));
+            mGammaMassaged = zeros(size(measurements));
+            for k = 1:nBands
+                mGammaMassaged(:,k) = MakeGammaMonotonic(HalfRect(measurements(:,k)));
+            end
                         
-            % Fmincon here we come    
+            % Starting point and bounds
             a = 1;
             b = 1;
             c = 1;
@@ -47,24 +67,128 @@ if (ischar(fitType))
             vub = [1e3 1e3 1e3 1e3 1e3 1e3 0.9 0.9];
             
             % Fit and predictions
-            options = optimset('fmincon');
-            options = optimset(options,'Diagnostics','off','Display','off','LargeScale','off','Algorithm','active-set');
-            x = fmincon(@(x)BetaCdfFun(x,fitType,values_in,mGammaMassaged),x0,[],[],[],[],vlb,vub,[],options);
-            fit_out = ComputeBetaCdf(x,fitType,values_out);
+            switch (p.Results.fitMethod)
+                case 'lm'
+                    x = BetaCdfLM(fitType,values_in,mGammaMassaged,x0,vlb,vub);
+                case 'fmincon'
+                    % Fmincon here we come
+                    options = optimset('fmincon');
+                    options = optimset(options,'Diagnostics','off','Display','off','LargeScale','off','Algorithm','active-set');
+                    x = zeros(nBands,numel(x0));
+                    for k = 1:nBands
+                        x(k,:) = fmincon(@(x)BetaCdfFun(x,fitType,values_in,mGammaMassaged(:,k)),x0,[],[],[],[],vlb,vub,[],options);
+                    end
+            end
+            fit_out = ComputeBetaCdf(x',fitType,values_out);
             fitComment = sprintf('% option of OLFitGamma',fitType);
             
         case 'linearinterpolation'
-            [fit_out,x,fitComment] = FitGamma(values_in,measurements,values_out,6);
+            [fit_out,x,fitComment] = FitGammaBands(values_in,measurements,values_out,6);
             
         otherwise
             error('Unknown gamma fit type passed');
     end
 else
+    [fit_out,x,fitComment] = FitGammaBands(values_in,measurements,values_out,fitType);
+end
+
+end
+
+function [fit_out,x,fitComment] = FitGammaBands(values_in,measurements,values_out,fitType)
+% Call PTB FitGamma for each band
+
+nBands = size(measurements,2);
+if (nBands == 1)
     [fit_out,x,fitComment] = FitGamma(values_in,measurements,values_out,fitType);
+    return;
+end
+fit_out = zeros(numel(values_out),nBands);
+x = cell(1,nBands);
+for k = 1:nBands
+    [fit_out(:,k),x{k},fitComment] = FitGamma(values_in,measurements(:,k),values_out,fitType);
 end
 
 end
 
+function x = BetaCdfLM(fitType,input,gamma,x0,vlb,vub)
+% Levenberg-Marquardt fit of the betacdf models to every band at once
+%
+% Minimizes the sum of squared error, which has the same minimizer as the
+% RMSE that BetaCdfFun returns.  Each band has its own damping and
+% stops on its own, but the model and the Jacobian are evaluated for all
+% bands still going in one call.  Steps are projected back into the
+% bounds.  Returns one row of parameters per band.
+
+maxIterations = 200;
+relativeTolerance = 1e-10;
+[nIn,nBands] = size(gamma);
+
+% The plain betacdf model doesn't use the last two parameters.
+if (strcmp(fitType,'betacdf'))
+    freeParams = 1:6;
+else
+    freeParams = 1:8;
+end
+nFree = numel(freeParams);
+vlb = vlb(:); vub = vub(:);
+
+x = repmat(x0(:),1,nBands);
+residual = ComputeBetaCdf(x,fitType,input) - gamma;
+cost = sum(residual.^2,1);
+mu = 1e-3*ones(1,nBands);
+going = true(1,nBands);
+for iteration = 1:maxIterations
+    bands = find(going);
+    if (isempty(bands))
+        break;
+    end
+    xNow = x(:,bands);
+    predNow = residual(:,bands) + gamma(:,bands);
+
+    % Forward difference Jacobian, stepping down instead at the upper bound
+    J = zeros(nIn,nFree,numel(bands));
+    for j = 1:nFree
+        k = freeParams(j);
+        step = 1e-7*max(1,abs(xNow(k,:)));
+        atTop = (xNow(k,:) + step > vub(k));
+        step(atTop) = -step(atTop);
+        xStep = xNow;
+        xStep(k,:) = xNow(k,:) + step;
+        J(:,j,:) = reshape(bsxfun(@rdivide,ComputeBetaCdf(xStep,fitType,input) - predNow,step),nIn,1,[]);
+    end
+
+    % Damped Gauss-Newton step for each band
+    xTrial = xNow;
+    for i = 1:numel(bands)
+        Ji = J(:,:,i);
+        A = Ji'*Ji;
+        dA = diag(A);
+        dA = max(dA,1e-12*max(max(dA),eps));
+        delta = -(A + mu(bands(i))*diag(dA)) \ (Ji'*residual(:,bands(i)));
+        xTrial(freeParams,i) = xNow(freeParams,i) + delta;
+    end
+    xTrial = bsxfun(@min,bsxfun(@max,xTrial,vlb),vub);
+
+    % Keep the steps that help, and adjust the damping
+    residualTrial = ComputeBetaCdf(xTrial,fitType,input) - gamma(:,bands);
+    costTrial = sum(residualTrial.^2,1);
+    better = (costTrial < cost(bands));
+    improved = bands(better);
+    converged = better & (cost(bands) - costTrial <= relativeTolerance*cost(bands));
+    x(:,improved) = xTrial(:,better);
+    residual(:,improved) = residualTrial(:,better);
+    cost(improved) = costTrial(better);
+    mu(improved) = max(mu(improved)/3,1e-12);
+    mu(bands(~better)) = mu(bands(~better))*4;
+
+    % Stop bands that have converged, or that can't find a better point
+    going(bands(converged)) = false;
+    going(mu > 1e10) = false;
+end
+x = x';
+
+end
+
 function f = BetaCdfFun(x,fitType,input,gamma)
 
 pred = ComputeBetaCdf(x,fitType,input);
@@ -74,14 +198,22 @@ f = sqrt(mean(diff.^2));
 end
 
 function pred = ComputeBetaCdf(x,fitType,input)
-a = x(1);
-b = x(2);
-c = x(3);
-d = x(4);
-e = x(5);
-f = x(6);
-g = x(7);
-h = x(8);
+% x has one column of parameters per band, or is a single parameter
+% vector.  pred has one column per band.
+if (isvector(x))
+    x = x(:);
+end
+nBands = size(x,2);
+input = repmat(input(:),1,nBands);
+nIn = size(input,1);
+a = repmat(x(1,:),nIn,1);
+b = repmat(x(2,:),nIn,1);
+c = repmat(x(3,:),nIn,1);
+d = repmat(x(4,:),nIn,1);
+e = repmat(x(5,:),nIn,1);
+f = repmat(x(6,:),nIn,1);
+g = repmat(x(7,:),nIn,1);
+h = repmat(x(8,:),nIn,1);
 
 switch (fitType)
     case 'betacdf'
@@ -98,7 +230,7 @@ switch (fitType)
         s = h.^g;
         x2 = x1.^g;
         x3 = x2./(x2+s);
-        pred = x3*(1+s);
+        pred = x3.*(1+s);
         
     case 'betacdfpiecelin'
         % Piecewise linear method
@@ -108,12 +240,12 @@ switch (fitType)
         % better in any case. 
         blurSize = 0;
         pred = zeros(size(input));
-        temp1 = (h/g)*input;
+        temp1 = (h./g).*input;
         temp1(temp1 < 0) = 0;
         temp1(temp1 > 1) = 1;
         pred1 = betacdf(betacdf(temp1.^f,a,b).^e,c,d);
         
-        temp2 = h+((1-h)/(1-g))*(input-g);
+        temp2 = h+((1-h)./(1-g)).*(input-g);
         temp2(temp2 < 0) = 0;
         temp2(temp2 > 1) = 1;
         pred2 = betacdf(betacdf(temp2.^f,a,b).^e,c,d);
@@ -134,9 +266,9 @@ switch (fitType)
         %
         % This provides a smooth version of the commentd out
         % piecewise linear method below.
-        a1 = (h/g - g)/(1-g);
+        a1 = (h./g - g)./(1-g);
         b1 = 1 - a1;
-        newinput = a1*input + b1*input.^2;
+        newinput = a1.*input + b1.*input.^2;
         newinput = abs(newinput);
         newinput(newinput < 0) = 0;
         newinput(newinput > 1) = 1;
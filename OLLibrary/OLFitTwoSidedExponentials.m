@@ -0,0 +1,177 @@
+function params = OLFitTwoSidedExponentials(xData, yData, initialParams, paramLowerBounds, paramUpperBounds)
+% Fit two sided exponentials to the peaks of a comb SPD
+%
+% Syntax:
+%   params = OLFitTwoSidedExponentials(xData, yData, initialParams, paramLowerBounds, paramUpperBounds)
+%
+% Description:
+%    Least squares fits of the 6 parameter two sided exponential
+%       offset + gain*exp(-0.5*(|x-peak|/sigma)^exponent)
+%    where sigma is the left sigma for x < peak and the right sigma
+%    otherwise, to the data of several peaks.  Each peak is fit on its own,
+%    within its own bounds.  A parameter whose lower and upper bounds are
+%    equal is held at that value.
+%
+%    The fits are done by a bounded Levenberg-Marquardt search with the
+%    analytic Jacobian of the model, which for these small problems takes
+%    a few iterations where fmincon took many function evaluations.  When
+%    the mex file OLTwoSidedExponentialFitMex has been compiled (see
+%    OLCompileMexfiles) all the peaks are fit in one call into C, otherwise
+%    the same search is run in MATLAB.
+%
+% Inputs:
+%    xData            - Cell array with one column vector of wavelengths
+%                       per peak, in increasing order.
+%    yData            - Cell array with the data to fit for each peak,
+%                       same sizes as xData.
+%    initialParams    - nPeaks x 6 starting parameters, in the order
+%                       offset, gain, peak, left sigma, right sigma,
+%                       exponent.  A single row is used for all peaks.
+%    paramLowerBounds - nPeaks x 6 (or 1 x 6) lower bounds.
+%    paramUpperBounds - nPeaks x 6 (or 1 x 6) upper bounds.
+%
+% Outputs:
+%    params           - nPeaks x 6 fitted parameters.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLComputeSpectralShiftBetweenCombSPDs, OLCompileMexfiles
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Recover a known peak
+    x = (500:1:530)';
+    truth = [0 40 515.3 5 7 2.2];
+    g = truth(1) + truth(2)*exp(-0.5*(abs(x-truth(3))./((x < truth(3))*truth(4) + (x >= truth(3))*truth(5))).^truth(6));
+    params = OLFitTwoSidedExponentials({x}, {g}, [0 5 515 6.28 6.28 2], [0 0 485 1 1 1.5], [0 100 545 30 30 10]);
+    assert(max(abs(params - truth)) < 1e-6);
+%}
+
+%% Is the mex file there?
+persistent haveMex;
+if (isempty(haveMex))
+    haveMex = (exist('OLTwoSidedExponentialFitMex','file') == 3);
+end
+
+%% One row of parameters and bounds per peak
+nPeaks = numel(xData);
+assert(numel(yData) == nPeaks, 'OneLightToolbox:OLFitTwoSidedExponentials:MismatchedSizes', ...
+    'There must be the same number of x and y data sets');
+initialParams = expandRows(initialParams, nPeaks);
+paramLowerBounds = expandRows(paramLowerBounds, nPeaks);
+paramUpperBounds = expandRows(paramUpperBounds, nPeaks);
+
+%% Fit
+if (haveMex)
+    x = cellfun(@(v) double(v(:)), xData(:), 'UniformOutput', false);
+    y = cellfun(@(v) double(v(:)), yData(:), 'UniformOutput', false);
+    segmentEnds = cumsum(cellfun(@numel, x));
+    params = OLTwoSidedExponentialFitMex(cat(1,x{:}), cat(1,y{:}), segmentEnds, ...
+        initialParams, paramLowerBounds, paramUpperBounds);
+else
+    params = zeros(nPeaks, 6);
+    for peakIndex = 1:nPeaks
+        params(peakIndex,:) = fitPeak(xData{peakIndex}(:), yData{peakIndex}(:), ...
+            initialParams(peakIndex,:), paramLowerBounds(peakIndex,:), paramUpperBounds(peakIndex,:));
+    end
+end
+
+end
+
+function m = expandRows(m, nPeaks)
+% Repeat a single row for all the peaks
+if (size(m,1) == 1)
+    m = repmat(m, nPeaks, 1);
+end
+assert(isequal(size(m), [nPeaks 6]), 'OneLightToolbox:OLFitTwoSidedExponentials:BadParams', ...
+    'Parameters and bounds must have 6 columns and one row per peak');
+m = double(m);
+end
+
+function p = fitPeak(x, y, p, lb, ub)
+% Bounded Levenberg-Marquardt fit of one peak.  This is the search that
+% OLTwoSidedExponentialFitMex does.
+
+maxIterations = 200;
+relativeTolerance = 1e-10;
+
+p = min(max(p, lb), ub);
+freeParams = find(lb < ub);
+if (isempty(freeParams) || isempty(x))
+    return;
+end
+
+cost = sum((twoSidedExponential(x, p) - y).^2);
+mu = 1e-3;
+for iteration = 1:maxIterations
+    [pred, J] = twoSidedExponential(x, p);
+    J = J(:,freeParams);
+    JtJ = J'*J;
+    Jtr = J'*(pred - y);
+    dA = diag(JtJ);
+    dA = max(dA, 1e-12*max(max(dA),eps));
+
+    % Increase the damping until a step lowers the error
+    improved = false;
+    while (~improved && mu <= 1e10)
+        [R, notPositiveDefinite] = chol(JtJ + mu*diag(dA));
+        if (notPositiveDefinite)
+            mu = mu*4;
+            continue;
+        end
+        trial = p;
+        trial(freeParams) = min(max(p(freeParams) - (R \ (R' \ Jtr))', lb(freeParams)), ub(freeParams));
+        trialCost = sum((twoSidedExponential(x, trial) - y).^2);
+        if (trialCost < cost)
+            converged = (cost - trialCost <= relativeTolerance*cost);
+            p = trial;
+            cost = trialCost;
+            mu = max(mu/3, 1e-12);
+            improved = true;
+            if (converged)
+                return;
+            end
+        else
+            mu = mu*4;
+        end
+    end
+    if (~improved)
+        return;
+    end
+end
+
+end
+
+function [g, J] = twoSidedExponential(wavelength, params)
+% The model, and its Jacobian with respect to the parameters
+offset = params(1);
+gain = params(2);
+peakWavelength = params(3);
+exponent = params(6);
+left = (wavelength < peakWavelength);
+sigma = params(5)*ones(size(wavelength));
+sigma(left) = params(4);
+d = wavelength - peakWavelength;
+u = abs(d)./sigma;
+ue = u.^exponent;
+E = exp(-0.5*ue);
+g = offset + gain*E;
+
+if (nargout > 1)
+    gE = gain*E;
+    dSigma = 0.5*gE*exponent.*ue./sigma;
+    dPeak = 0.5*gE*exponent.*(ue./u).*sign(d)./sigma;
+    dExponent = -0.5*gE.*ue.*log(u);
+    dPeak(u == 0) = 0;
+    dExponent(u == 0) = 0;
+    J = [ones(size(wavelength)) E dPeak dSigma.*left dSigma.*(~left) dExponent];
+end
+
+end
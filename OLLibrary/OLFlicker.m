@@ -1,8 +1,9 @@
-function keyPress = OLFlicker(ol, starts, stops, frameDurationSecs, numIterations)
+function [keyPress, timingData] = OLFlicker(ol, starts, stops, frameDurationSecs, numIterations)
 % OLFlicker - Flickers the OneLight.
 %
 % Syntax:
-%   keyPress = OLFlicker(ol, settings, frameDurationSecs, numIterations)
+%   keyPress = OLFlicker(ol, starts, stops, frameDurationSecs, numIterations)
+%   [keyPress, timingData] = OLFlicker(ol, starts, stops, frameDurationSecs, numIterations)
 %
 % Description:
 %   Flickers the OneLight using the passed settings matrix until the number
@@ -13,6 +14,11 @@ function keyPress = OLFlicker(ol, starts, stops, frameDurationSecs, numIteration
 %   ol -                         The OneLight object.
 %   starts (nSpectra x nCols) -  The starts matrix, with nCols being the number of columns on the OneLight;
 %   stops (nSpectra x nCols) -   The stops matrix.
+%                                Instead of starts and stops, an
+%                                OLModulationStream can be passed as starts
+%                                (and [] as stops).  Frames are then
+%                                converted as they are needed, and ahead
+%                                of time while waiting between frames.
 %   frameDurationSecs (scalar) - The duration to hold each setting until the
 %                                next one is loaded.
 %   numIterations (scalar) -     The number of iterations to loop through the
@@ -24,11 +30,24 @@ function keyPress = OLFlicker(ol, starts, stops, frameDurationSecs, numIteration
 %   keyPress (char|empty) -      If numIterations is Inf, the key the user pressed
 %                                to end the script is returned.  Otherwise, this
 %                                is returend as empty.
+%   timingData (struct) -        Per-frame timing log for the run.  Fields
+%                                frameIndex, scheduledSecs, sendStartSecs and
+%                                sendEndSecs hold, for every frame sent, the
+%                                row of starts/stops used, the time the frame
+%                                was due, and the times the call to setMirrors
+%                                began and returned (mglGetSecs timebase).
+%                                Field summary holds the statistics computed
+%                                by OLFrameTimingSummary.
+%
+% See also: OLFrameTimingSummary, OLModulationStream
 
 % 6/28/17  dhb  Don't do any key related stuff unless keyboard is being checked.
+% 10/18/26      Record per-frame timing and return it with summary stats.
+% 10/18/26      Accept an OLModulationStream in place of starts/stops.
 
 % Checking keyboard?
 checkKB = isinf(numIterations);
+keyPress = [];
 
 try	
 	% Flag whether we're checking the keyboard during the flicker loop.
@@ -46,12 +65,42 @@ try
 	ol.OutputPatternBuffer = 0;
 
 	% Send over the first settings.
-    numSettings = size(starts, 1);
-    if (size(stops,1) ~= numSettings)
-       error('starts and stops matrices must have same number of rows');
+    isStream = isa(starts, 'OLModulationStream');
+    if isStream
+        stream = starts;
+        numSettings = stream.NFrames;
+    else
+        numSettings = size(starts, 1);
+        if (size(stops,1) ~= numSettings)
+           error('starts and stops matrices must have same number of rows');
+        end
     end
 
-	ol.setMirrors(starts(1,:), stops(1,:));
+	% Preallocate the timing log.  When we know how many frames we will send
+	% we allocate exactly that many, otherwise we start with a minute's
+	% worth and double as needed.
+	if isinf(numIterations)
+		maxFrames = max(ceil(60/frameDurationSecs), numSettings);
+	else
+		maxFrames = numSettings*numIterations + 1;
+	end
+	frameIndex = zeros(maxFrames, 1);
+	scheduledSecs = zeros(maxFrames, 1);
+	sendStartSecs = zeros(maxFrames, 1);
+	sendEndSecs = zeros(maxFrames, 1);
+	nFramesSent = 1;
+
+	% The first frame is due as soon as we send it.
+	frameIndex(1) = 1;
+	sendStartSecs(1) = mglGetSecs;
+	scheduledSecs(1) = sendStartSecs(1);
+	if isStream
+		[theStarts, theStops] = stream.startsStops(1);
+		ol.setMirrors(theStarts, theStops);
+	else
+		ol.setMirrors(starts(1,:), stops(1,:));
+	end
+	sendEndSecs(1) = mglGetSecs;
 
 	% Counters to keep track of which of the settings to display and which
 	% iteration we're on.
@@ -66,12 +115,33 @@ try
 	while iterationCount < numIterations
         
         % Is it time to update spectrum yet?  If so, do it.  If not, carry on.
-		if mglGetSecs >= theTimeToUpdateSpectrum;
+		sendStart = mglGetSecs;
+		if sendStart >= theTimeToUpdateSpectrum;
 			% Update our settings counter.
 			setCount = 1 + mod(setCount, numSettings);
                  			
 			% Send over the new settings.
-			ol.setMirrors(starts(setCount,:), stops(setCount,:));
+			if isStream
+				[theStarts, theStops] = stream.startsStops(setCount);
+				ol.setMirrors(theStarts, theStops);
+			else
+				ol.setMirrors(starts(setCount,:), stops(setCount,:));
+			end
+			sendEnd = mglGetSecs;
+			
+			% Log the frame, growing the buffers if we've run out of room.
+			nFramesSent = nFramesSent + 1;
+			if nFramesSent > maxFrames
+				frameIndex = [frameIndex ; zeros(maxFrames, 1)];
+				scheduledSecs = [scheduledSecs ; zeros(maxFrames, 1)];
+				sendStartSecs = [sendStartSecs ; zeros(maxFrames, 1)];
+				sendEndSecs = [sendEndSecs ; zeros(maxFrames, 1)];
+				maxFrames = 2*maxFrames;
+			end
+			frameIndex(nFramesSent) = setCount;
+			scheduledSecs(nFramesSent) = theTimeToUpdateSpectrum;
+			sendStartSecs(nFramesSent) = sendStart;
+			sendEndSecs(nFramesSent) = sendEnd;
 			
 			% If we've reached the end of the settings list, iterate the
 			% counter that keeps track of how many times we've gone through
@@ -82,6 +152,9 @@ try
             
             % Update the time of our next switch.
 			theTimeToUpdateSpectrum = theTimeToUpdateSpectrum + frameDurationSecs;
+		elseif isStream && (theTimeToUpdateSpectrum - sendStart) > frameDurationSecs/2
+			% Plenty of time before the next frame, so convert one ahead.
+			stream.prefetchNext();
 		end
 		
 		% If we're using keyboard mode, check for a keypress.
@@ -100,6 +173,14 @@ try
     if checkKB
         ListenChar(0);
     end
+    
+    % Package up the timing log.
+    timingData.frameIndex = frameIndex(1:nFramesSent);
+    timingData.scheduledSecs = scheduledSecs(1:nFramesSent);
+    timingData.sendStartSecs = sendStartSecs(1:nFramesSent);
+    timingData.sendEndSecs = sendEndSecs(1:nFramesSent);
+    timingData.frameDurationSecs = frameDurationSecs;
+    timingData.summary = OLFrameTimingSummary(timingData);
 catch e
     if checkKB
         ListenChar(0);
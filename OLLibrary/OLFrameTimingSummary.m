@@ -0,0 +1,113 @@
+function summary = OLFrameTimingSummary(timingData, varargin)
+% Summarize a per-frame timing log from OneLight waveform playback
+%
+% Syntax:
+%   summary = OLFrameTimingSummary(timingData)
+%   summary = OLFrameTimingSummary(timingData,'lateToleranceSecs',0.001)
+%
+% Description:
+%    Take the per-frame timing log produced by OLFlicker and compute the
+%    statistics we need to decide whether playback actually ran at the
+%    requested rate.
+%
+%    A frame is counted as late when setMirrors was called more than
+%    lateToleranceSecs after the frame was due.  A frame is counted as
+%    skipped when the pattern was still being sent when the following
+%    frame became due, so that it was never held for any part of its own
+%    frame period.
+%
+% Inputs:
+%    timingData          - Struct with fields scheduledSecs, sendStartSecs,
+%                          sendEndSecs (column vectors, one entry per frame)
+%                          and frameDurationSecs (scalar), as returned by
+%                          OLFlicker.
+%
+% Outputs:
+%    summary             - Struct with fields:
+%                            nFrames            - Number of frames sent.
+%                            requestedRateHz    - 1/frameDurationSecs.
+%                            meanRateHz         - Mean rate at which
+%                                                 patterns were delivered.
+%                            meanIntervalSecs   - Mean time between send
+%                                                 completions.
+%                            jitterSecs         - Standard deviation of the
+%                                                 time between send
+%                                                 completions.
+%                            meanSendSecs       - Mean duration of a
+%                                                 setMirrors call.
+%                            maxSendSecs        - Longest setMirrors call.
+%                            latenessSecs       - Per-frame lateness,
+%                                                 sendStart minus scheduled.
+%                            maxLatenessSecs    - Largest lateness.
+%                            nLate              - Number of late frames.
+%                            nSkipped           - Number of skipped frames.
+%
+% Optional key/value pairs:
+%    'lateToleranceSecs' - Scalar. Lateness beyond this counts as late.
+%                          Default is 10% of the frame duration.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLFlicker
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% A 200 Hz run where the third frame went out a full frame late
+    timingData.frameDurationSecs = 0.005;
+    timingData.scheduledSecs = (0:4)' * 0.005;
+    timingData.sendStartSecs = timingData.scheduledSecs + [0 0 0.005 0 0]';
+    timingData.sendEndSecs = timingData.sendStartSecs + 0.001;
+    summary = OLFrameTimingSummary(timingData);
+    assert(summary.nLate == 1);
+    assert(summary.nSkipped == 1);
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('timingData',@isstruct);
+parser.addParameter('lateToleranceSecs',[],@(x) isempty(x) || isscalar(x));
+parser.parse(timingData,varargin{:});
+
+frameDurationSecs = timingData.frameDurationSecs;
+lateToleranceSecs = parser.Results.lateToleranceSecs;
+if (isempty(lateToleranceSecs))
+    lateToleranceSecs = 0.1 * frameDurationSecs;
+end
+
+scheduledSecs = timingData.scheduledSecs(:);
+sendStartSecs = timingData.sendStartSecs(:);
+sendEndSecs = timingData.sendEndSecs(:);
+
+%% Rate and jitter
+%
+% We measure intervals between send completions, since that is when the
+% new pattern is in the device.
+summary.nFrames = numel(scheduledSecs);
+summary.requestedRateHz = 1/frameDurationSecs;
+intervalSecs = diff(sendEndSecs);
+if (isempty(intervalSecs))
+    summary.meanIntervalSecs = NaN;
+    summary.meanRateHz = NaN;
+    summary.jitterSecs = NaN;
+else
+    summary.meanIntervalSecs = mean(intervalSecs);
+    summary.meanRateHz = 1/summary.meanIntervalSecs;
+    summary.jitterSecs = std(intervalSecs);
+end
+
+%% Time spent in setMirrors
+sendSecs = sendEndSecs - sendStartSecs;
+summary.meanSendSecs = mean(sendSecs);
+summary.maxSendSecs = max(sendSecs);
+
+%% Late and skipped frames
+summary.latenessSecs = sendStartSecs - scheduledSecs;
+summary.maxLatenessSecs = max(summary.latenessSecs);
+summary.nLate = sum(summary.latenessSecs > lateToleranceSecs);
+summary.nSkipped = sum(sendEndSecs >= scheduledSecs + frameDurationSecs);
+
+end
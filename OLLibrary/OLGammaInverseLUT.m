@@ -0,0 +1,141 @@
+function lut = OLGammaInverseLUT(cal)
+% Build a lookup for inverting the gamma tables of a OneLight calibration
+%
+% Syntax:
+%   lut = OLGammaInverseLUT(cal)
+%   settings = lut.apply(primary)
+%
+% Description:
+%    OLPrimaryToSettings gamma corrects by exhaustive search: for every
+%    primary value it scans the whole gamma table for the entry closest to
+%    that value, and returns the corresponding gamma input.  With the
+%    average gamma table this was done one spectrum at a time.
+%
+%    The gamma tables are made monotonic by OLInitCal, so the closest
+%    entry is always one of the two entries that bracket the value, and a
+%    binary search finds them.  This routine does the preparation for
+%    that once per calibration: for each table it keeps the distinct
+%    values, in order, together with the first gamma input index at which
+%    each occurs.  The apply field is a function handle that then looks
+%    up a whole primaries x spectra (or primaries x frames) matrix at
+%    once, one vectorized search per table.
+%
+%    The result is exactly that of the exhaustive search, including ties,
+%    which go to the lower entry as min does.  If a table is not
+%    monotonic, the exhaustive search is used for it.
+%
+%    Pass the lut to OLPrimaryToSettings (key 'gammaLUT') to avoid
+%    rebuilding it on every call.
+%
+% Inputs:
+%    cal       - Struct. OneLight calibration file after it has been
+%                processed by OLInitCal.
+%
+% Outputs:
+%    lut       - Struct with fields:
+%                  apply          - Function handle, settings =
+%                                   lut.apply(primary).
+%                  useAverageGamma - Whether the average table is used
+%                                   for all primaries.
+%                  nPrimaries     - Number of primaries.
+%                  gammaInput     - Gamma input levels.
+%                  tableValues    - Cell array, distinct values of each
+%                                   table in increasing order.
+%                  tableIndices   - Cell array, index into gammaInput of
+%                                   the first occurrence of each value.
+%                  monotonic      - Logical, per table.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLPrimaryToSettings
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    cal = OLGetCalibrationStructure('CalibrationType','DemoCal','CalibrationFolder',fullfile(tbLocateToolbox('OneLightToolbox'),'OLDemoCal'),'CalibrationDate','latest');
+    lut = OLGammaInverseLUT(cal);
+    primary = rand(cal.describe.numWavelengthBands,1000);
+    settings = OLPrimaryToSettings(cal,primary,'gammaLUT',lut);
+%}
+
+%% Make sure that the calibration file has been processed by OLInitCal.
+assert(isfield(cal, 'computed'), 'OLSpdToPrimary:InvalidCalFile', ...
+    'The calibration file needs to be processed by OLInitCal.');
+
+%% Which tables
+lut.useAverageGamma = isfield(cal.describe, 'useAverageGamma') && cal.describe.useAverageGamma;
+lut.nPrimaries = cal.describe.numWavelengthBands;
+lut.gammaInput = cal.computed.gammaInput(:);
+if (lut.useAverageGamma)
+    gammaTable = cal.computed.gammaTableAvg(:);
+else
+    gammaTable = cal.computed.gammaTable;
+    if (size(gammaTable,2) ~= lut.nPrimaries)
+        error('Gamma table does not have one column per primary');
+    end
+end
+
+%% Distinct values of each table, and where they first occur
+nTables = size(gammaTable,2);
+lut.tableValues = cell(1,nTables);
+lut.tableIndices = cell(1,nTables);
+lut.monotonic = false(1,nTables);
+for t = 1:nTables
+    lut.monotonic(t) = all(diff(gammaTable(:,t)) >= 0);
+    if (lut.monotonic(t))
+        [lut.tableValues{t}, lut.tableIndices{t}] = unique(gammaTable(:,t),'first');
+    else
+        lut.tableValues{t} = gammaTable(:,t);
+    end
+end
+
+lut.apply = @(primary) applyLUT(lut, primary);
+
+end
+
+function settings = applyLUT(lut, primary)
+% Look up settings for a primaries x N matrix of primary values
+
+settings = zeros(size(primary));
+for i = 1:size(primary,1)
+    if (lut.useAverageGamma)
+        t = 1;
+    else
+        t = i;
+    end
+    values = lut.tableValues{t};
+    target = primary(i,:);
+
+    % Exhaustive search, for a table that isn't monotonic
+    if (~lut.monotonic(t))
+        [~,index] = min(abs(bsxfun(@minus, values, target)),[],1);
+        settings(i,:) = lut.gammaInput(index)';
+        continue;
+    end
+
+    % Bracketing entries.  Below the first value we take the first, and
+    % at or above the last we take the last.
+    nValues = numel(values);
+    if (nValues == 1)
+        settings(i,:) = lut.gammaInput(lut.tableIndices{t});
+        continue;
+    end
+    lower = interp1(values, (1:nValues)', target(:), 'previous');
+    lower(target(:) < values(1)) = 1;
+    lower(target(:) >= values(end)) = nValues;
+    upper = min(lower+1, nValues);
+
+    % Take the upper one only if it is strictly closer
+    useUpper = abs(values(upper) - target(:)) < abs(values(lower) - target(:));
+    nearest = lower;
+    nearest(useUpper) = upper(useUpper);
+    settings(i,:) = lut.gammaInput(lut.tableIndices{t}(nearest))';
+end
+
+end
@@ -0,0 +1,78 @@
+function [primaryValues, inGamut, gamutMargins] = OLGamutKernel(primaryValues, gamutMinMax, primaryTolerance)
+% Truncate within tolerance, check gamut and get margins in one pass
+%
+% Syntax:
+%   truncatedPrimaryValues = OLGamutKernel(primaryValues, gamut, tolerance)
+%   [truncatedPrimaryValues, inGamut, gamutMargins] = OLGamutKernel(...)
+%
+% Description:
+%    Does what
+%       truncatedPrimaryValues = OLTruncateGamutTolerance(primaryValues, gamut, tolerance);
+%       [inGamut, gamutMargins] = OLCheckPrimaryValues(truncatedPrimaryValues, gamut);
+%    does, with identical results, but when the mex file OLGamutKernelMex
+%    has been compiled (see OLCompileMexfiles) it does so in a single pass
+%    over the primaries with no temporaries.  The MATLAB version needs
+%    about ten passes over the whole matrix, which starts to matter for
+%    primaries x frames waveforms of long, high frame rate modulations.
+%
+%    Without the mex file, or for input that is not a full real double
+%    matrix, the equivalent MATLAB code is run.
+%
+% Inputs:
+%    primaryValues          - Numeric matrix (NxM), of primary values to be
+%                             truncated and checked
+%    gamutMinMax            - Numeric 1x2 vector specifying [min, max] of
+%                             gamut
+%    primaryTolerance       - Numeric Scalar, maximum amount to truncate
+%
+% Outputs:
+%    primaryValues          - Numeric matrix (NxM) of primary values,
+%                             truncated as by OLTruncateGamutTolerance.
+%    inGamut                - Boolean scalar, are truncated primary values
+%                             within gamut
+%    gamutMargins           - 1x2 numeric, as returned by OLGamutMargins
+%                             for the truncated primary values.
+%
+% Optional keyword arguments:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLTruncateGamutTolerance, OLCheckPrimaryValues, OLGamutMargins,
+%    OLCheckPrimaryGamut, OLCompileMexfiles
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Same as truncating and then checking
+    primaryValues = [.9 1.04 1.1 .1 -.04 -.1];
+    [truncated, inGamut, gamutMargins] = OLGamutKernel(primaryValues, [0 1], .05);
+    assert(isequal(truncated, OLTruncateGamutTolerance(primaryValues, [0 1], .05)));
+    assert(~inGamut);
+    assert(all(round(gamutMargins,7) == [-.05 -.05]));
+%}
+
+%% Is the mex file there?
+persistent haveMex;
+if (isempty(haveMex))
+    haveMex = (exist('OLGamutKernelMex','file') == 3);
+end
+
+%% Sort gamutMinMax
+% ensure gamut = [min, max]
+gamutMinMax = sort(gamutMinMax);
+
+%% Truncate, check, and get margins
+if (haveMex && isa(primaryValues,'double') && isreal(primaryValues) && ...
+        ~issparse(primaryValues) && ~isempty(primaryValues))
+    [primaryValues, inGamut, gamutMargins] = OLGamutKernelMex(primaryValues, ...
+        gamutMinMax(1), gamutMinMax(2), primaryTolerance);
+else
+    primaryValues = OLTruncateGamutTolerance(primaryValues, gamutMinMax, primaryTolerance);
+    [inGamut, gamutMargins] = OLCheckPrimaryValues(primaryValues, gamutMinMax);
+end
+
+end
@@ -37,8 +37,32 @@ function cal = OLGetCalibrationStructure(varargin)
 %                                          which causes the routine to look
 %                                          in the result of
 %                                          getpref('OneLightToolbox', 'OneLightCalData').
+%   'RawFields',theRawFields             - Which fields of cal.raw to load.
+%                                          Default 'all'. Pass {} to leave
+%                                          cal.raw out, or a cell array of
+%                                          field names such as
+%                                          {'powerFluctuationMeas','spectralShiftsMeas'}.
+%   'WriteCacheFiles',true/false         - Whether the calibration index and
+%                                          containers may be written to the
+%                                          calibration folder (see below).
+%                                          Default true.
 %
-% See also: OLGetAvailableCalibrationTypes.
+% The dates to choose from come from the calibration index (see
+% OLFindCalibrations), and are listed oldest first.  The calibration that
+% is picked is read from the calibration container OL<type>.olcal (see
+% OLWriteCalibrationFile), which is written if it is not up to date with
+% the .mat file.  Only the fields of it that are wanted are read from
+% disk, rather than all calibrations of the type with all their raw
+% measurements.
+%
+% Note that this means the calibration folder gets a CalibrationIndex.olidx
+% file and an OL<type>.olcal file next to each OL<type>.mat.  They can be
+% deleted at any time and are made again when needed.  If the folder is
+% shared and should not be written to, pass 'WriteCacheFiles' false; the
+% index is then kept in memory, and calibrations without an up to date
+% container are loaded from the .mat file.
+%
+% See also: OLGetAvailableCalibrationTypes, OLFindCalibrations, OLReadCalibrationFile.
 
 %
 % 4/4/13    dhb, ms  Pulled out of a calling program as separate function.
@@ -51,12 +75,18 @@ function cal = OLGetCalibrationStructure(varargin)
 %                    what is in the calibration folder.
 % 04/01/18  dhb      Something was wrong with how calFolder was being
 %                    passed into OLGetAvailableCalibrationTypes.  Fixed.
+% 10/18/26           Read from the calibration container when there is one.
+%                    Added 'RawFields' key/value pair.
+% 10/18/26           Get the dates from the calibration index.
+% 10/18/26           Added 'WriteCacheFiles' key/value pair.
 
 %% Parse key/value pairs
 p = inputParser;
 p.addParameter('CalibrationType', '', @isstr);
 p.addParameter('CalibrationDate', '', @isstr);
 p.addParameter('CalibrationFolder', '', @isstr);
+p.addParameter('RawFields', 'all', @(x) iscellstr(x) || strcmp(x,'all'));
+p.addParameter('WriteCacheFiles', true, @islogical);
 p.parse(varargin{:});
 params = p.Results;
 
@@ -119,12 +149,17 @@ end
 % of the calibration data we want.
 calIndex = 0;
 if ischar(cal)
-    % Get all the calibration data.
-    [~, cals] = LoadCalFile(['OL' cal], [], calFolder);
+    % Get the dates of all the calibrations from the calibration index,
+    % which opens only calibration files that changed since it was made.
+    calEntries = OLFindCalibrations('CalibrationFolder', calFolder, 'CalibrationType', cal, 'WriteCacheFiles', params.WriteCacheFiles);
+    calDates = {calEntries.date};
+    if (isempty(calEntries))
+        error('There are no calibrations in the calibration file for %s', cal);
+    end
     
     % Have the user select a calibration if there is more than 1 and we
     % didn't pass which one we wanted.
-    if (length(cals) > 1)
+    if (length(calDates) > 1)
         
         switch (params.CalibrationDate)
             case ''
@@ -134,30 +169,30 @@ if ischar(cal)
                 while keepPrompting
                     % Show the available calibration types.
                     fprintf('\n*** Available Calibrations ***\n\n');
-                    for i = 1:length(cals)
-                        fprintf('%d - %s\n', i, cals{i}.describe.date);
+                    for i = 1:length(calDates)
+                        fprintf('%d - %s\n', i, calDates{i});
                     end
                     fprintf('\n');
                     
-                    calIndex = GetWithDefault('Select a Calibration', length(cals));
+                    calIndex = GetWithDefault('Select a Calibration', length(calDates));
                     
                     % Check the selection.
-                    if calIndex >= 1 && calIndex <= length(cals)
+                    if calIndex >= 1 && calIndex <= length(calDates)
                         keepPrompting = false;
                     else
                         fprintf('\n* Invalid selection\n');
                     end
                 end
             case 'latest'
-                calIndex = length(cals);
+                calIndex = length(calDates);
             otherwise
-                for i = 1:length(cals)
-                    if (strcmp(cals{i}.describe.date,params.CalibrationDate))
+                for i = 1:length(calDates)
+                    if (strcmp(calDates{i},params.CalibrationDate))
                         calIndex = i;
                         break;
                     end
                 end
-                if calIndex >= 1 && calIndex <= length(cals)
+                if calIndex >= 1 && calIndex <= length(calDates)
                 else
                     error('Invalid calibration date specified');
                 end
@@ -166,8 +201,25 @@ if ischar(cal)
         calIndex = 1;
     end
     
-    % Extract the desired calibration.
-    cal = cals{calIndex};
+    % Extract the desired calibration, with the raw fields asked for.
+    calNumber = calEntries(calIndex).calNumber;
+    [containerFileName, cals] = OLUpdateCalibrationContainer(cal, calFolder, 'WriteCacheFiles', params.WriteCacheFiles);
+    if (isempty(cals))
+        [~, header] = OLReadCalibrationFile(containerFileName, 'calibrations', []);
+        fieldNames = header.fieldNames{calNumber};
+        if (~ischar(params.RawFields))
+            fieldNames = setdiff(fieldNames, {'raw'}, 'stable');
+            fieldNames = [fieldNames(:)' strcat('raw.', params.RawFields(:)')];
+        end
+        cal = OLReadCalibrationFile(containerFileName, 'calibrations', calNumber, 'fields', fieldNames);
+    else
+        cal = cals{calNumber};
+        if (~ischar(params.RawFields) && isfield(cal, 'raw'))
+            rawFields = setdiff(fieldnames(cal.raw), params.RawFields);
+            cal.raw = rmfield(cal.raw, rawFields);
+            if (isempty(params.RawFields))
+                cal = rmfield(cal, 'raw');
+            end
+        end
+    end
 end
-
-
@@ -20,6 +20,8 @@ function OLInitAndSaveCal(calFileName,varargin)
 % option descriptions.
 %
 % 3/31/14  dhb  Pass options through.
+% 10/18/26      Also write the calibration container, see OLWriteCalibrationFile.
+% 10/18/26      And update the calibration index, see OLUpdateCalibrationIndex.
 
 narginchk(0, Inf);
 
@@ -34,3 +36,10 @@ oneLightCal = OLInitCal(calFileName,varargin{:});
 
 % Save the compute calibration file.
 SaveCalFile(oneLightCal, calFileName);
+
+% Bring the calibration container up to date, so that
+% OLGetCalibrationStructure can read just the calibration it wants.
+[~, cals, fullCalFileName] = LoadCalFile(calFileName);
+[calDir, calName] = fileparts(fullCalFileName);
+OLWriteCalibrationFile(fullfile(calDir, [calName '.olcal']), cals, 'sourceFile', fullCalFileName);
+OLUpdateCalibrationIndex(calDir, 'CalibrationTypes', {calName(3:end)});
@@ -261,8 +261,8 @@ function cal = OLInitCal(calFileName, varargin)
     cal.computed.gammaInput = linspace(0,1,cal.describe.nGammaFitLevels)';
     for k = 1:cal.describe.nGammaBands
         cal.computed.gammaTableMeasuredBands(:,k) = [0 ; cal.computed.gammaData1{k}'];
-        cal.computed.gammaTableMeasuredBandsFit(:,k) = OLFitGamma(cal.computed.gammaInputRaw,cal.computed.gammaTableMeasuredBands(:,k),cal.computed.gammaInput,cal.describe.gammaFitType);
     end
+    cal.computed.gammaTableMeasuredBandsFit = OLFitGamma(cal.computed.gammaInputRaw,cal.computed.gammaTableMeasuredBands,cal.computed.gammaInput,cal.describe.gammaFitType);
 
     % Interpolate the measured bands out across all of the bands
     for l = 1:cal.describe.nGammaFitLevels
@@ -319,19 +319,23 @@ for k = 1:cal.describe.nGammaBands
         cal.computed.gammaDataMaxInputAfterZeroInputSubtract(k) = cal.computed.gammaTableMeasuredBands(end,k);
         cal.computed.gammaTableMeasuredBands(:,k) = cal.computed.gammaTableMeasuredBands(:,k) / ...
             cal.computed.gammaDataMaxInputAfterZeroInputSubtract(k);
-        
-        cal.computed.gammaTableMeasuredBandsFit(:,k) = ...
-            OLFitGamma(cal.computed.gammaInputRaw,cal.computed.gammaTableMeasuredBands(:,k),cal.computed.gammaInput,cal.describe.gammaFitType);
-        
+    else
+        cal.computed.gammaTableMeasuredBands(:,k) = [0 ; cal.computed.gammaData1{k}'];
+    end
+end
+
+% Fit all the bands at once
+cal.computed.gammaTableMeasuredBandsFit = ...
+    OLFitGamma(cal.computed.gammaInputRaw,cal.computed.gammaTableMeasuredBands,cal.computed.gammaInput,cal.describe.gammaFitType);
+
+% Undo the scaling
+if (cal.describe.specifiedBackground)
+    for k = 1:cal.describe.nGammaBands
         cal.computed.gammaTableMeasuredBands(:,k) = cal.computed.gammaTableMeasuredBands(:,k) * ...
             cal.computed.gammaDataMaxInputAfterZeroInputSubtract(k);
-        cal.computed.gammaDataMaxInputAfterZeroInputSubtract(k);cal.computed.gammaTableMeasuredBandsFit(:,k) = cal.computed.gammaTableMeasuredBandsFit(:,k) * ...
+        cal.computed.gammaTableMeasuredBandsFit(:,k) = cal.computed.gammaTableMeasuredBandsFit(:,k) * ...
             cal.computed.gammaDataMaxInputAfterZeroInputSubtract(k);
         % cal.computed.gammaTableMeasuredBandsFit(:,k) = cal.computed.gammaTableMeasuredBandsFit(:,k) + cal.computed.gammaDataZeroInput(k);
-    else
-        cal.computed.gammaTableMeasuredBands(:,k) = [0 ; cal.computed.gammaData1{k}'];
-        cal.computed.gammaTableMeasuredBandsFit(:,k) = ...
-            OLFitGamma(cal.computed.gammaInputRaw,cal.computed.gammaTableMeasuredBands(:,k),cal.computed.gammaInput,cal.describe.gammaFitType);
     end
 end
 
@@ -40,6 +40,9 @@ function settings = OLPrimaryToSettings(cal, primary, varargin)
 %                                   into gamut without complaining.
 %    'checkPrimaryOutOfRange'     - Boolean (default true). Throw error if any passed
 %                                   primaries are out of the [0-1] range.
+%    'gammaLUT'                   - Struct (default []). Gamma inversion
+%                                   lookup from OLGammaInverseLUT. Built
+%                                   from cal if not passed.
 
 % 1/17/14  dhb, ms   Improved comments.
 % 1/20/14  dhb, ms   Optimistically think that we've fixed this for full gamma table.
@@ -49,12 +52,14 @@ function settings = OLPrimaryToSettings(cal, primary, varargin)
 % 04/12/18 dhb       Move to camelCase on key/value pairs.  Call
 %                    OLCheckPrimaryGamut.
 %          dhb       Header format to current standards.
+% 10/18/26           Gamma correct all spectra at once with OLGammaInverseLUT.
 
 %% Parse the input
 p = inputParser;
 p.addParameter('verbose', false, @islogical);
 p.addParameter('primaryTolerance',1e-6, @isscalar);
 p.addParameter('checkPrimaryOutOfRange', true, @islogical);
+p.addParameter('gammaLUT', [], @(x) isempty(x) || isstruct(x));
 p.parse(varargin{:});
 params = p.Results;
 
@@ -77,44 +82,33 @@ primary = OLCheckPrimaryGamut(primary,...
 
 %% Gamma correct
 %
-% If we've dummied up what looks like a gamma function measurement for
-% every primary, then we can just use PTB's gamma correction directly.
-if ~isfield(cal.describe, 'useAverageGamma') || (~cal.describe.useAverageGamma)
-    cal.computed.gammaMode = 0;
-    settings = PrimaryToSettings(cal.computed,primary);
-    
-% If we computed a single average gamma function, we have to use lower level
-% routines.
-else 
-    settings = zeros(size(primary));
-    nSpectra = size(primary, 2);
-    for i = 1:nSpectra
-        % Gamma correct the primary values.
-        %
-        % This is hard to read because of the transposes, which work
-        % in the special case of a one primary gamma table.  Once
-        % we make each primary have a separate gamma function in OL cal files,
-        % we should be able to call PrimaryToSettings here and be done with it.
-        settings(:,i) = GamutToSettingsSch(cal.computed.gammaInput, cal.computed.gammaTableAvg, primary(:,i)')';
-        
-        if params.verbose
-            gammaCorrectedCurve = GamutToSettingsSch(cal.computed.gammaInput, ...
-                cal.computed.gammaTableAvg,cal.computed.gammaInput');
-            figure; clf; hold on
-            plot(primary(:,i), settings(:,i), 'ro');
-            plot(cal.computed.gammaInput, gammaCorrectedCurve', 'k');
-            xlabel('Linear Settings');
-            ylabel('Gamma Corrected Settings');
-            title('Gamma Correction')
-            ylim([0 1]);
-            
-            % Plot settings
-            figure; clf; hold on
-            plot(primary(:,i), 'ro', 'MarkerFaceColor', 'r');
-            xlabel('Column Number');
-            ylabel('Column Setting');
-            title('Settings');
-            ylim([0 1]);
-        end
+% Both with a gamma table for every primary and with a single average
+% gamma table, this finds for each primary value the closest gamma table
+% entry, as PTB's GamutToSettingsSch does, but searches the whole matrix
+% at once.  See OLGammaInverseLUT.
+lut = params.gammaLUT;
+if (isempty(lut))
+    lut = OLGammaInverseLUT(cal);
+end
+settings = lut.apply(primary);
+
+if (params.verbose && lut.useAverageGamma)
+    gammaCorrectedCurve = lut.apply(cal.computed.gammaInput');
+    for i = 1:size(primary, 2)
+        figure; clf; hold on
+        plot(primary(:,i), settings(:,i), 'ro');
+        plot(cal.computed.gammaInput, gammaCorrectedCurve', 'k');
+        xlabel('Linear Settings');
+        ylabel('Gamma Corrected Settings');
+        title('Gamma Correction')
+        ylim([0 1]);
+
+        % Plot settings
+        figure; clf; hold on
+        plot(primary(:,i), 'ro', 'MarkerFaceColor', 'r');
+        xlabel('Column Number');
+        ylabel('Column Setting');
+        title('Settings');
+        ylim([0 1]);
     end
 end
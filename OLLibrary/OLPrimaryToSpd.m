@@ -45,7 +45,8 @@ function predictedSpd = OLPrimaryToSpd(calibration, primary, varargin)
 %                         ignores checks and makes this run faster.
 %
 % See also:
-%    OLSpdToPrimary, OLPrimaryToSpdFastAndDirty, OLPrimaryToSettings, OLSettingsToStartsStops,
+%    OLSpdToPrimary, OLPrimaryToSpdFastAndDirty, OLPrimaryToSpdModel,
+%    OLPrimaryToSettings, OLSettingsToStartsStops,
 %    OLSpdToPrimaryTest
 
 % History:
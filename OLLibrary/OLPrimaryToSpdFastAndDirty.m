@@ -34,7 +34,7 @@ function predictedSpd = OLPrimaryToSpdFastAndDirty(calibration, primary)
 %                  primary values and calibration information
 %
 % See also:
-%    OLSpdToPrimary, OLPrimaryToSettings, OLSettingsToStartsStops,
+%    OLSpdToPrimary, OLPrimaryToSpdModel, OLPrimaryToSettings, OLSettingsToStartsStops,
 %    OLSpdToPrimaryTest
 %
 
@@ -0,0 +1,120 @@
+function model = OLPrimaryToSpdModel(calibration, varargin)
+% Build a forward model that predicts spds from primaries with no checking
+%
+% Syntax:
+%   model = OLPrimaryToSpdModel(calibration)
+%   model = OLPrimaryToSpdModel(calibration,'differentialMode',true)
+%   model = OLPrimaryToSpdModel(calibration,'precision','single')
+%   predictedSpds = model.apply(primaries)
+%
+% Description:
+%    OLPrimaryToSpd parses its arguments and checks the primaries against
+%    the gamut on every call, which costs far more than the matrix product
+%    it then does.  That matters when it is called many times, e.g. from
+%    the error function of a search or in a loop over the frames of a
+%    modulation.  OLPrimaryToSpdFastAndDirty skips the checks but still
+%    pulls the matrices out of the calibration structure on each call.
+%
+%    This routine does all of that once and returns a model whose apply
+%    field is a function handle that does nothing but the product.  apply
+%    takes a P x N matrix of primaries, e.g. the primaries x frames
+%    waveform of a whole modulation, and returns the nWls x N matrix of
+%    predicted spds.  As with OLPrimaryToSpdFastAndDirty, it is up to the
+%    caller to make sure the primaries are in gamut.
+%
+%    With 'precision' set to 'single' the matrices are stored in single
+%    precision and the primaries are converted before the product, which
+%    halves the memory traffic and lets the BLAS use twice as many lanes
+%    per vector instruction.  The result is single, and agrees with the
+%    double precision prediction to about 1e-7 relative, which is well
+%    below calibration accuracy; use it for prediction and display, not
+%    inside searches that rely on small differences.
+%
+% Inputs:
+%    calibration - OneLight calibration struct (must be valid, i.e., been
+%                  processed by OLInitCal)
+%
+% Outputs:
+%    model       - Struct with fields:
+%                    apply            - Function handle, predictedSpds =
+%                                       model.apply(primaries).
+%                    M                - nWls x P primary basis, in the
+%                                       model's precision.
+%                    darkSpd          - nWls x 1 dark spd (zeros in
+%                                       differential mode).
+%                    differentialMode, precision
+%                                     - Settings used.
+%                    nPrimaries, nWls - Sizes.
+%
+% Optional key/value pairs:
+%    'differentialMode' - Boolean (default false). As in OLPrimaryToSpd,
+%                         do not add in the dark light.
+%    'precision'        - String, 'double' (default) or 'single'.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLPrimaryToSpd, OLPrimaryToSpdFastAndDirty
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Predict all frames of a modulation in one call
+    cal = OLGetCalibrationStructure('CalibrationType','DemoCal','CalibrationFolder',fullfile(tbLocateToolbox('OneLightToolbox'),'OLDemoCal'),'CalibrationDate','latest');
+    nPrimaries = size(cal.computed.pr650M,2);
+    primaryWaveform = 0.5 + 0.4*sin(2*pi*(1:nPrimaries)'/nPrimaries)*sin(2*pi*(0:999)/200);
+    model = OLPrimaryToSpdModel(cal);
+    predictedSpds = model.apply(primaryWaveform);
+    assert(max(max(abs(predictedSpds - OLPrimaryToSpd(cal,primaryWaveform)))) < 1e-12);
+
+    modelSingle = OLPrimaryToSpdModel(cal,'precision','single');
+    predictedSpdsSingle = modelSingle.apply(primaryWaveform);
+%}
+
+%% Parse input
+p = inputParser;
+p.addRequired('calibration',@isstruct);
+p.addParameter('differentialMode', false, @islogical);
+p.addParameter('precision', 'double', @(x) any(strcmp(x,{'double','single'})));
+p.parse(calibration,varargin{:});
+
+assert(isfield(calibration, 'computed'),...
+    'OneLightToolbox:OLPrimaryToSpdModel:InvalidCalFile', ...
+    'The calibration file needs to be processed by OLInitCal.');
+
+%% Matrices, in requested precision
+model.differentialMode = p.Results.differentialMode;
+model.precision = p.Results.precision;
+model.M = cast(calibration.computed.pr650M, model.precision);
+if (model.differentialMode)
+    model.darkSpd = zeros(size(calibration.computed.pr650MeanDark), model.precision);
+else
+    model.darkSpd = cast(calibration.computed.pr650MeanDark, model.precision);
+end
+[model.nWls, model.nPrimaries] = size(model.M);
+
+%% The apply function
+%
+% The matrices are captured in the handle, so calling it involves no
+% field lookups.  Adding the dark spd relies on implicit expansion over
+% the columns.
+M = model.M;
+darkSpd = model.darkSpd;
+switch (model.precision)
+    case 'double'
+        if (model.differentialMode)
+            model.apply = @(primary) M*primary;
+        else
+            model.apply = @(primary) M*primary + darkSpd;
+        end
+    case 'single'
+        if (model.differentialMode)
+            model.apply = @(primary) M*single(primary);
+        else
+            model.apply = @(primary) M*single(primary) + darkSpd;
+        end
+end
+
+end
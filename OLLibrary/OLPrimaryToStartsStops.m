@@ -49,6 +49,8 @@ function [starts, stops] = OLPrimaryToStartsStops(primary, calibration, varargin
 %                                   same. Speeds calculation.
 %    'checkPrimaryOutOfRange'     - Boolean (default true). Throw error if any passed
 %                                   primaries are out of the [0-1] range.
+%    'gammaLUT'                   - Struct (default []). Passed on to
+%                                   OLPrimaryToSettings.
 %
 % Examples are provided in the source code.
 %
@@ -61,6 +63,7 @@ function [starts, stops] = OLPrimaryToStartsStops(primary, calibration, varargin
 %    01/29/18  jv  Wrote it.
 %    04/12/18  dhb Updating primary gamut checking.  Provide separate
 %                  tolerances for gamut checking and uniqueness.
+%    10/18/26      Pass 'gammaLUT' through to OLPrimaryToSettings.
 
 % Examples:
 %{
@@ -138,6 +141,7 @@ parser.addRequired('calibration',@isstruct);
 parser.addParameter('primaryTolerance',1e-6, @isscalar);
 parser.addParameter('uniqueTolerance', 1e-6, @isscalar);
 parser.addParameter('checkPrimaryOutOfRange', true, @islogical);
+parser.addParameter('gammaLUT', [], @(x) isempty(x) || isstruct(x));
 parser.parse(primary,calibration,varargin{:});
 
 %% Check primaries within gamut
@@ -160,7 +164,7 @@ primary = OLCheckPrimaryGamut(primary,...
 [uniquePrimaryVals, ~, indices] = uniquetol(primary',parser.Results.uniqueTolerance,'ByRows',true);
 
 %% Convert to settings
-settings = OLPrimaryToSettings(calibration,uniquePrimaryVals');
+settings = OLPrimaryToSettings(calibration,uniquePrimaryVals','gammaLUT',parser.Results.gammaLUT);
 
 %% Convert to starts/stops
 [starts,stops] = OLSettingsToStartsStops(calibration, settings);
@@ -39,6 +39,7 @@ function primaryWaveform = OLPrimaryWaveform(primaryValues, waveform, varargin)
 
 % History:
 %    01/29/18  jv  wrote it.
+%    10/18/26      truncate and check in one pass with OLGamutKernel.
 
 % Examples:
 %{  
@@ -86,11 +87,9 @@ primaryTolerance = parser.Results.primaryTolerance;
 %% Matrix multiplication
 primaryWaveform = primaryValues * waveform;
 
-%% Truncate primary tolerance
-primaryWaveform = OLTruncateGamutTolerance(primaryWaveform,gamutMinMax,primaryTolerance);
-
-%% Check in gamut
-assert(OLCheckPrimaryValues(primaryWaveform,gamutMinMax),...
+%% Truncate primary tolerance, and check in gamut
+[primaryWaveform, inGamut] = OLGamutKernel(primaryWaveform,gamutMinMax,primaryTolerance);
+assert(inGamut,...
         'OneLightToolbox:PrimaryWaveform:OutOfGamut',...
         'Primary waveform is out of gamut');
 
@@ -0,0 +1,235 @@
+function [cals, header] = OLReadCalibrationFile(fileName, varargin)
+% Read calibrations, or some of their fields, from a calibration container
+%
+% Syntax:
+%   cals = OLReadCalibrationFile(fileName)
+%   cal = OLReadCalibrationFile(fileName,'calibrations',3)
+%   cal = OLReadCalibrationFile(fileName,'calibrations',3,'fields',{'describe','computed'})
+%   raw = OLReadCalibrationFile(fileName,'calibrations',3,'fields',{'raw.powerFluctuationMeas'})
+%   [~, header] = OLReadCalibrationFile(fileName,'calibrations',[])
+%
+% Description:
+%    Read calibrations written by OLWriteCalibrationFile.  See there for
+%    the file layout.
+%
+%    The file is memory mapped, and only the data of the fields asked for
+%    is read from disk.  A field is given by its path in the calibration
+%    without the leading dot, e.g. 'computed' or 'raw.spectralShiftsMeas',
+%    and comes with everything in it.  The structs that lead to it are
+%    made with only the fields asked for in them, so e.g. asking for
+%    'describe' and 'raw.powerFluctuationMeas' gives a calibration with
+%    fields describe and raw, and raw has just the one field.
+%
+% Inputs:
+%    fileName       - String. File to read.
+%
+% Outputs:
+%    cals           - Cell array of the calibrations asked for, or the
+%                     calibration itself if one number was given.
+%    header         - Struct with fields version, nCalibrations,
+%                     sourceBytes, sourceDatenum and dataOffset, as written
+%                     by OLWriteCalibrationFile, and fieldNames, the
+%                     top level field names of each calibration.
+%
+% Optional key/value pairs:
+%    'calibrations' - Vector of calibration numbers (1-based) to read.
+%                     Default is all of them.  Pass [] to read only the
+%                     header.
+%    'fields'       - Cell array of field paths to read. Default {} reads
+%                     all fields.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLWriteCalibrationFile, OLGetCalibrationStructure
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% The dates of all calibrations, without reading anything else
+    calFolder = fileparts(which('OLDemoCal.mat'));
+    [~, cals] = LoadCalFile('OLDemoCal', [], calFolder);
+    fileName = fullfile(tempdir,'OLDemoCal.olcal');
+    OLWriteCalibrationFile(fileName, cals);
+    dates = cellfun(@(c) c.describe.date, ...
+        OLReadCalibrationFile(fileName,'fields',{'describe.date'}), 'UniformOutput', false);
+    assert(isequal(dates, cellfun(@(c) c.describe.date, cals, 'UniformOutput', false)));
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('fileName',@ischar);
+parser.addParameter('calibrations','all',@(x) isnumeric(x) || strcmp(x,'all'));
+parser.addParameter('fields',{},@iscellstr);
+parser.parse(fileName,varargin{:});
+
+%% Header and index
+fid = fopen(fileName,'r','ieee-le');
+assert(fid >= 0,'OneLightToolbox:OLReadCalibrationFile:CannotOpen', ...
+    'Could not open %s',fileName);
+cleanup = onCleanup(@() fclose(fid));
+
+magic = fread(fid,[1 8],'*char');
+assert(strcmp(magic,'OLCALFIL'),'OneLightToolbox:OLReadCalibrationFile:BadFile', ...
+    'File %s is not a OneLight calibration container',fileName);
+values = fread(fid,6,'uint32');
+header.version = values(1);
+assert(header.version == 1,'OneLightToolbox:OLReadCalibrationFile:BadVersion', ...
+    'Unknown calibration container format version %d',header.version);
+header.nCalibrations = values(2);
+nEntries = values(3);
+pathTextBytes = values(4);
+nDims = values(5);
+source = fread(fid,2,'double');
+header.sourceBytes = source(1);
+header.sourceDatenum = source(2);
+header.dataOffset = fread(fid,1,'uint64');
+
+entryCalibration = fread(fid,[1 nEntries],'uint32');
+entryKind = fread(fid,[1 nEntries],'uint32');
+entryClass = fread(fid,[1 nEntries],'uint32');
+entryNDims = fread(fid,[1 nEntries],'uint32');
+entryOffset = fread(fid,[1 nEntries],'uint64');
+entryBytes = fread(fid,[1 nEntries],'uint64');
+dims = fread(fid,[1 nDims],'uint32');
+paths = regexp(fread(fid,[1 pathTextBytes],'*char'),'\n','split');
+paths = paths(1:nEntries);
+dimsEnd = cumsum(entryNDims);
+dimsStart = dimsEnd - entryNDims + 1;
+
+% The whole file, from which entries are pulled as they are needed
+map = memmapfile(fileName,'Format','uint8');
+
+% Top level field names of each calibration
+roots = find(strcmp(paths,''));
+header.fieldNames = cell(1,header.nCalibrations);
+for k = 1:numel(roots)
+    header.fieldNames{entryCalibration(roots(k))} = splitNames(entryData(roots(k)));
+end
+
+%% Which entries to read
+calibrations = parser.Results.calibrations;
+if (ischar(calibrations))
+    calibrations = 1:header.nCalibrations;
+end
+assert(all(calibrations >= 1 & calibrations <= header.nCalibrations), ...
+    'OneLightToolbox:OLReadCalibrationFile:BadCalibrations', ...
+    'Requested calibrations must be in the range [1,%d]',header.nCalibrations);
+
+% Entries in a requested field, and the structs and cells on the way to
+% them, which are made without their other fields
+fields = parser.Results.fields;
+wanted = isempty(fields) | false(1,nEntries);
+onTheWay = false(1,nEntries);
+for f = 1:numel(fields)
+    field = ['.' fields{f}];
+    n = numel(field);
+    wanted = wanted | strcmp(paths,field) | strncmp(paths,[field '.'],n+1) | ...
+        strncmp(paths,[field '('],n+1) | strncmp(paths,[field '{'],n+1);
+    stops = find(ismember(field,'.({'));
+    onTheWay = onTheWay | ismember(paths,arrayfun(@(s) field(1:s-1),stops,'UniformOutput',false));
+end
+onTheWay = onTheWay & ~wanted;
+
+%% Build the calibrations
+cals = cell(1,numel(calibrations));
+for k = 1:numel(calibrations)
+    selected = find((wanted | onTheWay) & entryCalibration == calibrations(k));
+    cal = [];
+    for e = selected
+        if (onTheWay(e) && entryKind(e) == 1)
+            value = cell(entryDims(e));
+        elseif (onTheWay(e))
+            value = repmat(struct(),entryDims(e));
+        else
+            value = entryValue(e);
+        end
+        if (isempty(paths{e}))
+            cal = value;
+        else
+            cal = subsasgn(cal,pathSubs(paths{e}),value);
+        end
+    end
+    cals{k} = cal;
+end
+if (isscalar(parser.Results.calibrations))
+    cals = cals{1};
+end
+
+    function d = entryDims(e)
+        d = dims(dimsStart(e):dimsEnd(e));
+    end
+
+    function data = entryData(e)
+        if (entryBytes(e) == 0)
+            data = zeros(1,0,'uint8');
+        else
+            data = map.Data(entryOffset(e)+(1:entryBytes(e)))';
+        end
+    end
+
+    function value = entryValue(e)
+        classNames = {'double','single','logical','char','int8','uint8', ...
+            'int16','uint16','int32','uint32','int64','uint64'};
+        switch (entryKind(e))
+            case 0
+                names = splitNames(entryData(e));
+                if (isempty(names))
+                    value = repmat(struct(),entryDims(e));
+                else
+                    value = reshape(cell2struct(cell(numel(names),prod(entryDims(e))),names,1),entryDims(e));
+                end
+            case 1
+                value = cell(entryDims(e));
+            case 2
+                className = classNames{entryClass(e)};
+                storedClass = className;
+                switch (className)
+                    case 'logical'
+                        storedClass = 'uint8';
+                    case 'char'
+                        storedClass = 'uint16';
+                end
+                if (entryBytes(e) == 0)
+                    value = zeros(entryDims(e),storedClass);
+                else
+                    value = reshape(typecast(entryData(e),storedClass),entryDims(e));
+                end
+                switch (className)
+                    case 'logical'
+                        value = logical(value);
+                    case 'char'
+                        value = char(value);
+                end
+            case 3
+                value = getArrayFromByteStream(entryData(e)');
+        end
+    end
+end
+
+function names = splitNames(data)
+% Field names of a struct entry, which are newline terminated
+names = regexp(char(data),'\n','split');
+names = names(1:end-1);
+end
+
+function subs = pathSubs(path)
+% Subscripts for subsasgn from a path like '.raw.gamma.rad(2).meas'
+parts = regexp(path,'\.\w+|\(\d+\)|\{\d+\}','match');
+subs = struct('type',cell(1,numel(parts)),'subs',[]);
+for k = 1:numel(parts)
+    switch (parts{k}(1))
+        case '.'
+            subs(k).type = '.';
+            subs(k).subs = parts{k}(2:end);
+        case '('
+            subs(k).type = '()';
+            subs(k).subs = {str2double(parts{k}(2:end-1))};
+        case '{'
+            subs(k).type = '{}';
+            subs(k).subs = {str2double(parts{k}(2:end-1))};
+    end
+end
+end
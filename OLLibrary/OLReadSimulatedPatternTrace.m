@@ -0,0 +1,89 @@
+function trace = OLReadSimulatedPatternTrace(traceFile)
+% Read the binary pattern trace written by a simulated OneLight
+%
+% Syntax:
+%   trace = OLReadSimulatedPatternTrace(traceFile)
+%
+% Description:
+%    A OneLight object created with 'simulate' true and a 'simTraceFile'
+%    appends a record to that file for every pattern the simulated device
+%    receives.  This routine reads the file back.
+%
+%    The file is little-endian.  It starts with the 8 characters
+%    'OLSIMTRC' and four uint32 values: format version, number of mirror
+%    columns, number of mirror rows and number of pattern buffers.  Each
+%    record then holds the receive time and display time (double, seconds
+%    since the device was first opened, display time NaN if the pattern was not
+%    displayed), the input and output pattern buffer (uint8), and the
+%    starts and stops (uint16, one per column).
+%
+% Inputs:
+%    traceFile    - String. Path of the trace file.
+%
+% Outputs:
+%    trace        - Struct with fields nCols, nRows, numPatternBuffers,
+%                   receivedSecs and displaySecs (nPatterns x 1),
+%                   inputBuffer and outputBuffer (nPatterns x 1) and starts
+%                   and stops (nPatterns x nCols), in the same layout as
+%                   returned by OLPrimaryToStartsStops.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OneLight, OLFlicker, OLFrameTimingSummary
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Benchmark OLFlicker against a simulated device with 2 ms transfers
+    traceFile = fullfile(tempdir,'OLSimTrace.bin');
+    ol = OneLight('simulate',true,'plotWhenSimulating',false, ...
+        'simTransferLatencySecs',0.002,'simTraceFile',traceFile);
+    starts = zeros(10,ol.NumCols);
+    stops = repmat((0:9)',1,ol.NumCols);
+    [~,timingData] = OLFlicker(ol,starts,stops,1/200,5);
+    ol.close;
+    trace = OLReadSimulatedPatternTrace(traceFile);
+    assert(size(trace.starts,1) == numel(timingData.sendEndSecs));
+%}
+
+fid = fopen(traceFile,'r','ieee-le');
+assert(fid >= 0,'OneLightToolbox:OLReadSimulatedPatternTrace:CannotOpen', ...
+    'Could not open trace file %s',traceFile);
+cleanup = onCleanup(@() fclose(fid));
+
+%% Header
+magic = fread(fid,[1 8],'*char');
+assert(strcmp(magic,'OLSIMTRC'),'OneLightToolbox:OLReadSimulatedPatternTrace:BadFile', ...
+    'File %s is not a simulated OneLight pattern trace',traceFile);
+header = fread(fid,4,'uint32');
+assert(header(1) == 1,'OneLightToolbox:OLReadSimulatedPatternTrace:BadVersion', ...
+    'Unknown trace format version %d',header(1));
+trace.nCols = header(2);
+trace.nRows = header(3);
+trace.numPatternBuffers = header(4);
+
+%% Records
+%
+% Read all the records as bytes in one go and then pull the fields out by
+% offset, rather than looping over records.
+nCols = trace.nCols;
+recordBytes = 8 + 8 + 1 + 1 + 2*2*nCols;
+[data,nBytes] = fread(fid,[recordBytes Inf],'*uint8');
+
+% Drop a partial final record, e.g. if the session was killed mid-write.
+nPatterns = floor(nBytes/recordBytes);
+data = data(:,1:nPatterns);
+trace.receivedSecs = typecast(reshape(data(1:8,:),[],1),'double');
+trace.displaySecs = typecast(reshape(data(9:16,:),[],1),'double');
+trace.inputBuffer = double(data(17,:))';
+trace.outputBuffer = double(data(18,:))';
+trace.starts = double(reshape(typecast(reshape(data(19:18+2*nCols,:),[],1),'uint16'),nCols,nPatterns))';
+trace.stops = double(reshape(typecast(reshape(data(19+2*nCols:end,:),[],1),'uint16'),nCols,nPatterns))';
+
+end
@@ -0,0 +1,149 @@
+function [starts, stops, header] = OLReadStartsStopsFile(fileName, varargin)
+% Read a sequence of mirror patterns written by OLWriteStartsStopsFile
+%
+% Syntax:
+%   [starts, stops] = OLReadStartsStopsFile(fileName)
+%   [starts, stops, header] = OLReadStartsStopsFile(fileName)
+%   [...] = OLReadStartsStopsFile(fileName,'frames',1:200)
+%   [~, ~, header] = OLReadStartsStopsFile(fileName,'frames',[])
+%
+% Description:
+%    Read the header and the requested frames of a pattern sequence file.
+%    See OLWriteStartsStopsFile for the file layout.
+%
+%    Uncompressed files are memory mapped, so only the requested frames
+%    are read from disk and the header contains the memmapfile object, in
+%    field map, for callers that want to pull frames out themselves during
+%    playback: header.map.Data(k).pattern is nCols x 2, with starts in the
+%    first column and stops in the second.
+%
+%    For delta compressed files, each requested frame is decoded from the
+%    nearest preceding full frame.
+%
+% Inputs:
+%    fileName - String. File to read.
+%
+% Outputs:
+%    starts   - nRequestedFrames x nCols matrix of starts.
+%    stops    - nRequestedFrames x nCols matrix of stops.
+%    header   - Struct with fields version, compression, nFrames, nCols,
+%               frameRateHz, calID and dataOffset, plus map for
+%               uncompressed files.
+%
+% Optional key/value pairs:
+%    'frames' - Vector of frame indices (1-based) to read. Default is all
+%               frames.  Pass [] to read only the header.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLWriteStartsStopsFile
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Write out a short sequence, then map it and pull out one frame
+    starts = zeros(10,1024);
+    stops = repmat((0:9)',1,1024);
+    fileName = fullfile(tempdir,'ramp.olpat');
+    OLWriteStartsStopsFile(fileName,starts,stops,'frameRateHz',100);
+    [~,~,header] = OLReadStartsStopsFile(fileName,'frames',[]);
+    pattern = header.map.Data(5).pattern;
+    assert(all(pattern(:,2) == 4));
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('fileName',@ischar);
+parser.addParameter('frames','all',@(x) isnumeric(x) || strcmp(x,'all'));
+parser.parse(fileName,varargin{:});
+
+%% Header
+fid = fopen(fileName,'r','ieee-le');
+assert(fid >= 0,'OneLightToolbox:OLReadStartsStopsFile:CannotOpen', ...
+    'Could not open %s',fileName);
+cleanup = onCleanup(@() fclose(fid));
+
+magic = fread(fid,[1 8],'*char');
+assert(strcmp(magic,'OLPATSEQ'),'OneLightToolbox:OLReadStartsStopsFile:BadFile', ...
+    'File %s is not a OneLight pattern sequence',fileName);
+values = fread(fid,4,'uint32');
+header.version = values(1);
+assert(header.version == 1,'OneLightToolbox:OLReadStartsStopsFile:BadVersion', ...
+    'Unknown pattern sequence format version %d',header.version);
+compressionNames = {'none','delta'};
+header.compression = compressionNames{values(2)+1};
+header.nFrames = values(3);
+header.nCols = values(4);
+header.frameRateHz = fread(fid,1,'double');
+values = fread(fid,2,'uint32');
+header.calID = fread(fid,[1 values(1)],'*char');
+header.dataOffset = values(2);
+
+nCols = header.nCols;
+frames = parser.Results.frames;
+if (ischar(frames))
+    frames = 1:header.nFrames;
+end
+assert(all(frames >= 1 & frames <= header.nFrames), ...
+    'OneLightToolbox:OLReadStartsStopsFile:BadFrames', ...
+    'Requested frames must be in the range [1,%d]',header.nFrames);
+starts = zeros(numel(frames),nCols);
+stops = zeros(numel(frames),nCols);
+
+%% Frames
+switch (header.compression)
+    case 'none'
+        header.map = memmapfile(fileName,'Offset',header.dataOffset, ...
+            'Format',{'uint16',[nCols 2],'pattern'},'Repeat',header.nFrames);
+        for k = 1:numel(frames)
+            pattern = header.map.Data(frames(k)).pattern;
+            starts(k,:) = pattern(:,1)';
+            stops(k,:) = pattern(:,2)';
+        end
+
+    case 'delta'
+        fseek(fid,header.dataOffset,'bof');
+        offsets = fread(fid,header.nFrames,'uint64');
+
+        % Decode forward from the last full frame at or before each
+        % requested frame.  When requested frames are increasing we just
+        % carry on from the previous one.
+        currentFrame = 0;
+        currentStarts = [];
+        currentStops = [];
+        for k = 1:numel(frames)
+            if (currentFrame == 0 || frames(k) < currentFrame)
+                firstFrame = frames(k);
+                while (true)
+                    fseek(fid,offsets(firstFrame),'bof');
+                    if (fread(fid,1,'uint16') == 0)
+                        break;
+                    end
+                    firstFrame = firstFrame-1;
+                end
+            else
+                firstFrame = currentFrame+1;
+            end
+            for f = firstFrame:frames(k)
+                fseek(fid,offsets(f),'bof');
+                recordHeader = fread(fid,2,'uint16');
+                if (recordHeader(1) == 0)
+                    currentStarts = fread(fid,[1 nCols],'uint16');
+                    currentStops = fread(fid,[1 nCols],'uint16');
+                else
+                    ranges = reshape(fread(fid,2*recordHeader(2),'uint16'),2,[])';
+                    cols = cell2mat(arrayfun(@(r) ranges(r,1):ranges(r,2),(1:size(ranges,1))','UniformOutput',false)');
+                    currentStarts(cols) = fread(fid,[1 numel(cols)],'uint16');
+                    currentStops(cols) = fread(fid,[1 numel(cols)],'uint16');
+                end
+            end
+            currentFrame = frames(k);
+            starts(k,:) = currentStarts;
+            stops(k,:) = currentStops;
+        end
+end
+
+end
@@ -50,6 +50,9 @@ function [starts,stops] = OLSettingsToStartsStops(cal, settings, varargin)
 %                     Getting clever about how to fill up the mirrors within the full
 %                     set of columns within a primary.
 % 6/5/17   dhb        Use input parse.
+% 10/18/26            Compute mirror allocation for all primaries and spectra
+%                     at once, rather than looping over spectra, primaries
+%                     and mirrors.  Same output, much faster for waveforms.
 
 %% Parse the input
 p = inputParser;
@@ -132,133 +135,96 @@ for k = 1:nColsPerPrimary/2
     withinPrimaryColumnOnOrder(2*k) = nColsPerPrimary+1-k;
 end
 
-% Go through all the spectra, one at a time
-for i = 1:nSpectra
-    
-    % For each spectrum, go through all the primaries, one at a time
-    for j = 1:nPrimaries
-        % Since we've set up starts and stops so that all
-        % columns are off unless we turn them on, we only
-        % have to do anyting for cases where the settings
-        % are not zero.
-        if (settings(j,i) ~= 0)
-            % Convert settings from [0-1] to an integer number of
-            % mirrors to turn on for the whole primary.
-            nMirrorsOnThisPrimary = round(settings(j,i)*nMirrorsPerPrimary);
-            
-            % Divide this into the number of mirrors to turn on for each
-            % column of the primary.
-            %
-            % Use a slow but conceptually simple algorithm.  Just loop through
-            % all the mirrors we need to turn on, incrementing the next columns
-            % accumulator by 1 each time through.
-            maxMirrorsOnPerColumn = ceil(nMirrorsOnThisPrimary/nColsPerPrimary);
-            nMirrorsOnPerColumn = zeros(1,nColsPerPrimary);
-            mirrorsLeftToAllocate = nMirrorsOnThisPrimary;
-            columnIndex = 1;
-            for l = 1:nMirrorsOnThisPrimary
-                % Bump accumulator this column
-                whichColumn = withinPrimaryColumnOnOrder(columnIndex);
-                nMirrorsOnPerColumn(whichColumn) = nMirrorsOnPerColumn(whichColumn) + 1;
-                
-                % Bump column indexer
-                columnIndex = columnIndex + 1;
-                if (columnIndex > nColsPerPrimary)
-                    columnIndex = 1;
-                end
-            end
-            if (sum(nMirrorsOnPerColumn) ~= nMirrorsOnThisPrimary)
-                error('Logic error in how we allocate mirrors across primaries (mismatchin number on)');
-            end
-            if (any(nMirrorsOnPerColumn > nRows))
-                error('Logic error in how we allocate mirrors across primaries (one col has > nRows)');
-            end
-            
-            % Figure out starts and stops for each column
-            columnTypeIndex = 1;
-            columnIndex = 1;
-            startsThisPrimary = (nRows+1)*ones(nColsPerPrimary,1);
-            stopsThisPrimary = zeros(nColsPerPrimary,1);
-            
-            for k = 1:nColsPerPrimary
-                % Get which column within primary that we are working on
-                whichColumn = withinPrimaryColumnOnOrder(columnIndex);
-                
-                % Turn on appropriate mirrors, if number for this column
-                % is greater than zero
-                if (nMirrorsOnPerColumn(whichColumn) > 0)
-                    switch (columnTypeOrder{columnTypeIndex})
-                        case 'TopDown'
-                            startsThisPrimary(whichColumn) = 0;
-                            stopsThisPrimary(whichColumn) = nMirrorsOnPerColumn(whichColumn)-1;
-                        case 'BottomUp'
-                            startsThisPrimary(whichColumn) = (nRows-1) - (nMirrorsOnPerColumn(whichColumn)-1);
-                            stopsThisPrimary(whichColumn) = nRows-1;
-                        case 'MiddleOut'
-                            rawStart = nRows/2;
-                            nUpFromStart = round(nMirrorsOnPerColumn(whichColumn)/2);
-                            nDownFromStart = nMirrorsOnPerColumn(whichColumn)-nUpFromStart;
-                            startsThisPrimary(whichColumn) = rawStart-nUpFromStart;
-                            stopsThisPrimary(whichColumn) = rawStart+nDownFromStart-1;
-                        case 'QuarterDown'
-                            rawStart = nRows/4;
-                            nUpFromStart = round(nMirrorsOnPerColumn(whichColumn)/4);
-                            nDownFromStart = nMirrorsOnPerColumn(whichColumn)-nUpFromStart;
-                            startsThisPrimary(whichColumn) = rawStart-nUpFromStart;
-                            stopsThisPrimary(whichColumn) = rawStart+nDownFromStart-1;
-                         case 'QuarterUp'
-                            rawStart = 3*nRows/4;
-                            nUpFromStart = round(3*nMirrorsOnPerColumn(whichColumn)/4);
-                            if (nUpFromStart > nMirrorsOnPerColumn(whichColumn))
-                                nUpFromStart = nMirrorsOnPerColumn(whichColumn);
-                            end
-                            nDownFromStart = nMirrorsOnPerColumn(whichColumn)-nUpFromStart;
-                            startsThisPrimary(whichColumn) = rawStart-nUpFromStart;
-                            stopsThisPrimary(whichColumn) = rawStart+nDownFromStart-1;
-                        otherwise
-                            error('Bad column type specified')
-                    end
-                    if (any(startsThisPrimary(whichColumn) < 0) || any(startsThisPrimary(whichColumn) > nRows-1) || ...
-                            any(stopsThisPrimary(whichColumn) < 0 || any(stopsThisPrimary(whichColumn) > nRows-1)))
-                        error('Logic error in setting starts/stops from number mirrors on and column type');
-                    end
-                    if (stopsThisPrimary(whichColumn)-startsThisPrimary(whichColumn)+1 ~= nMirrorsOnPerColumn(whichColumn))
-                        error('Difference between stops and starts inconsisent with desired number of mirrors on');
-                    end
-                end
-                
-                 % Debugging printout
-                if (params.verbose)
+% Work out how many mirrors to turn on in each column of each primary, for
+% all primaries and spectra at once.
+%
+% Conceptually, we convert settings from [0-1] to an integer number of
+% mirrors to turn on for the whole primary, and then hand these out one at
+% a time to the columns in withinPrimaryColumnOnOrder, wrapping around
+% until they are used up.  The k-th column in that order therefore gets
+% floor(N/nColsPerPrimary) mirrors, plus one more if k <=
+% rem(N,nColsPerPrimary), and we compute that directly rather than
+% stepping through the mirrors.  Arrays below are nColsPerPrimary x
+% nPrimaries x nSpectra, indexed by position in the fill order.
+nMirrorsOnThisPrimary = reshape(round(settings*nMirrorsPerPrimary),[1 nPrimaries nSpectra]);
+fillOrderIndex = (1:nColsPerPrimary)';
+nMirrorsOnPerColumn = bsxfun(@plus, floor(nMirrorsOnThisPrimary/nColsPerPrimary), ...
+    bsxfun(@le, fillOrderIndex, rem(nMirrorsOnThisPrimary,nColsPerPrimary)));
+if (any(nMirrorsOnPerColumn(:) > nRows))
+    error('Logic error in how we allocate mirrors across primaries (one col has > nRows)');
+end
+
+% Figure out starts and stops for each column.  Column types cycle
+% through columnTypeOrder as we go along the fill order.  Columns with no
+% mirrors on keep the all off values.
+columnType = reshape(columnTypeOrder(1+mod(fillOrderIndex-1,length(columnTypeOrder))),[],1);
+isOn = nMirrorsOnPerColumn > 0;
+startsThisPrimary = (nRows+1)*ones(size(nMirrorsOnPerColumn));
+stopsThisPrimary = zeros(size(nMirrorsOnPerColumn));
+for t = unique(columnType)'
+    isType = bsxfun(@and, strcmp(columnType,t{1}), isOn);
+    nOn = nMirrorsOnPerColumn(isType);
+    switch (t{1})
+        case 'TopDown'
+            startsThisPrimary(isType) = 0;
+            stopsThisPrimary(isType) = nOn-1;
+        case 'BottomUp'
+            startsThisPrimary(isType) = (nRows-1) - (nOn-1);
+            stopsThisPrimary(isType) = nRows-1;
+        case 'MiddleOut'
+            rawStart = nRows/2;
+            nUpFromStart = round(nOn/2);
+            startsThisPrimary(isType) = rawStart-nUpFromStart;
+            stopsThisPrimary(isType) = rawStart+(nOn-nUpFromStart)-1;
+        case 'QuarterDown'
+            rawStart = nRows/4;
+            nUpFromStart = round(nOn/4);
+            startsThisPrimary(isType) = rawStart-nUpFromStart;
+            stopsThisPrimary(isType) = rawStart+(nOn-nUpFromStart)-1;
+        case 'QuarterUp'
+            rawStart = 3*nRows/4;
+            nUpFromStart = min(round(3*nOn/4),nOn);
+            startsThisPrimary(isType) = rawStart-nUpFromStart;
+            stopsThisPrimary(isType) = rawStart+(nOn-nUpFromStart)-1;
+        otherwise
+            error('Bad column type specified')
+    end
+end
+if (any(startsThisPrimary(isOn) < 0) || any(startsThisPrimary(isOn) > nRows-1) || ...
+        any(stopsThisPrimary(isOn) < 0) || any(stopsThisPrimary(isOn) > nRows-1))
+    error('Logic error in setting starts/stops from number mirrors on and column type');
+end
+if (any(stopsThisPrimary(isOn)-startsThisPrimary(isOn)+1 ~= nMirrorsOnPerColumn(isOn)))
+    error('Difference between stops and starts inconsisent with desired number of mirrors on');
+end
+
+% Debugging printout
+if (params.verbose)
+    for i = 1:nSpectra
+        for j = 1:nPrimaries
+            if (settings(j,i) ~= 0)
+                for k = 1:nColsPerPrimary
+                    whichColumn = withinPrimaryColumnOnOrder(k);
                     fprintf('Spectrum %d, raw primary column %d, actual primary column %d\n',i,k,whichColumn);
-                    fprintf('\tPrimary type %s\n',columnTypeOrder{columnTypeIndex});
+                    fprintf('\tPrimary type %s\n',columnType{k});
                     fprintf('\tSettings value this primary %g, total mirrors on %d, mirrors on this column %d\n',...
-                        settings(j,i),nMirrorsOnThisPrimary,nMirrorsOnPerColumn(whichColumn));
-                    fprintf('\tStarts: %d, stops: %d\n',startsThisPrimary(whichColumn),stopsThisPrimary(whichColumn));
-                end
-                
-                % Bump column type index
-                columnTypeIndex = columnTypeIndex + 1;
-                if (columnTypeIndex > length(columnTypeOrder))
-                    columnTypeIndex = 1;
-                end
-                
-                % Bump column indexer
-                columnIndex = columnIndex + 1;
-                if (columnIndex > nColsPerPrimary)
-                    columnIndex = 1;
+                        settings(j,i),nMirrorsOnThisPrimary(1,j,i),nMirrorsOnPerColumn(k,j,i));
+                    fprintf('\tStarts: %d, stops: %d\n',startsThisPrimary(k,j,i),stopsThisPrimary(k,j,i));
                 end
             end
-            
-            % Insert what we just derived for this primary into the
-            % full chips starts/stops matrices
-            beginIndex = cal.describe.primaryStartCols(j);
-            endIndex = cal.describe.primaryStopCols(j);
-            starts(beginIndex:endIndex,i) = startsThisPrimary;
-            stops(beginIndex:endIndex,i) = stopsThisPrimary;
         end
     end
 end
 
+% Insert what we just derived for each primary into the full chips
+% starts/stops matrices.
+if (any(primaryStopCols(:)-primaryStartCols(:)+1 ~= nColsPerPrimary))
+    error('Primary start and stop columns inconsistent with bandwidth');
+end
+chipColumn = bsxfun(@plus, primaryStartCols(:)', withinPrimaryColumnOnOrder(:)-1);
+starts(chipColumn(:),:) = reshape(startsThisPrimary,nColsPerPrimary*nPrimaries,nSpectra);
+stops(chipColumn(:),:) = reshape(stopsThisPrimary,nColsPerPrimary*nPrimaries,nSpectra);
+
 % Transpose starts/stops so that they now live in the OL World.
 starts = starts';
 stops = stops';
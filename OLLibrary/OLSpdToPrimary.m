@@ -21,8 +21,9 @@ function [primary,predictedSpd,errorFraction,gamutMargin] = OLSpdToPrimary(cal,
 %    This routine keeps values in the range [0,1] in normal mode, and in
 %    range [-1,1] in differential mode.
 %
-%    The routine works by using lsqlin to minimize the SSE between target and
-%    desired spectra.  The value of the 'lambda' key is smoothing parameter.
+%    The routine works by minimizing the SSE between target and
+%    desired spectra, subject to the gamut bounds, using the active set
+%    solver OLBoundedLeastSquares.  The value of the 'lambda' key is smoothing parameter.
 %    This weights an additional error term that tries to minimize the SSE
 %    of the difference between neighboring primary values. This can reduce
 %    ringing in the obtained primaries, at the cost of increasing the SSE
@@ -81,6 +82,9 @@ function [primary,predictedSpd,errorFraction,gamutMargin] = OLSpdToPrimary(cal,
 %   'whichSpdToPrimaryMin' - String, what to minimize (default 'leastSquares')
 %                           * 'leastSquares' Mimimize sum of squared error,
 %                             respecting lambda parameter as well.  Fast.
+%                           * 'lsqlin' Same problem as 'leastSquares', solved
+%                             with lsqlin as we used to.  Slower; kept for
+%                             comparison.
 %                           * 'fractionalError' Minimize fractional squared
 %                              error. Way slower than 'leastSquares'.  This
 %                              method also respects lambda constraint, but
@@ -92,9 +96,16 @@ function [primary,predictedSpd,errorFraction,gamutMargin] = OLSpdToPrimary(cal,
 %                       'fractionalError' method. Default, 300.  Reduce if you
 %                       don't need to go that long and things will get
 %                       faster.
+%   'solver'          - Struct (default []). Precomputed solver from
+%                       OLSpdToPrimarySolver, for the 'leastSquares' method.
+%                       Build it once per calibration and pass it in when
+%                       calling this routine many times.  Its lambda,
+%                       primaryHeadroom and differentialMode must match
+%                       those passed here.
 %
 % See also:
-%   OLPrimaryToSpd, OLPrimaryToSettings, OLSettingsToStartsStops, OLSpdToPrimaryTest
+%   OLPrimaryToSpd, OLPrimaryToSettings, OLSettingsToStartsStops, OLSpdToPrimaryTest,
+%   OLSpdToPrimarySolver, OLBoundedLeastSquares
 %
 
 % History:
@@ -111,6 +122,9 @@ function [primary,predictedSpd,errorFraction,gamutMargin] = OLSpdToPrimary(cal,
 %                  routine to recover the primaries used to produce an spd.
 %   08/15/18  dhb  Fix up mean scaling of constraints to work even when
 %                  target spd is near zero.
+%   10/18/26       Solve 'leastSquares' with OLBoundedLeastSquares rather than
+%                  lsqlin, optionally reusing a precomputed solver.
+%                  Fractional error search predicts with OLPrimaryToSpdModel.
  
 % Examples:
 %{
@@ -139,6 +153,7 @@ p.addParameter('checkSpd', false, @islogical);
 p.addParameter('whichSpdToPrimaryMin', 'leastSquares', @ischar);
 p.addParameter('spdToleranceFraction', 0.01, @isscalar);
 p.addParameter('maxSearchIter',300,@isscalar);
+p.addParameter('solver',[],@(x) isempty(x) || isstruct(x));
 p.parse(varargin{:});
 params = p.Results;
 
@@ -257,13 +272,33 @@ switch (p.Results.whichSpdToPrimaryMin)
         % Search minimizing fractional error rather than sum of squared error
         options = optimset('fmincon');
         options = optimset(options,'Diagnostics','off','Display',fminconDisplaySetting,'LargeScale','off','Algorithm','active-set', 'MaxIter', p.Results.maxSearchIter, 'MaxFunEvals', 100000, 'TolFun', p.Results.spdToleranceFraction/10, 'TolCon', 1e-6, 'TolX', 1e-6);
-        fminconfractionalx = fmincon(@(x) OLFindSpdFunFractional(x, cal, targetSpd, p.Results.lambda, p.Results.differentialMode), ...
+        model = OLPrimaryToSpdModel(cal, 'differentialMode', p.Results.differentialMode);
+        fminconfractionalx = fmincon(@(x) OLFindSpdFunFractional(x, model, targetSpd, p.Results.lambda), ...
             initialPrimary,[],[],[],[],vlb,vub, ...
             [], ...
             options);
         primary = fminconfractionalx;
         
     case 'leastSquares'
+        % Solve the same problem as lsqlin below, from its normal
+        % equations.  The overall meanScale factor doesn't change the
+        % minimizer so we don't need it here.
+        solver = p.Results.solver;
+        if (isempty(solver))
+            solver = OLSpdToPrimarySolver(cal, 'lambda', params.lambda, ...
+                'primaryHeadroom', params.primaryHeadroom, ...
+                'differentialMode', params.differentialMode);
+        else
+            assert(solver.lambda == params.lambda && ...
+                solver.primaryHeadroom == params.primaryHeadroom && ...
+                solver.differentialMode == params.differentialMode, ...
+                'OLSpdToPrimary:SolverMismatch', ...
+                'Passed solver was built with different lambda, primaryHeadroom or differentialMode');
+        end
+        primary = OLBoundedLeastSquares(solver.H, solver.pr650MT*(targetSpd-solver.darkSpd), ...
+            solver.lb, solver.ub);
+        
+    case 'lsqlin'
         % Use lsqlin to find primaries.
         %
         % Call into lsqlin
@@ -331,13 +366,11 @@ f = (f1 + f2)/(mean(targetSpd)^2);
 end
 
 
-function f = OLFindSpdFunFractional(primary, cal, targetSpd, lambda, differentialMode)
+function f = OLFindSpdFunFractional(primary, model, targetSpd, lambda)
 
 % Get the prediction.  Constraint checking is done in the constraint
 % function, skipped here
-predictedSpd = OLPrimaryToSpd(cal, primary, ...
-    'differentialMode', differentialMode, ...
-    'skipAllChecks',true);
+predictedSpd = model.apply(primary);
 
 [~, errorFraction] = OLCheckSpdTolerance(targetSpd,predictedSpd, ...
     'checkSpd', false);
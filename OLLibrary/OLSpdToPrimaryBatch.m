@@ -0,0 +1,129 @@
+function [primaries, predictedSpds, errorFractions, gamutMargins] = OLSpdToPrimaryBatch(cal, targetSpds, varargin)
+% Find primaries for many target spectra at once
+%
+% Syntax:
+%   primaries = OLSpdToPrimaryBatch(cal, targetSpds)
+%   [primaries, predictedSpds, errorFractions, gamutMargins] = OLSpdToPrimaryBatch(cal, targetSpds)
+%   [...] = OLSpdToPrimaryBatch(...,'lambda',0.005,'primaryHeadroom',0.01)
+%   [...] = OLSpdToPrimaryBatch(...,'maxWorkers',4)
+%
+% Description:
+%    Does what OLSpdToPrimary does with its default 'leastSquares' method,
+%    for each column of targetSpds, but sets up the calibration dependent
+%    part of the problem only once (see OLSpdToPrimarySolver), forms all
+%    right hand sides with a single matrix product, and skips the per
+%    call parsing and checking.
+%
+%    By default the columns are solved in order, each one starting from
+%    the solution to the previous one.  Sweeps over contrast or
+%    wavelength produce neighboring targets that are close together, and
+%    for these the warm start means that most solves need only one or two
+%    active set steps.  Setting 'maxWorkers' above 0 instead distributes
+%    the columns over a parallel pool with parfor, cold starting each;
+%    that is only worth it for very large batches of unrelated targets.
+%
+% Inputs:
+%    cal               - Struct. OneLight calibration file after it has
+%                        been processed by OLInitCal.
+%    targetSpds        - nWls x N matrix. Each column is a target spectrum,
+%                        sampled as in the calibration.
+%
+% Outputs:
+%    primaries         - nPrimaries x N matrix of primaries.
+%    predictedSpds     - nWls x N matrix of spds predicted for primaries.
+%    errorFractions    - 1 x N, as returned by OLSpdToPrimary.
+%    gamutMargins      - 1 x N, as returned by OLSpdToPrimary.
+%
+% Optional key/value pairs:
+%    'lambda'            - Scalar (default 0.005). As in OLSpdToPrimary.
+%    'primaryHeadroom'   - Scalar (default 0). As in OLSpdToPrimary.
+%    'differentialMode'  - Boolean (default false). As in OLSpdToPrimary.
+%    'solver'            - Struct (default []). Precomputed solver from
+%                          OLSpdToPrimarySolver. If passed, the three keys
+%                          above are taken from it.
+%    'maxWorkers'        - Scalar (default 0). Maximum number of parallel
+%                          workers; 0 solves serially with warm starts.
+%    'verbose'           - Boolean (default false). Report the range of
+%                          the primaries and the largest error fraction.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLSpdToPrimary, OLSpdToPrimarySolver, OLBoundedLeastSquares
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      Add 'verbose'.
+
+% Examples:
+%{
+    %% Primaries for a sweep of 100 contrast levels around a background
+    cal = OLGetCalibrationStructure('CalibrationType','DemoCal','CalibrationFolder',fullfile(tbLocateToolbox('OneLightToolbox'),'OLDemoCal'),'CalibrationDate','latest');
+    backgroundSpd = OLPrimaryToSpd(cal,0.5*ones(size(cal.computed.pr650M,2),1));
+    contrasts = linspace(-0.5,0.5,100);
+    targetSpds = backgroundSpd * (1 + contrasts);
+    [primaries,predictedSpds,errorFractions] = OLSpdToPrimaryBatch(cal,targetSpds);
+
+    % Same answer as one at a time
+    primary50 = OLSpdToPrimary(cal,targetSpds(:,50));
+    assert(max(abs(primary50 - primaries(:,50))) < 1e-6);
+%}
+
+%% Parse the input
+p = inputParser;
+p.addParameter('lambda', 0.005, @isscalar);
+p.addParameter('primaryHeadroom', 0, @isscalar);
+p.addParameter('differentialMode', false, @islogical);
+p.addParameter('solver', [], @(x) isempty(x) || isstruct(x));
+p.addParameter('maxWorkers', 0, @isscalar);
+p.addParameter('verbose', false, @islogical);
+p.parse(varargin{:});
+
+%% Set up the solver once
+solver = p.Results.solver;
+if (isempty(solver))
+    solver = OLSpdToPrimarySolver(cal, 'lambda', p.Results.lambda, ...
+        'primaryHeadroom', p.Results.primaryHeadroom, ...
+        'differentialMode', p.Results.differentialMode);
+end
+if (size(targetSpds,1) ~= solver.nWls)
+    error('Wavelength sampling inconsistency between passed spectrum and calibration');
+end
+
+%% Solve
+N = size(targetSpds,2);
+nPrimaries = size(solver.H,1);
+rightHandSides = solver.pr650MT*bsxfun(@minus, targetSpds, solver.darkSpd);
+primaries = zeros(nPrimaries,N);
+H = solver.H; lb = solver.lb; ub = solver.ub;
+if (p.Results.maxWorkers > 0)
+    parfor (k = 1:N, p.Results.maxWorkers)
+        primaries(:,k) = OLBoundedLeastSquares(H, rightHandSides(:,k), lb, ub);
+    end
+else
+    previousPrimary = [];
+    for k = 1:N
+        primaries(:,k) = OLBoundedLeastSquares(H, rightHandSides(:,k), lb, ub, ...
+            'initialX', previousPrimary);
+        previousPrimary = primaries(:,k);
+    end
+end
+
+%% Predictions, errors and margins
+%
+% The solver never leaves the box, so unlike OLSpdToPrimary there is no
+% tolerance truncation to do here.
+predictedSpds = cal.computed.pr650M*primaries;
+if (~solver.differentialMode)
+    predictedSpds = bsxfun(@plus, predictedSpds, cal.computed.pr650MeanDark);
+end
+errorFractions = sqrt(sum((targetSpds-predictedSpds).^2,1)) ./ sqrt(sum(targetSpds.^2,1));
+gamutMargins = max(lb(1) - min(primaries,[],1), max(primaries,[],1) - ub(1));
+
+%% Report
+if (p.Results.verbose)
+    fprintf('%d targets. Primaries: min = %g, max = %g. Largest error fraction = %g\n', ...
+        N, min(primaries(:)), max(primaries(:)), max(errorFractions));
+end
+
+end
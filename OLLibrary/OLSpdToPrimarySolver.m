@@ -0,0 +1,99 @@
+function solver = OLSpdToPrimarySolver(cal, varargin)
+% Precompute the calibration dependent part of OLSpdToPrimary
+%
+% Syntax:
+%   solver = OLSpdToPrimarySolver(cal)
+%   solver = OLSpdToPrimarySolver(cal,'lambda',0.005,'differentialMode',true)
+%
+% Description:
+%    OLSpdToPrimary finds primaries by minimizing
+%       ||pr650M*primary - (targetSpd - darkSpd)||^2 + lambda^2*||diff(primary)||^2
+%    within the primary gamut.  Everything about this problem except the
+%    target depends only on the calibration and on the lambda, headroom and
+%    differential mode settings.  This routine computes that part once,
+%    in the normal equations form used by OLBoundedLeastSquares, so that it
+%    can be passed to OLSpdToPrimary (key 'solver') or
+%    OLSpdToPrimaryBatch and reused across many targets.
+%
+%    The smoothness term is bidiagonal, so its contribution to the normal
+%    equations is the tridiagonal matrix lambda^2*D'*D, which we form
+%    directly.
+%
+% Inputs:
+%    cal                 - Struct. OneLight calibration file after it has
+%                          been processed by OLInitCal.
+%
+% Outputs:
+%    solver              - Struct with fields:
+%                            H                - Normal equations matrix.
+%                            pr650MT          - Transpose of pr650M, to
+%                                               form the right hand side.
+%                            darkSpd          - Dark spd subtracted from
+%                                               targets (zero in
+%                                               differential mode).
+%                            lb, ub           - Primary bounds.
+%                            lambda, primaryHeadroom, differentialMode
+%                                             - Settings used.
+%                            nWls             - Number of wavelengths.
+%
+% Optional key/value pairs:
+%    'lambda'            - Scalar (default 0.005). Smoothing parameter, as
+%                          in OLSpdToPrimary.
+%    'primaryHeadroom'   - Scalar (default 0). As in OLSpdToPrimary.
+%    'differentialMode'  - Boolean (default false). As in OLSpdToPrimary.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLSpdToPrimary, OLBoundedLeastSquares, OLSpdToPrimaryBatch
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    cal = OLGetCalibrationStructure('CalibrationType','DemoCal','CalibrationFolder',fullfile(tbLocateToolbox('OneLightToolbox'),'OLDemoCal'),'CalibrationDate','latest');
+    solver = OLSpdToPrimarySolver(cal);
+    targetSpd = OLPrimaryToSpd(cal,0.5*ones(size(cal.computed.pr650M,2),1));
+    primary = OLSpdToPrimary(cal,targetSpd,'solver',solver);
+%}
+
+%% Parse the input
+p = inputParser;
+p.addParameter('lambda', 0.005, @isscalar);
+p.addParameter('primaryHeadroom', 0, @isscalar);
+p.addParameter('differentialMode', false, @islogical);
+p.parse(varargin{:});
+
+%% Make sure that the calibration file has been processed by OLInitCal.
+assert(isfield(cal, 'computed'), 'OLSpdToPrimary:InvalidCalFile', ...
+    'The calibration file needs to be processed by OLInitCal.');
+
+%% Normal equations
+%
+% D'*D for the first difference operator D is tridiagonal, with 1 at the
+% ends of the diagonal, 2 elsewhere on it, and -1 off it.
+M = cal.computed.pr650M;
+nPrimaries = size(M,2);
+DtD = diag([1 2*ones(1,nPrimaries-2) 1]) - diag(ones(1,nPrimaries-1),1) - diag(ones(1,nPrimaries-1),-1);
+if (nPrimaries == 1)
+    DtD = 0;
+end
+solver.H = M'*M + p.Results.lambda^2*DtD;
+solver.pr650MT = M';
+
+%% Dark light and bounds
+solver.differentialMode = p.Results.differentialMode;
+if (solver.differentialMode)
+    solver.darkSpd = zeros(size(cal.computed.pr650MeanDark));
+    solver.lb = -1*ones(nPrimaries,1) + p.Results.primaryHeadroom;
+else
+    solver.darkSpd = cal.computed.pr650MeanDark;
+    solver.lb = zeros(nPrimaries,1) + p.Results.primaryHeadroom;
+end
+solver.ub = ones(nPrimaries,1) - p.Results.primaryHeadroom;
+solver.lambda = p.Results.lambda;
+solver.primaryHeadroom = p.Results.primaryHeadroom;
+solver.nWls = size(M,1);
+
+end
@@ -31,6 +31,7 @@ function [settings, primaries, predictedSpds] = OLSpdToSettings(oneLightCal, tar
 
 % 6/5/17  dhb  This could not have been working as it was sitting.  I
 %              updated so it now conforms to our current conventions.
+% 10/18/26     Use OLSpdToPrimaryBatch.
 
 %% Parse the input
 p = inputParser;
@@ -45,17 +46,9 @@ if (nWls ~= oneLightCal.describe.S(3))
     error('Wavelength sampling inconsistency between passed spectrum and calibration');
 end
 
-% Convert the spectra into primaries.
-nPrimaries = size(oneLightCal.computed.pr650M,2);
-numSpectra = size(targetSpds, 2);
-primaries = zeros(nPrimaries, numSpectra);
-for i = 1:numSpectra
-	% Convert to primaries.
-	primaries(:,i) = OLSpdToPrimary(oneLightCal, targetSpds(:,i), 'lambda',params.lambda, 'verbose', params.verbose);
-    
-    % Convert to spectra
-    predictedSpds(:,i) = OLPrimaryToSpd(oneLightCal,primaries(:,i));
-end
+% Convert the spectra into primaries, and back to spectra.  All the
+% spectra share a calibration, so do them in one batch.
+[primaries, predictedSpds] = OLSpdToPrimaryBatch(oneLightCal, targetSpds, 'lambda', params.lambda, 'verbose', params.verbose);
 
 % Convert from primaries to settings.
 settings = OLPrimaryToSettings(oneLightCal, primaries);
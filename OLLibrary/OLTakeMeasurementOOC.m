@@ -1,4 +1,4 @@
-function [meas, omniSpectrumSaturated] = OLTakeMeasurementOOC(ol, od, prOBJ, starts, stops, S, meterToggle,  nAverage)
+function [meas, omniSpectrumSaturated, prepared] = OLTakeMeasurementOOC(ol, od, prOBJ, starts, stops, S, meterToggle, nAverage, varargin)
 %OLTakeMeasurement  Takes a spectrum measurement using the PR-6XX and/or the OmniDriver.
 %
 % Syntax:
@@ -6,12 +6,24 @@ function [meas, omniSpectrumSaturated] = OLTakeMeasurementOOC(ol, od, prOBJ, sta
 %     meas = OLTakeMeasurement(ol, od, prOBJ, starts, stops, S, meterToggle);
 %     meas = OLTakeMeasurement(ol, od, prOBJ, starts, stops, S, meterToggle);
 %     meas = OLTakeMeasurement(ol, od, prOBJ, starts, stops, S, meterToggle, nAverage);
+%     [meas, ~, prepared] = OLTakeMeasurement(ol, od, prOBJ, starts, stops, S, meterToggle, nAverage, 'whileSettling', @() ...);
 %
 % Description:
 %     Takes a spectrum measurement using the PR-6XX and/or the OmniDriver.
 %
 %     Omni measurements are normalized by integration time.
 %
+%     The mirrors are set first, and the work that does not need the
+%     radiometer is done while they settle: reading the OneLight state,
+%     reading the temperature probe if one is passed, and whatever the
+%     'whileSettling' function does, typically converting the settings of
+%     the next measurement to starts and stops.  Only what is left of the
+%     settle time after that is spent waiting, so a sequence of
+%     measurements takes little more than the radiometer integrations.
+%     With the temperature logger running (see LJTemperatureProbe), the
+%     probe read is a read of the logger's latest sample and does not wait
+%     on the device.
+%
 % Input:
 %     ol (OneLight)      - OneLight class object to control the device.  If empty,
 %                          the function doesn't set the mirrors, i.e. starts and stops are
@@ -36,20 +48,35 @@ function [meas, omniSpectrumSaturated] = OLTakeMeasurementOOC(ol, od, prOBJ, sta
 %                          variable is a 2 element vector containing the result of mglGetSeconds
 %                          before and after the measurements were taken.  If a particular device
 %                          wasn't toggled, then its subfield will be empty, e.g. meas.pr650 = [].
+%                          With a temperature probe, meas.temperature has
+%                          fields value and t (mglGetSecs when read).
+%     omniSpectrumSaturated - True if an OmniDriver reading failed, [] if
+%                          the OmniDriver wasn't toggled.
+%     prepared           - What the 'whileSettling' function returned, [] if none.
 %
 % Optional key/value pairs:
-%     None:
+%     'settleTime'       - Seconds from setting the mirrors to starting the
+%                          measurement. Default 0.1.
+%     'whileSettling'    - Function handle, called with no arguments while
+%                          the mirrors settle. Its output is returned as
+%                          prepared. Default [].
+%     'temperatureProbe' - LJTemperatureProbe object to read while the
+%                          mirrors settle. Default [].
 %
-% See also:
+% See also: OLSettingsToStartsStops, LJTemperatureProbe.
      
 % 1/17/14  dhb, ms   Comment tuning.
 % 4/15/16  npc       Adapted to use PR650dev/PR670dev objects
+% 10/18/26           Do the OneLight state and temperature reads, and the caller's
+%                    preparation of the next measurement, while the mirrors settle.
+% 10/18/26           Trace the time spent in each step, with OLTrace.
 
 % Print out information aboutt he measurement?
 verboseInfo = false;
 
 % Check the number of input arguments.
-narginchk(6, 8);
+narginchk(6, Inf);
+span = OLTraceSpan('OLTakeMeasurementOOC'); %#ok<NASGU>
 
 % Take a measurement with both meters if not specified.
 if (nargin <= 6 | isempty(meterToggle))
@@ -60,21 +87,44 @@ if (nargin <= 7 | isempty(nAverage))
     nAverage = 1;
 end
 
+p = inputParser;
+p.addParameter('settleTime', 0.1, @isnumeric);
+p.addParameter('whileSettling', [], @(x) isempty(x) || isa(x, 'function_handle'));
+p.addParameter('temperatureProbe', []);
+p.parse(varargin{:});
+whileSettling = p.Results.whileSettling;
+temperatureProbe = p.Results.temperatureProbe;
+
 OneLightStateVars = {'LampStatus', 'LampCurrent', 'CurrentMonitor', 'VoltageMonitor', 'FanSpeed'};
- 
-if ~isempty(ol)
-    % capture OneLightState before measurement
-    for varIter = 1:numel(OneLightStateVars)
-        eval(sprintf('meas.oneLightState1.%s = ol.%s;', OneLightStateVars{varIter}, OneLightStateVars{varIter}));
-    end
 
+if ~isempty(ol)
     % Set the mirrors.
     ol.setMirrors(starts, stops);
-    
+    settleStart = mglGetSecs;
+
+    % capture OneLightState before measurement
+    meas.oneLightState1 = readOneLightState(ol, OneLightStateVars);
+end
+
+% Things that don't need the radiometer are done while the mirrors settle.
+if ~isempty(temperatureProbe)
+    [~, meas.temperature.value] = temperatureProbe.measure();
+    meas.temperature.t = mglGetSecs;
+end
+prepared = [];
+if ~isempty(whileSettling)
+    OLTrace('begin', 'OLTakeMeasurementOOC:whileSettling');
+    prepared = whileSettling();
+    OLTrace('end', 'OLTakeMeasurementOOC:whileSettling');
+end
+
+if ~isempty(ol)
     % Wait for the mirrors to settle.  In theory the mirrors settle in a fraction
     % of a millisecond, but we wait a bit just in case there was some USB
     % communication lag.
-    pause(0.1);
+    OLTrace('begin', 'OLTakeMeasurementOOC:settle');
+    pause(max(0, p.Results.settleTime - (mglGetSecs - settleStart)));
+    OLTrace('end', 'OLTakeMeasurementOOC:settle');
 end
 
 % Take a reading with the PR-650.
@@ -88,7 +138,9 @@ if meterToggle(1)
         
         % ORIGINAL: [radMeas, qual] = MeasSpd(S,prWhichMeter,'off');
         theTime = mglGetSecs;
+        OLTrace('begin', 'OLTakeMeasurementOOC:radiometer');
         radMeas = prOBJ.measure('userS', S);
+        OLTrace('end', 'OLTakeMeasurementOOC:radiometer');
 
         assert(prOBJ.measurementQuality == 0 || prOBJ.measurementQuality == -8, 'OLCalibrate:MeasSpd:LightSpectrum', 'Radiometer returned a quality code of %d', prOBJ.measurementQuality);
         if verboseInfo
@@ -115,8 +167,8 @@ else
 end
 
 % capture OneLightState after PR650 measurement
-for varIter = 1:numel(OneLightStateVars)
-        eval(sprintf('meas.oneLightState2.%s = ol.%s;', OneLightStateVars{varIter}, OneLightStateVars{varIter}));
+if ~isempty(ol)
+    meas.oneLightState2 = readOneLightState(ol, OneLightStateVars);
 end
     
 % Take a reading with the OmniDriver.
@@ -144,7 +196,19 @@ else
     omniSpectrumSaturated = [];
 end
 
-% capture OneLightState after omni measurement
+% capture OneLightState after omni measurement.  Without one, nothing
+% happened since the last capture.
+if ~isempty(ol)
+    if meterToggle(2)
+        meas.oneLightState3 = readOneLightState(ol, OneLightStateVars);
+    else
+        meas.oneLightState3 = meas.oneLightState2;
+    end
+end
+end
+
+function state = readOneLightState(ol, OneLightStateVars)
 for varIter = 1:numel(OneLightStateVars)
-        eval(sprintf('meas.oneLightState3.%s = ol.%s;', OneLightStateVars{varIter}, OneLightStateVars{varIter}));
+    state.(OneLightStateVars{varIter}) = ol.(OneLightStateVars{varIter});
+end
 end
@@ -0,0 +1,141 @@
+function varargout = OLTrace(command, name)
+% Record timing spans, to see where the time goes in a calibration
+%
+% Syntax:
+%   OLTrace('enable')
+%   OLTrace('begin', name)
+%   OLTrace('end', name)
+%   OLTrace('disable')
+%   OLTrace('clear')
+%   isEnabled = OLTrace('enabled')
+%   events = OLTrace('events')
+%
+% Description:
+%    A span is the time between OLTrace('begin', name) and
+%    OLTrace('end', name).  Spans nest, and OLTraceExport writes them out
+%    in the Chrome trace event format, to be looked at in chrome://tracing
+%    or https://ui.perfetto.dev.  OLTraceSpan makes a span that ends when
+%    the function that made it returns.
+%
+%    Nothing is recorded until tracing is enabled, and begin and end cost
+%    next to nothing when it is not.  Spans are kept by OLTraceMex (see
+%    OLCompileMexfiles), with nanosecond times of the monotonic clock,
+%    the clock the C code of the LabJack and other mex files records
+%    their own spans with (see OLTrace.h).  Without OLTraceMex the spans
+%    are kept in MATLAB, with times from tic and toc, and only the
+%    MATLAB spans can be exported.
+%
+%    The OneLight object records every call it makes to OneLightEngine,
+%    and the LabJack temperature probe mex files record every USB read
+%    and write, when they are rebuilt with LJTrace.h (pass them to
+%    OLTraceExport with 'modules').
+%
+% Inputs:
+%    command   - String. One of the commands above.
+%    name      - String. Name of the span, for 'begin' and 'end'.
+%
+% Outputs:
+%    isEnabled - True if spans are being recorded.
+%    events    - Struct with fields name (n x 1 cell), phase (n x 1 char,
+%                'B' or 'E'), t (n x 1 uint64, ns) of the events recorded
+%                since the last clear, oldest first; since, the time of the
+%                last clear; and clock, 'monotonic' or 'tic'.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLTraceSpan, OLTraceExport
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Time some spans and look at them
+    OLTrace('clear');
+    OLTrace('enable');
+    OLTrace('begin', 'outer');
+    OLTrace('begin', 'inner'); pause(0.01); OLTrace('end', 'inner');
+    OLTrace('end', 'outer');
+    OLTrace('disable');
+    OLTraceExport(fullfile(tempdir, 'trace.json'));
+%}
+
+persistent haveMex isEnabled since ticOrigin names phases times nEvents;
+if isempty(haveMex)
+    haveMex = (exist('OLTraceMex', 'file') == 3);
+    isEnabled = false;
+    since = uint64(0);
+    ticOrigin = tic;
+    [names, phases, times, nEvents] = emptyEvents();
+end
+
+switch (command)
+    case {'begin', 'end'}
+        if (~isEnabled)
+            return;
+        end
+        phase = 'B';
+        if (command(1) == 'e')
+            phase = 'E';
+        end
+        if (haveMex)
+            OLTraceMex(phase, name);
+        else
+            if (nEvents == numel(names))
+                names{2*end} = [];
+                phases(2*end) = ' ';
+                times(2*end) = 0;
+            end
+            nEvents = nEvents + 1;
+            names{nEvents} = name;
+            phases(nEvents) = phase;
+            times(nEvents) = uint64(1e9*toc(ticOrigin));
+        end
+    case 'enable'
+        isEnabled = true;
+        if (haveMex)
+            OLTraceMex('enable');
+        end
+    case 'disable'
+        isEnabled = false;
+        if (haveMex)
+            OLTraceMex('disable');
+        end
+    case 'clear'
+        if (haveMex)
+            OLTraceMex('clear');
+            since = OLTraceMex('now');
+        else
+            [names, phases, times, nEvents] = emptyEvents();
+            since = uint64(1e9*toc(ticOrigin));
+        end
+    case 'enabled'
+        varargout{1} = isEnabled;
+    case 'events'
+        if (haveMex)
+            events = OLTraceMex('events');
+            events.clock = 'monotonic';
+        else
+            events.name = names(1:nEvents)';
+            events.phase = phases(1:nEvents)';
+            events.t = times(1:nEvents)';
+            events.clock = 'tic';
+        end
+        events.since = since;
+        varargout{1} = events;
+    otherwise
+        error('OneLightToolbox:OLTrace:UnknownCommand', 'Unknown command %s', command);
+end
+
+end
+
+function [names, phases, times, nEvents] = emptyEvents()
+names = cell(1, 1024);
+phases = repmat(' ', 1, 1024);
+times = zeros(1, 1024, 'uint64');
+nEvents = 0;
+end
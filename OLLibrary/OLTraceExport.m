@@ -0,0 +1,126 @@
+function events = OLTraceExport(fileName, varargin)
+% Write the timing spans recorded to a Chrome trace event file
+%
+% Syntax:
+%   OLTraceExport(fileName)
+%   events = OLTraceExport(fileName)
+%   OLTraceExport(fileName,'modules',{'LJTemperatureProbeU3'})
+%
+% Description:
+%    Writes the spans recorded with OLTrace since it was last cleared,
+%    together with those recorded in the same time by the C code of the
+%    mex files listed in 'modules', as a JSON file in the Chrome trace
+%    event format.  Open it in chrome://tracing or https://ui.perfetto.dev.
+%
+%    The MATLAB spans are on one row ("thread") of the trace, and each
+%    mex file's spans on a row of their own, all on the same time axis.
+%    A mex file hands over its spans with its 'traceEvents' command (see
+%    OLTrace.h).  Only list mex files compiled with tracing: the LabJack
+%    temperature probe mex files are, once rebuilt from the current
+%    U3.c and UE9.c (see CompileMexfiles in OLLabJackLibrary/src), but
+%    the binaries in the repository are older.  Without OLTraceMex only
+%    the MATLAB spans are written, since their times are from another
+%    clock.
+%
+%    Ends without a begin, from spans that were open when tracing was
+%    enabled or the events cleared, are left out.
+%
+% Inputs:
+%    fileName   - String. File to write, typically ending in .json.
+%
+% Outputs:
+%    events     - Struct with fields name, phase, ts (microseconds from the
+%                 first event) and thread (row name) of the events
+%                 written, in order of time.
+%
+% Optional key/value pairs:
+%    'modules'  - Cell array of names of mex files to take spans from.
+%                 Default {}.
+%
+% See also:
+%    OLTrace, OLTraceSpan
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      No LabJack modules by default, until their mex files
+%                  are rebuilt with tracing.
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('fileName',@ischar);
+parser.addParameter('modules',{},@iscellstr);
+parser.parse(fileName,varargin{:});
+
+%% Gather the events of each row
+matlabEvents = OLTrace('events');
+rows = struct('thread',{'MATLAB'},'events',{matlabEvents});
+if (strcmp(matlabEvents.clock,'monotonic'))
+    for module = parser.Results.modules
+        assert(exist(module{1},'file') == 3,'OneLightToolbox:OLTraceExport:NoMexFile', ...
+            '%s is not a compiled mex file',module{1});
+        [~, moduleEvents] = feval(module{1},'traceEvents');
+        keep = (moduleEvents.t >= matlabEvents.since);
+        moduleEvents = struct('name',{moduleEvents.name(keep)},'phase',moduleEvents.phase(keep), ...
+            't',moduleEvents.t(keep));
+        rows(end+1) = struct('thread',module{1},'events',moduleEvents); %#ok<AGROW>
+    end
+end
+
+%% Merge them, leaving out unmatched ends
+names = {};
+phases = '';
+times = zeros(0,1,'uint64');
+threads = zeros(0,1);
+for r = 1:numel(rows)
+    keep = matchedEvents(rows(r).events.name, rows(r).events.phase);
+    names = [names ; rows(r).events.name(keep)]; %#ok<AGROW>
+    phases = [phases ; rows(r).events.phase(keep)]; %#ok<AGROW>
+    times = [times ; rows(r).events.t(keep)]; %#ok<AGROW>
+    threads = [threads ; r*ones(sum(keep),1)]; %#ok<AGROW>
+end
+[times, order] = sort(times);
+names = names(order);
+phases = phases(order);
+threads = threads(order);
+if (isempty(times))
+    ts = zeros(0,1);
+else
+    ts = double(times - times(1))/1e3;
+end
+
+%% Write them
+fid = fopen(fileName,'w');
+assert(fid >= 0,'OneLightToolbox:OLTraceExport:CannotOpen','Could not open %s',fileName);
+cleanup = onCleanup(@() fclose(fid)); %#ok<NASGU>
+fprintf(fid,'{"traceEvents":[\n');
+eventArgs = [regexprep(names,'(["\\])','\\$1')' ; num2cell(phases)' ; num2cell(ts)' ; num2cell(threads)'];
+if (~isempty(eventArgs))
+    fprintf(fid,'{"name":"%s","ph":"%s","ts":%.3f,"pid":1,"tid":%d},\n',eventArgs{:});
+end
+threadArgs = [num2cell(1:numel(rows)) ; {rows.thread}];
+metadata = sprintf('{"name":"thread_name","ph":"M","pid":1,"tid":%d,"args":{"name":"%s"}},\n',threadArgs{:});
+fprintf(fid,'%s',metadata(1:end-2));
+fprintf(fid,'\n],"displayTimeUnit":"ns"}\n');
+
+if (nargout > 0)
+    events = struct('name',names,'phase',num2cell(phases),'ts',num2cell(ts), ...
+        'thread',{rows(threads).thread}');
+end
+
+end
+
+function keep = matchedEvents(names, phases)
+% Events other than ends without a matching begin before them
+keep = true(numel(names),1);
+[uniqueNames, ~, which] = unique(names);
+depth = zeros(numel(uniqueNames),1);
+for k = 1:numel(names)
+    if (phases(k) == 'B')
+        depth(which(k)) = depth(which(k)) + 1;
+    elseif (depth(which(k)) > 0)
+        depth(which(k)) = depth(which(k)) - 1;
+    else
+        keep(k) = false;
+    end
+end
+end
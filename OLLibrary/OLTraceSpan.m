@@ -0,0 +1,29 @@
+function span = OLTraceSpan(name)
+% Begin a timing span that ends when the returned object is cleared
+%
+% Syntax:
+%   span = OLTraceSpan(name); %#ok<NASGU>
+%
+% Description:
+%    Begins the span with OLTrace('begin', name), and returns an onCleanup
+%    object that ends it.  Kept in a variable of a function, the span
+%    ends when the function returns, or throws.  Meant for functions that
+%    take a while, since making the object costs some microseconds; use
+%    OLTrace begin and end directly in tight loops.
+%
+% Inputs:
+%    name    - String. Name of the span, e.g. mfilename().
+%
+% Outputs:
+%    span    - onCleanup object.
+%
+% See also:
+%    OLTrace, OLTraceExport
+
+% History:
+%    10/18/26      Wrote it.
+
+OLTrace('begin', name);
+span = onCleanup(@() OLTrace('end', name));
+
+end
@@ -0,0 +1,83 @@
+function [containerFileName, cals] = OLUpdateCalibrationContainer(calType, calFolder, varargin)
+% Make sure the calibration container of a calibration type is up to date
+%
+% Syntax:
+%   containerFileName = OLUpdateCalibrationContainer(calType, calFolder)
+%   [containerFileName, cals] = OLUpdateCalibrationContainer(calType, calFolder)
+%   [containerFileName, cals] = OLUpdateCalibrationContainer(calType, calFolder,'WriteCacheFiles',false)
+%
+% Description:
+%    The container OL<calType>.olcal (see OLWriteCalibrationFile) is up to
+%    date if it was written from OL<calType>.mat as that is now.  If it
+%    is, nothing is read but the container's header.  If not, the .mat file
+%    is loaded and the container written again, unless 'WriteCacheFiles'
+%    is false.
+%
+% Inputs:
+%    calType           - String. Calibration type, the file name without
+%                        the initial 'OL'.
+%    calFolder         - String. Folder the calibration file is in.
+%
+% Outputs:
+%    containerFileName - String. The container, or '' if it could not be
+%                        written (e.g. the folder is read only).
+%    cals              - Cell array of the calibrations, if the .mat file
+%                        had to be loaded, and {} if not.
+%
+% Optional key/value pairs:
+%    'WriteCacheFiles' - Boolean. Write the container when it is not up
+%                        to date. Default true.  With false, nothing is
+%                        written to the calibration folder, and
+%                        containerFileName is '' when the container is
+%                        not up to date.
+%
+% See also:
+%    OLWriteCalibrationFile, OLReadCalibrationFile, OLGetCalibrationStructure
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      Added 'WriteCacheFiles', and warn when the container
+%                  cannot be read or written.
+
+parser = inputParser();
+parser.addRequired('calType',@ischar);
+parser.addRequired('calFolder',@ischar);
+parser.addParameter('WriteCacheFiles',true,@islogical);
+parser.parse(calType,calFolder,varargin{:});
+
+calFileName = fullfile(calFolder, ['OL' calType '.mat']);
+containerFileName = fullfile(calFolder, ['OL' calType '.olcal']);
+cals = {};
+
+% Current if it was written from the .mat file as it is now
+calInfo = dir(calFileName);
+assert(numel(calInfo) == 1,'OneLightToolbox:OLUpdateCalibrationContainer:NoCalFile', ...
+    'Could not find %s',calFileName);
+if (exist(containerFileName, 'file'))
+    try
+        [~, header] = OLReadCalibrationFile(containerFileName, 'calibrations', []);
+        if (header.sourceBytes == calInfo.bytes && header.sourceDatenum == calInfo.datenum)
+            return;
+        end
+    catch e
+        warning('OneLightToolbox:OLUpdateCalibrationContainer:BadContainer', ...
+            'Could not read %s, so it is written again: %s', containerFileName, e.message);
+    end
+end
+
+% Write it again.  Not being able to is no reason to stop, since the
+% caller can use the calibrations we loaded.
+[~, cals] = LoadCalFile(['OL' calType], [], calFolder);
+if (~parser.Results.WriteCacheFiles)
+    containerFileName = '';
+    return;
+end
+try
+    OLWriteCalibrationFile(containerFileName, cals, 'sourceFile', calFileName);
+catch e
+    warning('OneLightToolbox:OLUpdateCalibrationContainer:CannotWrite', ...
+        'Could not write %s: %s', containerFileName, e.message);
+    containerFileName = '';
+end
+
+end
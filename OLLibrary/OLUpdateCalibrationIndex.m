@@ -0,0 +1,199 @@
+function calibrationIndex = OLUpdateCalibrationIndex(calFolder, varargin)
+% Bring the index of the calibrations in a folder up to date
+%
+% Syntax:
+%   calibrationIndex = OLUpdateCalibrationIndex(calFolder)
+%   calibrationIndex = OLUpdateCalibrationIndex(calFolder,'CalibrationTypes',{'BoxDLiquidShortCableDEyePiece1_ND04'})
+%   calibrationIndex = OLUpdateCalibrationIndex(calFolder,'WriteCacheFiles',false)
+%
+% Description:
+%    The index lists every calibration in the OL*.mat files of a folder,
+%    with its type, date, box and a summary of its first state tracking
+%    measurements (see OLCalibrationStateSummary), so that calibrations
+%    can be found without opening the files (see OLFindCalibrations).  It
+%    is kept in CalibrationIndex.olidx in the folder, a MAT file.
+%
+%    The index remembers the size and modification date of each file it
+%    indexed, and only files that are new or changed since are opened,
+%    through their calibration containers (see
+%    OLUpdateCalibrationContainer).  When nothing changed this costs one
+%    directory listing.  Within a session the index is kept in memory, and
+%    loaded again only when the index file changes.
+%
+%    So by default this writes CalibrationIndex.olidx, and an OL*.olcal
+%    container for each calibration file, into the calibration folder.
+%    Pass 'WriteCacheFiles' false to write nothing there; the index is then
+%    kept in memory only, and files whose containers are not up to date
+%    are loaded in full each time they are indexed.
+%
+%    Files that cannot be indexed, such as temporary cal progression
+%    files, are reported with a warning, and not tried again until they
+%    change or their type is passed in 'CalibrationTypes'.
+%
+%    Index entries are sorted by calibration type and then date, and
+%    calibrationIndex.keys holds typeRank*1e6 + datenum for each, typeRank
+%    being the position of the type in the sorted calibrationIndex.calTypes,
+%    so that the entries of a type, or of a type and date range, are found
+%    by binary search.
+%
+% Inputs:
+%    calFolder          - String. Folder of the calibration files.
+%
+% Outputs:
+%    calibrationIndex   - Struct with fields version, files (name, bytes,
+%                         datenum and calType of each file indexed),
+%                         calTypes, entries and keys.  Each entry has
+%                         fields calType, box, date, dateNum, calNumber
+%                         (position in the file), nStateMeasurements,
+%                         fullOnPower and combCentroid (NaN without state
+%                         measurements).
+%
+% Optional key/value pairs:
+%    'CalibrationTypes' - Cell array of calibration types to index again
+%                         whether or not their files changed. Default {}.
+%    'WriteCacheFiles'  - Boolean. Write the index and the calibration
+%                         containers to the calibration folder. Default
+%                         true.
+%
+% See also:
+%    OLFindCalibrations, OLGetCalibrationStructure, OLInitAndSaveCal
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      Warn about what cannot be read, indexed or saved.
+%                  Added 'WriteCacheFiles'.
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('calFolder',@ischar);
+parser.addParameter('CalibrationTypes',{},@iscellstr);
+parser.addParameter('WriteCacheFiles',true,@islogical);
+parser.parse(calFolder,varargin{:});
+writeCacheFiles = parser.Results.WriteCacheFiles;
+
+%% The index as it was
+persistent cachedIndex cachedIndexFileName cachedIndexDatenum;
+indexFileName = fullfile(calFolder,'CalibrationIndex.olidx');
+indexInfo = dir(indexFileName);
+if (strcmp(indexFileName,cachedIndexFileName) && ...
+        isequal([indexInfo.datenum],cachedIndexDatenum))
+    % Unchanged since we saved it, or only ever kept in memory
+    calibrationIndex = cachedIndex;
+elseif (numel(indexInfo) == 1)
+    try
+        loaded = load(indexFileName,'-mat','calibrationIndex');
+        calibrationIndex = loaded.calibrationIndex;
+    catch e
+        warning('OneLightToolbox:OLUpdateCalibrationIndex:BadIndex', ...
+            'Could not load %s, so the index is made again: %s', indexFileName, e.message);
+        calibrationIndex = emptyIndex();
+    end
+else
+    calibrationIndex = emptyIndex();
+end
+
+%% Files that are new, changed, gone, or to be indexed regardless
+listing = dir(fullfile(calFolder,'OL*.mat'));
+listing = listing(~[listing.isdir]);
+[isKnown, known] = ismember({listing.name},{calibrationIndex.files.name});
+stale = ~isKnown;
+stale(isKnown) = [listing(isKnown).bytes] ~= [calibrationIndex.files(known(isKnown)).bytes] | ...
+    [listing(isKnown).datenum] ~= [calibrationIndex.files(known(isKnown)).datenum];
+calTypes = arrayfun(@(f) f.name(3:end-4),listing,'UniformOutput',false)';
+stale = stale | ismember(calTypes,parser.Results.CalibrationTypes);
+gone = ~ismember({calibrationIndex.files.name},{listing.name});
+
+if (any(stale) || any(gone))
+    %% Index the stale files again
+    keep = ~ismember({calibrationIndex.entries.calType},[calTypes(stale) {calibrationIndex.files(gone).calType}]);
+    entries = calibrationIndex.entries(keep);
+    for k = find(stale)
+        try
+            entries = [entries indexCalibrationFile(calTypes{k},calFolder,writeCacheFiles)]; %#ok<AGROW>
+        catch e
+            % Not a calibration file (e.g. a temporary cal progression
+            % file), or a broken one.  It is listed in files, so it is not
+            % tried again until it changes.
+            warning('OneLightToolbox:OLUpdateCalibrationIndex:CannotIndex', ...
+                'Could not index %s, which is skipped until it changes: %s', listing(k).name, e.message);
+        end
+    end
+    calibrationIndex.files = struct('name',{listing.name},'bytes',{listing.bytes}, ...
+        'datenum',{listing.datenum},'calType',calTypes);
+
+    %% Sort, and make the search keys
+    calibrationIndex.calTypes = unique({entries.calType});
+    [~, typeRank] = ismember({entries.calType},calibrationIndex.calTypes);
+    keys = typeRank*1e6 + [entries.dateNum];
+    [calibrationIndex.keys, order] = sort(keys(:));
+    calibrationIndex.entries = entries(order);
+
+    %% Save it, if we can and may
+    indexInfo = [];
+    if (writeCacheFiles)
+        try
+            save(indexFileName,'calibrationIndex','-mat');
+            indexInfo = dir(indexFileName);
+        catch e
+            warning('OneLightToolbox:OLUpdateCalibrationIndex:CannotSave', ...
+                'Could not save %s, so the index is kept in memory only: %s', indexFileName, e.message);
+        end
+    end
+end
+
+%% Keep it for next time, with the date of the file it was saved in
+cachedIndex = calibrationIndex;
+cachedIndexFileName = indexFileName;
+if (numel(indexInfo) == 1)
+    cachedIndexDatenum = indexInfo.datenum;
+else
+    cachedIndexDatenum = [];
+end
+
+end
+
+function calibrationIndex = emptyIndex()
+calibrationIndex.version = 1;
+calibrationIndex.files = struct('name',{},'bytes',{},'datenum',{},'calType',{});
+calibrationIndex.calTypes = {};
+calibrationIndex.entries = struct('calType',{},'box',{},'date',{},'dateNum',{},'calNumber',{}, ...
+    'nStateMeasurements',{},'fullOnPower',{},'combCentroid',{});
+calibrationIndex.keys = zeros(0,1);
+end
+
+function entries = indexCalibrationFile(calType, calFolder, writeCacheFiles)
+% Index entries for the calibrations in one file, read from its container
+[containerFileName, cals] = OLUpdateCalibrationContainer(calType, calFolder, 'WriteCacheFiles', writeCacheFiles);
+if (isempty(cals))
+    cals = OLReadCalibrationFile(containerFileName, 'fields', ...
+        {'describe.date','describe.S','raw.powerFluctuationMeas','raw.spectralShiftsMeas'});
+end
+
+entries = struct('calType',{},'box',{},'date',{},'dateNum',{},'calNumber',{}, ...
+    'nStateMeasurements',{},'fullOnPower',{},'combCentroid',{});
+for k = 1:numel(cals)
+    entry.calType = calType;
+    entry.box = regexp(calType,'Box[A-Z]','match','once');
+    entry.date = cals{k}.describe.date;
+    try
+        entry.dateNum = datenum(entry.date);
+    catch e
+        warning('OneLightToolbox:OLUpdateCalibrationIndex:BadDate', ...
+            'Calibration %d of %s has date ''%s'', which is indexed as 0: %s', k, calType, entry.date, e.message);
+        entry.dateNum = 0;
+    end
+    entry.calNumber = k;
+    entry.nStateMeasurements = 0;
+    entry.fullOnPower = NaN;
+    entry.combCentroid = NaN;
+    if (isfield(cals{k},'raw') && isfield(cals{k}.raw,'powerFluctuationMeas') && ...
+            isfield(cals{k}.raw,'spectralShiftsMeas') && ~isempty(cals{k}.raw.spectralShiftsMeas.measSpd))
+        entry.nStateMeasurements = size(cals{k}.raw.powerFluctuationMeas.measSpd,2);
+        summary = OLCalibrationStateSummary(cals{k}.raw.powerFluctuationMeas.measSpd(:,1), ...
+            cals{k}.raw.spectralShiftsMeas.measSpd(:,1), cals{k}.describe.S);
+        entry.fullOnPower = summary.fullOnPower;
+        entry.combCentroid = summary.combCentroid;
+    end
+    entries(end+1) = entry; %#ok<AGROW>
+end
+end
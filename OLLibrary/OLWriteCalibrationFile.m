@@ -0,0 +1,220 @@
+function header = OLWriteCalibrationFile(fileName, cals, varargin)
+% Write calibrations to a binary container that can be read field by field
+%
+% Syntax:
+%   OLWriteCalibrationFile(fileName, cals)
+%   OLWriteCalibrationFile(fileName, cals, 'sourceFile', calMatFileName)
+%   header = OLWriteCalibrationFile(...)
+%
+% Description:
+%    A calibration .mat file has to be loaded whole, with every
+%    calibration in it and all of their raw measurements, to use one
+%    calibration's computed fields.  This writes the same calibrations to
+%    a container from which OLReadCalibrationFile reads only the
+%    calibrations and fields asked for, memory mapping the file so that
+%    nothing else is read from disk.
+%
+%    Each calibration is flattened into entries, one for every struct
+%    and cell in it and one for every array, each identified by its path
+%    from the top of the calibration, such as '.computed.pr650M',
+%    '.raw.gamma.rad(2).meas' or '' for the calibration struct itself.
+%    The entries are in depth first order, so a struct or cell comes
+%    before what is in it.
+%
+%    The file is little-endian and laid out as follows.
+%
+%    Header, at byte 0:
+%       char[8]   'OLCALFIL'
+%       uint32    format version (1)
+%       uint32    number of calibrations
+%       uint32    number of entries, N
+%       uint32    number of bytes of path text
+%       uint32    number of dimension values, D
+%       uint32    0
+%       double    size in bytes of the source file, NaN if not given
+%       double    modification datenum of the source file, NaN if not given
+%       uint64    data offset, in bytes from start of file
+%
+%    Index, at byte 56:
+%       uint32[N] calibration number of each entry
+%       uint32[N] kind of each entry (0 = struct, 1 = cell, 2 = array,
+%                 3 = anything else, serialized)
+%       uint32[N] class of each array, as an index into
+%                 {'double','single','logical','char','int8','uint8',
+%                 'int16','uint16','int32','uint32','int64','uint64'}
+%       uint32[N] number of dimensions of each entry
+%       uint64[N] offset of each entry's data, from start of file
+%       uint64[N] number of bytes of each entry's data
+%       uint32[D] the dimensions of all entries, one after the other
+%       char[]    the paths, each followed by a newline, zero padded to a
+%                 multiple of 8 bytes
+%
+%    Data, at data offset, each entry's starting on a multiple of 8
+%    bytes:
+%       struct    its field names, each followed by a newline
+%       cell      nothing
+%       array     its values in column major order, logical as uint8 and
+%                 char as uint16
+%       other     the bytes of getByteStreamFromArray
+%
+%    Arrays are stored as they are in memory, so reading one is a copy
+%    out of the mapped file.
+%
+% Inputs:
+%    fileName     - String. File to write.
+%    cals         - Cell array of calibration structs, as saved in a
+%                   calibration .mat file.
+%
+% Outputs:
+%    header       - Struct with the header information written.
+%
+% Optional key/value pairs:
+%    'sourceFile' - String. The .mat file the calibrations came from.  Its
+%                   size and modification date are recorded, so readers can
+%                   tell whether the container is up to date with it.
+%                   Default ''.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLReadCalibrationFile, OLGetCalibrationStructure, OLInitAndSaveCal
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    calFolder = fileparts(which('OLDemoCal.mat'));
+    [~, cals] = LoadCalFile('OLDemoCal', [], calFolder);
+    fileName = fullfile(tempdir,'OLDemoCal.olcal');
+    OLWriteCalibrationFile(fileName, cals, 'sourceFile', fullfile(calFolder,'OLDemoCal.mat'));
+
+    % Everything but the raw measurements of the latest calibration
+    [~, header] = OLReadCalibrationFile(fileName, 'calibrations', []);
+    fields = setdiff(header.fieldNames{end}, {'raw'}, 'stable');
+    cal = OLReadCalibrationFile(fileName, 'calibrations', header.nCalibrations, 'fields', fields);
+    assert(isequal(cal.computed, cals{end}.computed) && ~isfield(cal, 'raw'));
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('fileName',@ischar);
+parser.addRequired('cals',@iscell);
+parser.addParameter('sourceFile','',@ischar);
+parser.parse(fileName,cals,varargin{:});
+
+%% Flatten the calibrations into entries
+entries = struct('calibration',{},'kind',{},'class',{},'dims',{},'path',{},'data',{});
+for k = 1:numel(cals)
+    entries = flatten(entries, k, '', cals{k});
+end
+nEntries = numel(entries);
+
+%% Header
+header.version = 1;
+header.nCalibrations = numel(cals);
+header.sourceBytes = NaN;
+header.sourceDatenum = NaN;
+if (~isempty(parser.Results.sourceFile))
+    info = dir(parser.Results.sourceFile);
+    assert(numel(info) == 1,'OneLightToolbox:OLWriteCalibrationFile:NoSourceFile', ...
+        'Could not find %s',parser.Results.sourceFile);
+    header.sourceBytes = info.bytes;
+    header.sourceDatenum = info.datenum;
+end
+
+dims = [entries.dims];
+% Joined rather than printed, since sprintf would skip the empty root path
+pathText = uint8([strjoin({entries.path},char(10)) char(10)]);
+indexBytes = 4*4*nEntries + 2*8*nEntries + 4*numel(dims) + numel(pathText);
+nPad = mod(-(56 + indexBytes), 8);
+header.dataOffset = 56 + indexBytes + nPad;
+
+dataBytes = arrayfun(@(e) numel(e.data), entries);
+paddedBytes = dataBytes + mod(-dataBytes, 8);
+offsets = header.dataOffset + [0 cumsum(paddedBytes(1:end-1))];
+
+%% Write it
+fid = fopen(fileName,'w','ieee-le');
+assert(fid >= 0,'OneLightToolbox:OLWriteCalibrationFile:CannotOpen', ...
+    'Could not open %s for writing',fileName);
+cleanup = onCleanup(@() fclose(fid));
+
+fwrite(fid,'OLCALFIL','char');
+fwrite(fid,[header.version header.nCalibrations nEntries numel(pathText) numel(dims) 0],'uint32');
+fwrite(fid,[header.sourceBytes header.sourceDatenum],'double');
+fwrite(fid,header.dataOffset,'uint64');
+
+fwrite(fid,[entries.calibration],'uint32');
+fwrite(fid,[entries.kind],'uint32');
+fwrite(fid,[entries.class],'uint32');
+fwrite(fid,arrayfun(@(e) numel(e.dims), entries),'uint32');
+fwrite(fid,offsets,'uint64');
+fwrite(fid,dataBytes,'uint64');
+fwrite(fid,dims,'uint32');
+fwrite(fid,pathText,'uint8');
+fwrite(fid,zeros(1,nPad),'uint8');
+
+for k = 1:nEntries
+    fwrite(fid,entries(k).data,'uint8');
+    fwrite(fid,zeros(1,paddedBytes(k)-dataBytes(k)),'uint8');
+end
+
+end
+
+function entries = flatten(entries, calibration, path, value)
+% Add the entry for value, then those of whatever is in it.
+classNames = {'double','single','logical','char','int8','uint8', ...
+    'int16','uint16','int32','uint32','int64','uint64'};
+classIndex = find(strcmp(class(value),classNames));
+entry = struct('calibration',calibration,'kind',0,'class',0, ...
+    'dims',size(value),'path',path,'data',[]);
+
+if (isstruct(value))
+    names = fieldnames(value);
+    entry.kind = 0;
+    entry.data = uint8(sprintf('%s\n',names{:}));
+    entries(end+1) = entry;
+    for i = 1:numel(value)
+        if (numel(value) == 1)
+            elementPath = path;
+        else
+            elementPath = sprintf('%s(%d)',path,i);
+        end
+        for f = 1:numel(names)
+            entries = flatten(entries, calibration, [elementPath '.' names{f}], value(i).(names{f}));
+        end
+    end
+
+elseif (iscell(value))
+    entry.kind = 1;
+    entry.data = zeros(1,0,'uint8');
+    entries(end+1) = entry;
+    for i = 1:numel(value)
+        entries = flatten(entries, calibration, sprintf('%s{%d}',path,i), value{i});
+    end
+
+elseif (~isempty(classIndex) && isreal(value) && ~issparse(value))
+    entry.kind = 2;
+    entry.class = classIndex;
+    switch (class(value))
+        case 'logical'
+            value = uint8(value);
+        case 'char'
+            value = uint16(value);
+    end
+    if (isempty(value))
+        entry.data = zeros(1,0,'uint8');
+    else
+        entry.data = typecast(value(:)','uint8');
+    end
+    entries(end+1) = entry;
+
+else
+    % Objects, function handles, complex and sparse arrays
+    entry.kind = 3;
+    entry.data = getByteStreamFromArray(value);
+    entry.data = entry.data(:)';
+    entries(end+1) = entry;
+end
+end
@@ -0,0 +1,153 @@
+function header = OLWriteStartsStopsFile(fileName, starts, stops, varargin)
+% Write a sequence of mirror patterns to a compact binary file
+%
+% Syntax:
+%   OLWriteStartsStopsFile(fileName, starts, stops)
+%   OLWriteStartsStopsFile(...,'calID',OLGetCalID(cal),'frameRateHz',200)
+%   OLWriteStartsStopsFile(...,'compression','delta')
+%   header = OLWriteStartsStopsFile(...)
+%
+% Description:
+%    Store the starts/stops for a whole modulation, as returned by
+%    OLPrimaryToStartsStops, so that a session can load precomputed
+%    patterns instead of regenerating them.  Starts and stops are stored
+%    as uint16, which is a quarter of the size of the double matrices.
+%
+%    The file is little-endian and laid out as follows.
+%
+%    Header, at byte 0:
+%       char[8]   'OLPATSEQ'
+%       uint32    format version (1)
+%       uint32    compression (0 = none, 1 = delta)
+%       uint32    number of frames
+%       uint32    number of mirror columns
+%       double    frame rate (Hz), NaN if not given
+%       uint32    length of calibration ID
+%       uint32    data offset, in bytes from start of file
+%       char[]    calibration ID, zero padded to a multiple of 8 bytes
+%
+%    Uncompressed data, at data offset:
+%       For each frame, nCols uint16 starts followed by nCols uint16
+%       stops.  Each frame is therefore a fixed size record, and the data
+%       can be memory mapped directly; see OLReadStartsStopsFile.
+%
+%    Delta compressed data, at data offset:
+%       uint64[nFrames] byte offset of each frame record from start of
+%       file, then for each frame a record of uint16 values:
+%          type (0 = full frame, 1 = changes from previous frame)
+%          number of changed column runs K (0 for a full frame)
+%          full frame:  nCols starts, nCols stops
+%          delta frame: K pairs of first/last column (1-based), then the
+%                       starts, then the stops, of the changed columns
+%       A full frame is stored every keyframeInterval frames, so that
+%       reading a frame never needs more than that many records.
+%
+% Inputs:
+%    fileName           - String. File to write.
+%    starts             - nFrames x nCols matrix of starts.
+%    stops              - nFrames x nCols matrix of stops.
+%
+% Outputs:
+%    header             - Struct with the header information written.
+%
+% Optional key/value pairs:
+%    'calID'            - String. Calibration ID the patterns were
+%                         computed with, see OLGetCalID. Default ''.
+%    'frameRateHz'      - Scalar. Rate the patterns are to be shown at.
+%                         Default NaN.
+%    'compression'      - String. 'none' (default) or 'delta'.
+%    'keyframeInterval' - Scalar. For 'delta', a full frame is stored
+%                         every this many frames. Default 200.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OLReadStartsStopsFile, OLDeltaEncodeStartsStops, OLPrimaryToStartsStops
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    calibration = OLGetCalibrationStructure('CalibrationFolder',fileparts(which('OLDemoCal.mat')),'CalibrationType','DemoCal');
+    P = calibration.describe.numWavelengthBands;
+    timebase = linspace(0,5,200*5);
+    primaryWaveform = OLPrimaryWaveform(.5*ones(P,1), .5+.5*sin(2*pi*timebase));
+    [starts,stops] = OLPrimaryToStartsStops(primaryWaveform,calibration);
+
+    fileName = fullfile(tempdir,'modulation.olpat');
+    OLWriteStartsStopsFile(fileName,starts,stops, ...
+        'calID',OLGetCalID(calibration),'frameRateHz',200,'compression','delta');
+    [starts2,stops2,header] = OLReadStartsStopsFile(fileName);
+    assert(isequal(starts,starts2) && isequal(stops,stops2));
+%}
+
+%% Input validation
+parser = inputParser();
+parser.addRequired('fileName',@ischar);
+parser.addRequired('starts',@isnumeric);
+parser.addRequired('stops',@isnumeric);
+parser.addParameter('calID','',@ischar);
+parser.addParameter('frameRateHz',NaN,@isscalar);
+parser.addParameter('compression','none',@(x) any(strcmp(x,{'none','delta'})));
+parser.addParameter('keyframeInterval',200,@isscalar);
+parser.parse(fileName,starts,stops,varargin{:});
+
+assert(isequal(size(starts),size(stops)), ...
+    'OneLightToolbox:OLWriteStartsStopsFile:SizeMismatch', ...
+    'starts and stops matrices must be the same size');
+assert(all(starts(:) >= 0 & starts(:) <= intmax('uint16') & starts(:) == round(starts(:))) && ...
+    all(stops(:) >= 0 & stops(:) <= intmax('uint16') & stops(:) == round(stops(:))), ...
+    'OneLightToolbox:OLWriteStartsStopsFile:BadValues', ...
+    'starts and stops must be integers that fit in uint16');
+[nFrames, nCols] = size(starts);
+
+%% Header
+header.version = 1;
+header.compression = parser.Results.compression;
+header.nFrames = nFrames;
+header.nCols = nCols;
+header.frameRateHz = parser.Results.frameRateHz;
+header.calID = parser.Results.calID;
+calIDBytes = uint8(header.calID);
+nPad = mod(-(40 + numel(calIDBytes)), 8);
+header.dataOffset = 40 + numel(calIDBytes) + nPad;
+
+fid = fopen(fileName,'w','ieee-le');
+assert(fid >= 0,'OneLightToolbox:OLWriteStartsStopsFile:CannotOpen', ...
+    'Could not open %s for writing',fileName);
+cleanup = onCleanup(@() fclose(fid));
+
+fwrite(fid,'OLPATSEQ','char');
+fwrite(fid,[header.version strcmp(header.compression,'delta') nFrames nCols],'uint32');
+fwrite(fid,header.frameRateHz,'double');
+fwrite(fid,[numel(calIDBytes) header.dataOffset],'uint32');
+fwrite(fid,calIDBytes,'uint8');
+fwrite(fid,zeros(1,nPad),'uint8');
+
+%% Data
+switch (header.compression)
+    case 'none'
+        % Frame-major, so each frame is one contiguous record.
+        fwrite(fid,[starts' ; stops'],'uint16');
+
+    case 'delta'
+        % Encode each frame as a uint16 record first, so we know the
+        % offsets to write in the index ahead of the records.
+        records = cell(nFrames,1);
+        for k = 1:nFrames
+            if (mod(k-1,parser.Results.keyframeInterval) == 0)
+                records{k} = [0 0 starts(k,:) stops(k,:)];
+            else
+                ranges = OLChangedColumnRanges(starts(k-1,:),stops(k-1,:),starts(k,:),stops(k,:));
+                cols = cell2mat(arrayfun(@(r) ranges(r,1):ranges(r,2),(1:size(ranges,1))','UniformOutput',false)');
+                records{k} = [1 size(ranges,1) reshape(ranges',1,[]) starts(k,cols) stops(k,cols)];
+            end
+        end
+        recordBytes = 2*cellfun(@numel,records);
+        offsets = header.dataOffset + 8*nFrames + [0 ; cumsum(recordBytes(1:end-1))];
+        fwrite(fid,offsets,'uint64');
+        fwrite(fid,[records{:}],'uint16');
+end
+
+end
@@ -1,17 +1,30 @@
-function [omniRelSpectrum,wls] = OmniRawToRelative(omniCal,omniRawSpectrum)
+function [omniRelSpectrum,wls] = OmniRawToRelative(omniCal,omniRawSpectrum,varargin)
 % [omniRelSpectrum,omniWls] = OmniRawToRelative(omniCal,omniRawSpectrum)
+% [omniRelSpectrum,omniWls] = OmniRawToRelative(omniCal,omniRawSpectrum,'resampler',resampler)
 %
 % Convert a raw spectrum measured with the omni to a calibrated relative 
 % spectrum.  Uses the calibration structure.  Retruned spectrum is splined
 % onto evenly spaced wavelengths with the span of omniCal.commonWls and
 % the same number of samples as omniCal.commonWls.
 %
-% See also CalibrateOmniRelativeSensitivity, AnalyzeOmniRelativeSensitivity
+% omniRawSpectrum may have one raw spectrum per column, and they are all
+% converted at once.  The conversion is done by the sparse weights built
+% by OmniRawToRelativeResampler.  When converting many spectra with the
+% same omniCal, build the resampler once and pass it with the 'resampler'
+% key.
+%
+% See also CalibrateOmniRelativeSensitivity, AnalyzeOmniRelativeSensitivity,
+%   OmniRawToRelativeResampler.
 %
 % 8/5/12  dhb  Wrote it.
+% 10/18/26     Use precomputed interpolation weights.
+
+parser = inputParser;
+parser.addParameter('resampler',[],@(x) isempty(x) || isstruct(x));
+parser.parse(varargin{:});
+resampler = parser.Results.resampler;
+if (isempty(resampler))
+    resampler = OmniRawToRelativeResampler(omniCal);
+end
 
-omniRawSpectrumCommon = interp1(omniCal.omniwls,omniRawSpectrum,omniCal.commonWls);
-omniWls = omniCal.commonWls;
-omniRelSpectrum = omniRawSpectrumCommon.*omniCal.omniCorrect;
-wls = linspace(omniCal.commonWls(1),omniCal.commonWls(end),length(omniCal.commonWls))';
-omniRelSpectrum = interp1(omniCal.commonWls,omniRelSpectrum,wls);
\ No newline at end of file
+[omniRelSpectrum,wls] = resampler.apply(omniRawSpectrum);
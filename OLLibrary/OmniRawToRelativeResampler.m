@@ -0,0 +1,109 @@
+function resampler = OmniRawToRelativeResampler(omniCal)
+% Precompute the conversion of raw omni spectra to relative spectra
+%
+% Syntax:
+%   resampler = OmniRawToRelativeResampler(omniCal)
+%   [omniRelSpectra,wls] = resampler.apply(omniRawSpectra)
+%
+% Description:
+%    OmniRawToRelative interpolates a raw spectrum onto omniCal.commonWls,
+%    multiplies by omniCal.omniCorrect, and interpolates again onto evenly
+%    spaced wavelengths.  Each of these steps is linear with weights that
+%    depend only on the wavelengths in omniCal, so together they are a
+%    single sparse matrix, with at most four nonzeros per row.  This
+%    routine builds that matrix once per omniCal, and the apply field then
+%    converts a whole batch of raw spectra (one per column) with one sparse
+%    matrix product.
+%
+%    As with interp1, wavelengths outside the range of omniCal.omniwls
+%    come out as NaN.
+%
+%    Pass the resampler to OmniRawToRelative (key 'resampler') to avoid
+%    rebuilding it on every call.
+%
+% Inputs:
+%    omniCal   - Struct. Omni calibration, as used by OmniRawToRelative.
+%
+% Outputs:
+%    resampler - Struct with fields:
+%                  apply      - Function handle, [omniRelSpectra,wls] =
+%                               resampler.apply(omniRawSpectra), for an
+%                               nOmniWls x nSpectra matrix.
+%                  weights    - Sparse nWls x nOmniWls matrix from raw to
+%                               relative spectra, omniCorrect included.
+%                  outOfRange - Logical nWls x 1, wavelengths that come
+%                               out NaN.
+%                  wls        - The evenly spaced output wavelengths.
+%
+% Optional key/value pairs:
+%    None.
+%
+% Examples are provided in the source code.
+%
+% See also:
+%    OmniRawToRelative, OmniRelativeToAbsolute
+
+% History:
+%    10/18/26      Wrote it.
+
+% Examples:
+%{
+    %% Same as converting one spectrum at a time
+    omniCal.omniwls = linspace(340,1030,2048)';
+    omniCal.commonWls = (380:2:780)';
+    omniCal.omniCorrect = 1 + rand(size(omniCal.commonWls));
+    raw = rand(2048,100);
+    resampler = OmniRawToRelativeResampler(omniCal);
+    rel = resampler.apply(raw);
+    assert(max(max(abs(rel(:,7) - OmniRawToRelative(omniCal,raw(:,7))))) < 1e-12);
+%}
+
+%% Raw to common wavelengths
+[rawToCommon, commonIntervals] = linearWeights(omniCal.omniwls, omniCal.commonWls);
+commonOutOfRange = isnan(commonIntervals(:,1));
+
+%% Correction, then common to evenly spaced wavelengths
+resampler.wls = linspace(omniCal.commonWls(1),omniCal.commonWls(end),length(omniCal.commonWls))';
+[commonToEven, evenIntervals] = linearWeights(omniCal.commonWls, resampler.wls);
+nCommon = numel(omniCal.commonWls);
+correct = spdiags(omniCal.omniCorrect(:), 0, nCommon, nCommon);
+resampler.weights = commonToEven * correct * rawToCommon;
+
+%% Which wavelengths come out NaN
+% Those outside the common wavelengths, and those interpolated from a
+% common wavelength that was outside the raw wavelengths.
+resampler.outOfRange = isnan(evenIntervals(:,1));
+inRange = ~resampler.outOfRange;
+resampler.outOfRange(inRange) = any(commonOutOfRange(evenIntervals(inRange,:)),2);
+
+resampler.apply = @(omniRawSpectra) applyResampler(resampler, omniRawSpectra);
+
+end
+
+function [omniRelSpectra, wls] = applyResampler(resampler, omniRawSpectra)
+% Convert a batch of raw spectra
+omniRelSpectra = full(resampler.weights * omniRawSpectra);
+omniRelSpectra(resampler.outOfRange,:) = NaN;
+wls = resampler.wls;
+end
+
+function [weights, intervals] = linearWeights(x, xq)
+% Sparse matrix of linear interpolation weights from samples at x to
+% samples at xq, and the indices of the two samples each one lies
+% between.  Both rows of intervals are NaN for points outside x, and the
+% row of weights is empty.
+x = x(:);
+xq = xq(:);
+assert(all(diff(x) > 0), 'OneLightToolbox:OmniRawToRelativeResampler:NotIncreasing', ...
+    'Wavelengths to interpolate from must be increasing');
+lower = discretize(xq, x);
+inRange = find(~isnan(lower));
+lower = lower(inRange);
+upper = min(lower+1, numel(x));
+t = zeros(size(lower));
+between = (upper > lower);
+t(between) = (xq(inRange(between)) - x(lower(between))) ./ (x(upper(between)) - x(lower(between)));
+weights = sparse([inRange ; inRange], [lower ; upper], [1-t ; t], numel(xq), numel(x));
+intervals = NaN(numel(xq), 2);
+intervals(inRange,:) = [lower upper];
+end
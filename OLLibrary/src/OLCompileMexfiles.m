@@ -0,0 +1,52 @@
+function OLCompileMexfiles
+% Compile the mex files used by OLLibrary
+%
+% Syntax:
+%   OLCompileMexfiles
+%
+% Description:
+%    Compile the C sources in this folder into mex files, placed next to
+%    them.  Each of the routines that uses one of these mex files falls
+%    back to equivalent (slower) MATLAB code when it is not compiled, so
+%    this only needs to be run on machines where the speed matters.
+%
+% See also:
+%    OLGamutKernel, OLFitTwoSidedExponentials, OLTrace, LJTemperatureProbe
+
+% History:
+%    10/18/26      Wrote it.
+%    10/18/26      Add OLTraceMex.
+%    10/18/26      Return to the folder it was called from.
+%    10/18/26      Add LJTemperatureFeedMex.
+
+[dirName, ~] = fileparts(which(mfilename()));
+oldDir = pwd;
+cleanup = onCleanup(@() cd(oldDir)); %#ok<NASGU>
+cd(dirName);
+
+% Gamut truncation, check and margins
+mex -O -output OLGamutKernelMex CFLAGS="\$CFLAGS -Wall -std=c99" OLGamutKernelMex.c
+
+% Two sided exponential fits of comb SPD peaks.  Add OpenMP flags to fit
+% the peaks on separate threads.
+mex -O -output OLTwoSidedExponentialFitMex CFLAGS="\$CFLAGS -Wall -std=c99" OLTwoSidedExponentialFitMex.c
+
+% Timing spans.  The LabJack mex files include OLTrace.h too, see
+% CompileMexfiles in OLLabJackLibrary/src.
+mex -O -output OLTraceMex CFLAGS="\$CFLAGS -Wall -std=c99" OLTraceMex.c
+
+% Reader of the samples LJTemperatureLogger publishes in POSIX shared
+% memory, placed with the other LabJack mex files.  It needs no LabJack
+% driver.
+if (isunix())
+    loggerDir = fullfile(dirName,'..','..','OLLabJackLibrary','src','LJTemperatureLogger');
+    feedFlags = {};
+    if (~ismac())
+        feedFlags = {'-lrt'};
+    end
+    mex('-O','-output','LJTemperatureFeedMex','-outdir',fullfile(loggerDir,'..'), ...
+        'CFLAGS=$CFLAGS -Wall -std=c99',['-I' loggerDir],feedFlags{:}, ...
+        fullfile(loggerDir,'LJTemperatureFeedMex.c'));
+end
+
+end
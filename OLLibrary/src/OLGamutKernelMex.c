@@ -0,0 +1,83 @@
+// *** Filename: OLGamutKernelMex.c
+// *** Purpose: Single pass tolerance truncation, gamut check and gamut
+//          margins for a matrix of primaries.  Called by OLGamutKernel,
+//          which documents the arguments and falls back to the
+//          equivalent MATLAB code when this is not compiled.
+//
+//          [primary, inGamut, gamutMargins] = OLGamutKernelMex(primary, gamutMin, gamutMax, primaryTolerance)
+//
+//          The per element arithmetic is exactly that of
+//          OLTruncateGamutTolerance, so results are bit for bit the same
+//          as the MATLAB path.
+// *** Date: 10-18-2026
+
+#include <math.h>
+#include "mex.h"
+#include "matrix.h"
+
+/* Getaway function */
+void mexFunction(int nlhs,      /* number of output (return) arguments */
+      mxArray *plhs[],          /* pointer to an array which will hold the output data, each element is of type: mxArray */
+      int nrhs,                 /* number of input arguments */
+      const mxArray *prhs[]     /* pointer to an array which holds the input data, each element is of type: const mxArray */
+      )
+{
+    if (nrhs != 4) {
+        mexErrMsgTxt("OLGamutKernelMex: Requires four input arguments.");
+    }
+    if (!mxIsDouble(prhs[0]) || mxIsComplex(prhs[0]) || mxIsSparse(prhs[0])) {
+        mexErrMsgTxt("OLGamutKernelMex: Primaries must be a real, full, double matrix.");
+    }
+
+    const double gamutMin = mxGetScalar(prhs[1]);
+    const double gamutMax = mxGetScalar(prhs[2]);
+    const double tolerance = mxGetScalar(prhs[3]);
+    const size_t n = mxGetNumberOfElements(prhs[0]);
+    const double *in = mxGetPr(prhs[0]);
+
+    /* Output primaries, same shape as input */
+    plhs[0] = mxCreateNumericArray(mxGetNumberOfDimensions(prhs[0]), mxGetDimensions(prhs[0]), mxDOUBLE_CLASS, mxREAL);
+    double *out = mxGetPr(plhs[0]);
+
+    /* One pass: truncate by up to tolerance towards the gamut, then keep
+       track of the extremes of the truncated values.  NaNs fail both
+       comparisons and so are skipped, as min and max skip them. */
+    double lo = INFINITY;
+    double hi = -INFINITY;
+    size_t nValid = 0;
+    for (size_t i = 0; i < n; i++) {
+        double v = in[i];
+
+        double error = v - gamutMax;
+        if (error > 0) {
+            v = v - ((error < tolerance) ? error : tolerance);
+        }
+        error = v - gamutMin;
+        if (error < 0) {
+            v = v - ((error > -tolerance) ? error : -tolerance);
+        }
+        out[i] = v;
+
+        if (v < lo) lo = v;
+        if (v > hi) hi = v;
+        if (v == v) nValid++;
+    }
+
+    /* Margins, as OLGamutMargins: positive inside gamut */
+    double marginLow = lo - gamutMin;
+    double marginHigh = gamutMax - hi;
+    if (nValid == 0) {
+        marginLow = mxGetNaN();
+        marginHigh = mxGetNaN();
+    }
+
+    if (nlhs > 1) {
+        plhs[1] = mxCreateLogicalScalar((marginLow >= 0) && (marginHigh >= 0));
+    }
+    if (nlhs > 2) {
+        plhs[2] = mxCreateDoubleMatrix(1, 2, mxREAL);
+        double *margins = mxGetPr(plhs[2]);
+        margins[0] = marginLow;
+        margins[1] = marginHigh;
+    }
+}
@@ -0,0 +1,125 @@
+// *** Filename: OLTrace.h
+// *** Purpose: Timing spans for the C code of the toolbox.  A source file
+//          that includes this gets its own buffer of span events, a ring
+//          of the last OLTRACE_CAPACITY of them, and records into it with
+//
+//              OLTraceBegin("name");
+//              ...
+//              OLTraceEnd("name");
+//
+//          Names are not copied, so they must be string literals (or
+//          otherwise live as long as the mex file).  Times are
+//          nanoseconds of the monotonic clock, the same clock in every
+//          mex file, so the buffers of different mex files can be merged.
+//          Recording takes a clock read and a store, tens of nanoseconds.
+//
+//          A mex file hands its events to MATLAB with
+//          OLTraceEventsToMx, typically from a 'traceEvents' command, and
+//          OLTraceExport puts them in the exported trace.  The buffer is
+//          not locked: the mex functions that record into it are called
+//          from the MATLAB thread only.
+//
+//          On Linux with -std=c99 or later, define _POSIX_C_SOURCE (as
+//          OLTraceMex.c does) for clock_gettime.
+// *** Date: 10-18-2026
+
+#ifndef OLTRACE_H
+#define OLTRACE_H
+
+#include <stdint.h>
+#include <string.h>
+#if defined(_WIN32)
+#include <windows.h>
+#elif defined(__APPLE__)
+#include <mach/mach_time.h>
+#else
+#include <time.h>
+#endif
+
+#ifndef OLTRACE_CAPACITY
+#define OLTRACE_CAPACITY    65536
+#endif
+
+typedef struct {
+    const char *name;
+    uint64_t t;
+    char phase;                 /* 'B' begin, 'E' end */
+} OLTraceEvent;
+
+static OLTraceEvent olTraceEvents[OLTRACE_CAPACITY];
+static uint64_t olTraceCount = 0;      /* Events ever recorded */
+static int olTraceEnabled = 1;
+
+/* Nanoseconds of the monotonic clock */
+static inline uint64_t OLTraceNow(void)
+{
+#if defined(_WIN32)
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER counter;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&counter);
+    return (uint64_t)((double)counter.QuadPart * 1e9 / (double)frequency.QuadPart);
+#elif defined(__APPLE__)
+    static mach_timebase_info_data_t timebase;
+    if (timebase.denom == 0) {
+        mach_timebase_info(&timebase);
+    }
+    return mach_absolute_time() * timebase.numer / timebase.denom;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000000u + (uint64_t)now.tv_nsec;
+#endif
+}
+
+static inline void OLTraceRecord(const char *name, char phase)
+{
+    if (!olTraceEnabled) {
+        return;
+    }
+    OLTraceEvent *event = &olTraceEvents[olTraceCount % OLTRACE_CAPACITY];
+    event->name = name;
+    event->phase = phase;
+    event->t = OLTraceNow();
+    olTraceCount++;
+}
+
+#define OLTraceBegin(name)  OLTraceRecord((name), 'B')
+#define OLTraceEnd(name)    OLTraceRecord((name), 'E')
+
+#ifdef MATLAB_MEX_FILE
+#include "mex.h"
+#include "matrix.h"
+
+/* The events still in the buffer, oldest first, as a struct with fields
+   name (n x 1 cell), phase (n x 1 char) and t (n x 1 uint64, ns). */
+static inline mxArray *OLTraceEventsToMx(void)
+{
+    const char *fieldNames[] = {"name", "phase", "t"};
+    uint64_t first = (olTraceCount > OLTRACE_CAPACITY) ? olTraceCount - OLTRACE_CAPACITY : 0;
+    size_t n = (size_t)(olTraceCount - first);
+
+    mwSize dims[2] = {n, 1};
+    mxArray *names = mxCreateCellMatrix(n, 1);
+    mxArray *phases = mxCreateCharArray(2, dims);
+    mxArray *times = mxCreateNumericMatrix(n, 1, mxUINT64_CLASS, mxREAL);
+    mxChar *phase = mxGetChars(phases);
+    uint64_t *t = (uint64_t *)mxGetData(times);
+    for (size_t i = 0; i < n; i++) {
+        const OLTraceEvent *event = &olTraceEvents[(first + i) % OLTRACE_CAPACITY];
+        mxSetCell(names, i, mxCreateString(event->name));
+        phase[i] = event->phase;
+        t[i] = event->t;
+    }
+
+    mxArray *events = mxCreateStructMatrix(1, 1, 3, fieldNames);
+    mxSetField(events, 0, "name", names);
+    mxSetField(events, 0, "phase", phases);
+    mxSetField(events, 0, "t", times);
+    return events;
+}
+#endif /* MATLAB_MEX_FILE */
+
+#endif /* OLTRACE_H */
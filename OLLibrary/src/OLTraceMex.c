@@ -0,0 +1,123 @@
+// *** Filename: OLTraceMex.c
+// *** Purpose: Timing spans recorded from MATLAB, into the buffer of
+//          OLTrace.h.  Called by OLTrace, which documents the commands and
+//          falls back to MATLAB code when this is not compiled.
+//
+//          OLTraceMex('B', name)       Begin a span
+//          OLTraceMex('E', name)       End a span
+//          OLTraceMex('enable')        Start recording (off when loaded)
+//          OLTraceMex('disable')       Stop recording
+//          OLTraceMex('clear')         Forget the events recorded
+//          events = OLTraceMex('events')
+//          t = OLTraceMex('now')       Monotonic clock, uint64 ns
+//
+//          Span names are kept once each, in a table, so that recording
+//          a span does not allocate.
+// *** Date: 10-18-2026
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "mex.h"
+#include "matrix.h"
+#include "OLTrace.h"
+
+#define NAME_LENGTH     256
+#define MAX_NAMES       4096        /* Power of 2 */
+
+static char *names[MAX_NAMES];
+static int nNames = 0;
+
+static void freeNames(void)
+{
+    for (int i = 0; i < MAX_NAMES; i++) {
+        free(names[i]);
+        names[i] = NULL;
+    }
+    nNames = 0;
+}
+
+/* The table's copy of a name, added if it is not there yet */
+static const char *internName(const char *name)
+{
+    uint32_t hash = 2166136261u;
+    for (const char *c = name; *c; c++) {
+        hash = (hash ^ (uint8_t)*c) * 16777619u;
+    }
+    for (uint32_t i = hash & (MAX_NAMES-1); ; i = (i + 1) & (MAX_NAMES-1)) {
+        if (names[i] == NULL) {
+            if (nNames == MAX_NAMES-1) {
+                mexErrMsgTxt("OLTraceMex: Too many different span names.");
+            }
+            names[i] = malloc(strlen(name) + 1);
+            strcpy(names[i], name);
+            nNames++;
+            return names[i];
+        }
+        if (strcmp(names[i], name) == 0) {
+            return names[i];
+        }
+    }
+}
+
+/* Getaway function */
+void mexFunction(int nlhs,      /* number of output (return) arguments */
+      mxArray *plhs[],          /* pointer to an array which will hold the output data, each element is of type: mxArray */
+      int nrhs,                 /* number of input arguments */
+      const mxArray *prhs[]     /* pointer to an array which holds the input data, each element is of type: const mxArray */
+      )
+{
+    static int initialized = 0;
+    if (!initialized) {
+        olTraceEnabled = 0;
+        mexAtExit(freeNames);
+        initialized = 1;
+    }
+
+    if (nrhs < 1 || !mxIsChar(prhs[0])) {
+        mexErrMsgTxt("OLTraceMex: First argument must be a command string.");
+    }
+
+    /* Begin and end first, and without allocating, since they are the
+       ones called often. */
+    if (mxGetNumberOfElements(prhs[0]) == 1) {
+        const mxChar phase = mxGetChars(prhs[0])[0];
+        if (phase != 'B' && phase != 'E') {
+            mexErrMsgTxt("OLTraceMex: Unknown command.");
+        }
+        if (!olTraceEnabled) {
+            return;
+        }
+        char name[NAME_LENGTH];
+        if (nrhs < 2 || !mxIsChar(prhs[1])) {
+            mexErrMsgTxt("OLTraceMex: Span name must be a string.");
+        }
+        mxGetString(prhs[1], name, sizeof(name));
+        OLTraceRecord(internName(name), (char)phase);
+        return;
+    }
+
+    char command[NAME_LENGTH];
+    mxGetString(prhs[0], command, sizeof(command));
+    if (strcmp(command, "enable") == 0) {
+        olTraceEnabled = 1;
+    }
+    else if (strcmp(command, "disable") == 0) {
+        olTraceEnabled = 0;
+    }
+    else if (strcmp(command, "clear") == 0) {
+        olTraceCount = 0;
+    }
+    else if (strcmp(command, "events") == 0) {
+        plhs[0] = OLTraceEventsToMx();
+    }
+    else if (strcmp(command, "now") == 0) {
+        plhs[0] = mxCreateNumericMatrix(1, 1, mxUINT64_CLASS, mxREAL);
+        *(uint64_t *)mxGetData(plhs[0]) = OLTraceNow();
+    }
+    else {
+        mexErrMsgTxt("OLTraceMex: Unknown command.");
+    }
+}
@@ -0,0 +1,252 @@
+// *** Filename: OLTwoSidedExponentialFitMex.c
+// *** Purpose: Bounded Levenberg-Marquardt fits of the 6 parameter two
+//          sided exponential used to locate the peaks of comb SPDs.
+//          Called by OLFitTwoSidedExponentials, which documents the
+//          arguments and falls back to the equivalent MATLAB code when
+//          this is not compiled.
+//
+//          params = OLTwoSidedExponentialFitMex(x, y, segmentEnds, initialParams, lowerBounds, upperBounds)
+//
+//          x and y hold the data of all the peaks one after the other,
+//          and segmentEnds(k) is the index of the last sample of peak k.
+//          initialParams, lowerBounds and upperBounds are nPeaks x 6, as
+//          is params.  The peaks are independent fits, and when compiled
+//          with OpenMP they are run on separate threads.
+//
+//          The model is
+//             f(x) = offset + gain*exp(-0.5*(|x-peak|/sigma)^exponent)
+//          with sigma the left sigma for x < peak and the right sigma
+//          otherwise, and the Jacobian is computed analytically.
+// *** Date: 10-18-2026
+
+#include <math.h>
+#include <string.h>
+#include "mex.h"
+#include "matrix.h"
+
+#define NPARAMS 6
+#define MAX_ITERATIONS 200
+#define RELATIVE_TOLERANCE 1e-10
+
+/* Model value and, if J is not NULL, its derivatives with respect to the
+   parameters at one wavelength */
+static double twoSidedExponential(double x, const double *p, double *J)
+{
+    const double offset = p[0], gain = p[1], peak = p[2], exponent = p[5];
+    const int left = (x < peak);
+    const double sigma = left ? p[3] : p[4];
+    const double d = x - peak;
+    const double u = fabs(d) / sigma;
+    const double ue = pow(u, exponent);
+    const double E = exp(-0.5 * ue);
+
+    if (J != NULL) {
+        const double gE = gain * E;
+        J[0] = 1.0;
+        J[1] = E;
+        /* d/dpeak, where d|x-peak|/dpeak = -sign(x-peak).  Zero at the
+           peak, since the exponent is above one. */
+        J[2] = (u > 0) ? 0.5 * gE * exponent * (ue / u) * ((d > 0) ? 1.0 : -1.0) / sigma : 0.0;
+        /* d/dsigma, only for the sigma of this side */
+        J[3] = left ? 0.5 * gE * exponent * ue / sigma : 0.0;
+        J[4] = left ? 0.0 : 0.5 * gE * exponent * ue / sigma;
+        /* d/dexponent */
+        J[5] = (u > 0) ? -0.5 * gE * ue * log(u) : 0.0;
+    }
+    return offset + gain * E;
+}
+
+static double sumSquaredError(const double *x, const double *y, size_t n, const double *p)
+{
+    double cost = 0.0;
+    for (size_t i = 0; i < n; i++) {
+        const double r = twoSidedExponential(x[i], p, NULL) - y[i];
+        cost += r * r;
+    }
+    return cost;
+}
+
+/* Solve the nFree x nFree symmetric positive definite system A*z = b by
+   Cholesky, in place.  Returns 0 if A is not positive definite. */
+static int choleskySolve(double A[NPARAMS][NPARAMS], double *b, int nFree)
+{
+    for (int j = 0; j < nFree; j++) {
+        double s = A[j][j];
+        for (int k = 0; k < j; k++) {
+            s -= A[j][k] * A[j][k];
+        }
+        if (!(s > 0)) {
+            return 0;
+        }
+        A[j][j] = sqrt(s);
+        for (int i = j + 1; i < nFree; i++) {
+            double t = A[i][j];
+            for (int k = 0; k < j; k++) {
+                t -= A[i][k] * A[j][k];
+            }
+            A[i][j] = t / A[j][j];
+        }
+    }
+    for (int i = 0; i < nFree; i++) {
+        double t = b[i];
+        for (int k = 0; k < i; k++) {
+            t -= A[i][k] * b[k];
+        }
+        b[i] = t / A[i][i];
+    }
+    for (int i = nFree - 1; i >= 0; i--) {
+        double t = b[i];
+        for (int k = i + 1; k < nFree; k++) {
+            t -= A[k][i] * b[k];
+        }
+        b[i] = t / A[i][i];
+    }
+    return 1;
+}
+
+/* Fit one peak.  p holds the initial parameters on entry and the fit on
+   exit.  Parameters whose bounds are equal are held at that value. */
+static void fitPeak(const double *x, const double *y, size_t n, double *p, const double *lb, const double *ub)
+{
+    int freeParams[NPARAMS];
+    int nFree = 0;
+    for (int k = 0; k < NPARAMS; k++) {
+        p[k] = fmin(fmax(p[k], lb[k]), ub[k]);
+        if (lb[k] < ub[k]) {
+            freeParams[nFree++] = k;
+        }
+    }
+    if (nFree == 0 || n == 0) {
+        return;
+    }
+
+    double cost = sumSquaredError(x, y, n, p);
+    double mu = 1e-3;
+    for (int iteration = 0; iteration < MAX_ITERATIONS; iteration++) {
+        /* Normal equations J'J and J'r over the free parameters */
+        double JtJ[NPARAMS][NPARAMS];
+        double Jtr[NPARAMS];
+        memset(JtJ, 0, sizeof(JtJ));
+        memset(Jtr, 0, sizeof(Jtr));
+        for (size_t i = 0; i < n; i++) {
+            double J[NPARAMS];
+            const double r = twoSidedExponential(x[i], p, J) - y[i];
+            for (int a = 0; a < nFree; a++) {
+                const double Ja = J[freeParams[a]];
+                Jtr[a] += Ja * r;
+                for (int b = 0; b <= a; b++) {
+                    JtJ[a][b] += Ja * J[freeParams[b]];
+                }
+            }
+        }
+        double maxDiag = 0.0;
+        for (int a = 0; a < nFree; a++) {
+            maxDiag = fmax(maxDiag, JtJ[a][a]);
+        }
+        const double diagFloor = 1e-12 * fmax(maxDiag, 2.220446049250313e-16);
+
+        /* Increase the damping until a step lowers the error */
+        int improved = 0;
+        while (!improved && mu <= 1e10) {
+            double A[NPARAMS][NPARAMS];
+            double delta[NPARAMS];
+            for (int a = 0; a < nFree; a++) {
+                for (int b = 0; b <= a; b++) {
+                    A[a][b] = JtJ[a][b];
+                }
+                A[a][a] += mu * fmax(JtJ[a][a], diagFloor);
+                delta[a] = -Jtr[a];
+            }
+            if (!choleskySolve(A, delta, nFree)) {
+                mu *= 4;
+                continue;
+            }
+
+            double trial[NPARAMS];
+            memcpy(trial, p, sizeof(trial));
+            for (int a = 0; a < nFree; a++) {
+                const int k = freeParams[a];
+                trial[k] = fmin(fmax(p[k] + delta[a], lb[k]), ub[k]);
+            }
+            const double trialCost = sumSquaredError(x, y, n, trial);
+            if (trialCost < cost) {
+                const int converged = (cost - trialCost <= RELATIVE_TOLERANCE * cost);
+                memcpy(p, trial, sizeof(trial));
+                cost = trialCost;
+                mu = fmax(mu / 3, 1e-12);
+                improved = 1;
+                if (converged) {
+                    return;
+                }
+            } else {
+                mu *= 4;
+            }
+        }
+        if (!improved) {
+            return;
+        }
+    }
+}
+
+/* Getaway function */
+void mexFunction(int nlhs,      /* number of output (return) arguments */
+      mxArray *plhs[],          /* pointer to an array which will hold the output data, each element is of type: mxArray */
+      int nrhs,                 /* number of input arguments */
+      const mxArray *prhs[]     /* pointer to an array which holds the input data, each element is of type: const mxArray */
+      )
+{
+    if (nrhs != 6) {
+        mexErrMsgTxt("OLTwoSidedExponentialFitMex: Requires six input arguments.");
+    }
+    for (int k = 0; k < nrhs; k++) {
+        if (!mxIsDouble(prhs[k]) || mxIsComplex(prhs[k]) || mxIsSparse(prhs[k])) {
+            mexErrMsgTxt("OLTwoSidedExponentialFitMex: Arguments must be real, full, double arrays.");
+        }
+    }
+
+    const double *x = mxGetPr(prhs[0]);
+    const double *y = mxGetPr(prhs[1]);
+    const size_t nData = mxGetNumberOfElements(prhs[0]);
+    const double *segmentEnds = mxGetPr(prhs[2]);
+    const size_t nPeaks = mxGetNumberOfElements(prhs[2]);
+    if (mxGetNumberOfElements(prhs[1]) != nData) {
+        mexErrMsgTxt("OLTwoSidedExponentialFitMex: x and y must have the same number of elements.");
+    }
+    for (int k = 3; k < 6; k++) {
+        if (mxGetM(prhs[k]) != nPeaks || mxGetN(prhs[k]) != NPARAMS) {
+            mexErrMsgTxt("OLTwoSidedExponentialFitMex: Parameters and bounds must be nPeaks x 6.");
+        }
+    }
+    for (size_t k = 0; k < nPeaks; k++) {
+        const double start = (k == 0) ? 0 : segmentEnds[k-1];
+        if (segmentEnds[k] < start || segmentEnds[k] > (double)nData) {
+            mexErrMsgTxt("OLTwoSidedExponentialFitMex: Segment ends must be increasing and within the data.");
+        }
+    }
+    const double *initialParams = mxGetPr(prhs[3]);
+    const double *lowerBounds = mxGetPr(prhs[4]);
+    const double *upperBounds = mxGetPr(prhs[5]);
+
+    plhs[0] = mxCreateDoubleMatrix(nPeaks, NPARAMS, mxREAL);
+    double *params = mxGetPr(plhs[0]);
+
+    /* Each peak works on its own copy of its parameters, which are rows
+       of column major matrices */
+#ifdef _OPENMP
+    #pragma omp parallel for schedule(static)
+#endif
+    for (long k = 0; k < (long)nPeaks; k++) {
+        const size_t first = (k == 0) ? 0 : (size_t)segmentEnds[k-1];
+        const size_t last = (size_t)segmentEnds[k];
+        double p[NPARAMS], lb[NPARAMS], ub[NPARAMS];
+        for (int j = 0; j < NPARAMS; j++) {
+            p[j] = initialParams[k + j*nPeaks];
+            lb[j] = lowerBounds[k + j*nPeaks];
+            ub[j] = upperBounds[k + j*nPeaks];
+        }
+        fitPeak(x + first, y + first, last - first, p, lb, ub);
+        for (int j = 0; j < NPARAMS; j++) {
+            params[k + j*nPeaks] = p[j];
+        }
+    }
+}
@@ -0,0 +1,109 @@
+% [calProgression, validBytes, totalBytes] = LoadCalProgressionData(calProgressionTemporaryFileName)
+%
+% Load cal progression.
+%
+% Reads the journal written by OLCalibrator.SaveCalProgressionData and
+% returns its entries as the calProgression cell array, one struct with
+% fields methodName, spdData, temperatureData and timestamp per entry.  If
+% there is no journal, calProgression is loaded from the temporary .mat
+% file, as saved before there were journals.
+%
+% Reading stops at the first incomplete record, which is what a crash
+% while writing leaves behind, with a warning.  validBytes is the number
+% of bytes of the journal up to the end of the last complete record (0 if
+% the header is incomplete) and totalBytes the size of the journal.
+%
+% 10/18/26          Wrote it.
+function [calProgression, validBytes, totalBytes] = LoadCalProgressionData(calProgressionTemporaryFileName)
+
+    [fileDir, fileName] = fileparts(calProgressionTemporaryFileName);
+    journalFileName = fullfile(fileDir, [fileName '.journal']);
+
+    % Files from before there were journals
+    if (~exist(journalFileName, 'file'))
+        load(fullfile(fileDir, [fileName '.mat']), 'calProgression');
+        validBytes = 0;
+        totalBytes = 0;
+        return;
+    end
+
+    fid = fopen(journalFileName, 'r', 'ieee-le');
+    if (fid < 0)
+        error('OLCalibrator:LoadCalProgressionData:CannotOpen', 'Cannot open %s', journalFileName);
+    end
+    bytes = fread(fid, Inf, '*uint8')';
+    fclose(fid);
+    totalBytes = numel(bytes);
+
+    calProgression = {};
+    validBytes = 0;
+    if (totalBytes < 8 || ~strcmp(char(bytes(1:4)), 'OLCJ'))
+        warning('OLCalibrator:LoadCalProgressionData:BadHeader', '%s is not a complete cal progression journal', journalFileName);
+        return;
+    end
+    validBytes = 8;
+
+    % Records, up to the first incomplete one
+    position = 8;
+    while (position + 4 <= totalBytes)
+        byteCount = double(typecast(bytes(position+(1:4)), 'uint32'));
+        recordEnd = position + 4 + byteCount + 4;
+        if (recordEnd > totalBytes || ...
+                double(typecast(bytes(recordEnd-3:recordEnd), 'uint32')) ~= byteCount)
+            break;
+        end
+        try
+            calProgression{end+1} = decodeEntry(bytes(position+4+(1:byteCount))); %#ok<AGROW>
+        catch
+            break;
+        end
+        position = recordEnd;
+        validBytes = recordEnd;
+    end
+    if (validBytes < totalBytes)
+        warning('OLCalibrator:LoadCalProgressionData:Incomplete', ...
+            'Ignoring %d bytes of incomplete records at the end of %s', totalBytes - validBytes, journalFileName);
+    end
+end
+
+function entry = decodeEntry(payload)
+    position = 0;
+    [methodName, position] = decodeString(payload, position);
+    timestamp = typecast(payload(position+(1:8)), 'double');
+    position = position + 8;
+    [spdData, position] = decodeStruct(payload, position);
+    [temperatureData, position] = decodeStruct(payload, position);
+    assert(position == numel(payload));
+    entry = struct(...
+        'methodName', methodName, ...
+        'spdData', spdData, ...
+        'temperatureData', temperatureData, ...
+        'timestamp', timestamp);
+end
+
+function [s, position] = decodeString(payload, position)
+    n = double(typecast(payload(position+(1:4)), 'uint32'));
+    s = char(payload(position+4+(1:n)));
+    if (n == 0)
+        s = '';
+    end
+    position = position + 4 + n;
+end
+
+function [s, position] = decodeStruct(payload, position)
+    nFields = double(typecast(payload(position+(1:4)), 'uint32'));
+    position = position + 4;
+    s = struct();
+    for k = 1:nFields
+        [name, position] = decodeString(payload, position);
+        valueSize = double(typecast(payload(position+(1:8)), 'uint32'));
+        position = position + 8;
+        nBytes = 8*prod(valueSize);
+        if (nBytes == 0)
+            s.(name) = zeros(valueSize);
+        else
+            s.(name) = reshape(typecast(payload(position+(1:nBytes)), 'double'), valueSize);
+        end
+        position = position + nBytes;
+    end
+end
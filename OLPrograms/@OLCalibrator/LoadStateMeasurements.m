@@ -0,0 +1,48 @@
+% stateMeas = LoadStateMeasurements(stateStoreDirectory, timeWindow)
+%
+% Load state measurements.
+%
+% Reads the time series stores that OLCalibrator.TakeStateMeasurements
+% appends to when given 'stateStoreDirectory', and returns them laid out as
+% in cal.raw:
+%   stateMeas.powerFluctuationMeas.measSpd   nWavelengths x n
+%   stateMeas.powerFluctuationMeas.t         1 x n
+%   stateMeas.spectralShiftsMeas.measSpd     nWavelengths x n
+%   stateMeas.spectralShiftsMeas.t           1 x n
+%   stateMeas.temperature.value              n x 2
+%   stateMeas.temperature.t                  n x 1
+% A series that was not stored is left out.  stateMeas.S is the wavelength
+% sampling of the SPDs and stateMeas.dateCreated the date the SPD stores
+% were started.
+%
+% If timeWindow [tStart tEnd] is given only the measurements taken in it
+% are read, which for a long monitoring run is much less than all of them.
+%
+% 10/18/26          Wrote it.
+function stateMeas = LoadStateMeasurements(stateStoreDirectory, timeWindow)
+
+    if (nargin < 2 || isempty(timeWindow))
+        timeWindow = [-Inf Inf];
+    end
+    if (~exist(stateStoreDirectory, 'dir'))
+        error('OLCalibrator:LoadStateMeasurements:NoStore', 'There are no state measurements in %s', stateStoreDirectory);
+    end
+
+    stateMeas = struct();
+    spdSeries = {'powerFluctuationMeas', 'spectralShiftsMeas'};
+    for k = 1:numel(spdSeries)
+        if (exist(fullfile(stateStoreDirectory, spdSeries{k}, 'header.bin'), 'file'))
+            store = OLTimeSeriesStore(fullfile(stateStoreDirectory, spdSeries{k}));
+            [t, measSpd] = store.range(timeWindow(1), timeWindow(2));
+            stateMeas.(spdSeries{k}) = struct('measSpd', measSpd, 't', t);
+            stateMeas.S = store.S;
+            stateMeas.dateCreated = datestr(store.Created);
+        end
+    end
+
+    if (exist(fullfile(stateStoreDirectory, 'temperature', 'header.bin'), 'file'))
+        store = OLTimeSeriesStore(fullfile(stateStoreDirectory, 'temperature'));
+        [t, value] = store.range(timeWindow(1), timeWindow(2));
+        stateMeas.temperature = struct('value', value', 't', t');
+    end
+end
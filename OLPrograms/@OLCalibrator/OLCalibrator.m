@@ -42,9 +42,15 @@ classdef OLCalibrator
         % Method to save cal progression data
         SaveCalProgressionData(calProgressionTemporaryFileName, methodName, spdData, temperatureData);
         
+        % Method to load cal progression data
+        [calProgression, validBytes, totalBytes] = LoadCalProgressionData(calProgressionTemporaryFileName);
+        
         % Method to save barebones state measurements
         SaveStateMeasurements(cal0, cal1, protocolParams);
         
+        % Method to load state measurements from their time series stores
+        stateMeas = LoadStateMeasurements(stateStoreDirectory, timeWindow);
+        
         % Method to visualize the OneLight state progression during a calibration.
         VisualizeStateProgression();      
         
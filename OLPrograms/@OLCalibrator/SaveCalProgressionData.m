@@ -2,22 +2,107 @@
 %
 % Save cal progression.
 %
+% The entry is appended to a journal file next to the temporary file, with
+% the same name and extension .journal.  Appending does not read or
+% rewrite what is already there, so it takes the same time however long
+% the calibration has been running.  OLCalibrator.LoadCalProgressionData
+% reads the journal back as the calProgression cell array.
+%
+% The journal starts with the 4 bytes 'OLCJ' and a uint32 version, followed
+% by one record per entry.  A record is a uint32 byte count, the payload,
+% and the same byte count again, which marks the record as complete.  The
+% payload is
+%   uint32 length and the characters of methodName
+%   double timestamp (datenum at which the entry was saved)
+%   spdData and temperatureData, each as a uint32 number of fields and
+%     then for each field the uint32 length and characters of its name
+%     followed by uint32 rows, uint32 columns and the values as doubles.
+% Everything is little endian.
+%
+% If a record was left incomplete (e.g. MATLAB was killed while writing),
+% the first save to that journal in a MATLAB session drops it, so that
+% later entries can be read.
+%
 % 06/13/18  npc     Wrote it
+% 10/18/26          Append to a journal rather than load and re-save calProgression.
 function SaveCalProgressionData(calProgressionTemporaryFileName, methodName, spdData, temperatureData)
 
-    % Load the previous calProgression
-    load(calProgressionTemporaryFileName, 'calProgression');
-        
-    % assemble all in a struct
-    newData = struct(...
-        'methodName', methodName, ...
-        'spdData', spdData, ...
-        'temperatureData', temperatureData ...
-    );
-        
-    % write that struct at the end
-    calProgression{numel(calProgression)+1} = newData;
-    % Overwrite file with new stuff
-    save(calProgressionTemporaryFileName, 'calProgression');
-    fprintf('\n<strong>Updated temporary calibration file with measurement %d. File location: %s</strong>\n\n', calProgressionTemporaryFileName, numel(calProgression));
+    [fileDir, fileName] = fileparts(calProgressionTemporaryFileName);
+    journalFileName = fullfile(fileDir, [fileName '.journal']);
+
+    % Check each journal for an incomplete last record, once per session
+    persistent checkedJournals;
+    if (isempty(checkedJournals))
+        checkedJournals = {};
+    end
+    if (~any(strcmp(checkedJournals, journalFileName)))
+        repairJournal(journalFileName);
+        checkedJournals{end+1} = journalFileName;
+    end
+
+    % Assemble the record
+    payload = [encodeString(methodName) typecast(now, 'uint8') encodeStruct(spdData) encodeStruct(temperatureData)];
+    byteCount = typecast(uint32(numel(payload)), 'uint8');
+    record = [byteCount payload byteCount];
+
+    % Append it, starting the journal if there isn't one
+    isNew = ~exist(journalFileName, 'file');
+    fid = fopen(journalFileName, 'a', 'ieee-le');
+    if (fid < 0)
+        error('OLCalibrator:SaveCalProgressionData:CannotOpen', 'Cannot open %s for writing', journalFileName);
+    end
+    if (isNew)
+        fwrite(fid, 'OLCJ', 'char');
+        fwrite(fid, 1, 'uint32');
+    end
+    fwrite(fid, record, 'uint8');
+    fclose(fid);
+
+    fprintf('\n<strong>Updated temporary calibration journal with: %s. File location: %s</strong>\n\n', methodName, journalFileName);
+end
+
+function bytes = encodeString(s)
+    s = char(s);
+    bytes = [typecast(uint32(numel(s)), 'uint8') uint8(s(:)')];
+end
+
+function bytes = encodeStruct(s)
+    % Numeric fields only, which is what the Take*Measurement methods save
+    names = fieldnames(s);
+    bytes = typecast(uint32(numel(names)), 'uint8');
+    for k = 1:numel(names)
+        value = double(s.(names{k}));
+        valueBytes = zeros(1, 0, 'uint8');
+        if (~isempty(value))
+            valueBytes = typecast(value(:)', 'uint8');
+        end
+        bytes = [bytes encodeString(names{k}) ...
+            typecast(uint32([size(value,1) size(value,2)]), 'uint8') valueBytes]; %#ok<AGROW>
+    end
+end
+
+function repairJournal(journalFileName)
+    % Drop an incomplete last record.  The complete records are copied to a
+    % new file, which then replaces the journal.
+    if (~exist(journalFileName, 'file'))
+        return;
+    end
+    [~, validBytes, totalBytes] = OLCalibrator.LoadCalProgressionData(journalFileName);
+    if (validBytes == 0)
+        % Not even the header made it
+        delete(journalFileName);
+        return;
+    end
+    if (validBytes == totalBytes)
+        return;
+    end
+    fprintf(2, 'Dropping an incomplete record at the end of %s\n', journalFileName);
+    fid = fopen(journalFileName, 'r');
+    bytes = fread(fid, validBytes, '*uint8');
+    fclose(fid);
+    repairedFileName = [journalFileName '.repaired'];
+    fid = fopen(repairedFileName, 'w');
+    fwrite(fid, bytes, 'uint8');
+    fclose(fid);
+    movefile(repairedFileName, journalFileName, 'f');
 end
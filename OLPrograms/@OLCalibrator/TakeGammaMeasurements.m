@@ -6,8 +6,11 @@
 % 9/29/16   npc     Optionally record temperature
 % 12/21/16  npc     Updated for new class @LJTemperatureProbe
 % 06/13/18  npc     Updated with option to save progression of cal
+% 10/18/26          Convert the next gamma level's settings while the mirrors settle.
+% 10/18/26          Trace the time spent here, with OLTrace.
 
 function cal = TakeGammaMeasurements(cal0, gammaBandIndex, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, theLJdev, varargin)
+    span = OLTraceSpan(['OLCalibrator.' mfilename()]); %#ok<NASGU>
 
     p = inputParser;
     p.addParameter('takeTemperatureMeasurements', false, @islogical);
@@ -98,7 +101,11 @@ function cal = TakeGammaMeasurements(cal0, gammaBandIndex, ol, od, spectroRadiom
         end
     end
 
-    for gammaLevelIndex = gammaLevelsIter
+    % The starts and stops of each level after the first are worked out
+    % while the mirrors settle for the level before it.
+    [starts,stops] = OLSettingsToStartsStops(cal,gammaLevelSettings(cal,gammaBandIndex,gammaLevelsIter(1)));
+    for iter = 1:numel(gammaLevelsIter)
+        gammaLevelIndex = gammaLevelsIter(iter);
         % See if we need to take a new set of state measurements
         if (mod(cal.describe.stateTracking.calibrationStimIndex, cal.describe.stateTracking.calibrationStimInterval) == 0)
             cal = OLCalibrator.TakeStateMeasurements(cal, ol, od, ...
@@ -112,14 +119,17 @@ function cal = TakeGammaMeasurements(cal0, gammaBandIndex, ol, od, spectroRadiom
         fprintf('- Measurement #%d: gamma level %d of %d for gamma band: %d ...', cal.describe.stateTracking.calibrationStimIndex, gammaLevelIndex, cal.describe.nGammaLevels,gammaBandIndex);
 
         % Set the starts/stops, measure, and store
-        if (cal.describe.specifiedBackground)
-            theSettings = GetEffectiveBackgroundSettingsForPrimary(cal.describe.gamma.gammaBands(gammaBandIndex),cal.describe.specifiedBackgroundSettings);
+        if (iter < numel(gammaLevelsIter))
+            nextLevelIndex = gammaLevelsIter(iter+1);
+            prepareNextLevel = @() gammaLevelStartsStops(cal,gammaBandIndex,nextLevelIndex);
         else
-            theSettings = zeros(nPrimaries,1);
+            prepareNextLevel = [];
+        end
+        [measTemp, ~, nextStartsStops] = OLTakeMeasurementOOC(ol, od, spectroRadiometerOBJ, starts, stops, cal.describe.S, meterToggle, nAverage, ...
+            'whileSettling', prepareNextLevel);
+        if (~isempty(nextStartsStops))
+            [starts,stops] = deal(nextStartsStops{:});
         end
-        theSettings(cal.describe.gamma.gammaBands(gammaBandIndex)) = cal.describe.gamma.gammaLevels(gammaLevelIndex);
-        [starts,stops] = OLSettingsToStartsStops(cal,theSettings);
-        measTemp = OLTakeMeasurementOOC(ol, od, spectroRadiometerOBJ, starts, stops, cal.describe.S, meterToggle, nAverage);
         cal.raw.gamma.rad(gammaBandIndex).meas(:,gammaLevelIndex) = measTemp.pr650.spectrum;
         cal.raw.t.gamma.rad(gammaBandIndex).meas(gammaLevelIndex) = measTemp.pr650.time(1);
         if (meterToggle(2))
@@ -144,3 +154,16 @@ function cal = TakeGammaMeasurements(cal0, gammaBandIndex, ol, od, spectroRadiom
     end
 end
 
+function theSettings = gammaLevelSettings(cal, gammaBandIndex, gammaLevelIndex)
+    if (cal.describe.specifiedBackground)
+        theSettings = GetEffectiveBackgroundSettingsForPrimary(cal.describe.gamma.gammaBands(gammaBandIndex),cal.describe.specifiedBackgroundSettings);
+    else
+        theSettings = zeros(cal.describe.numWavelengthBands,1);
+    end
+    theSettings(cal.describe.gamma.gammaBands(gammaBandIndex)) = cal.describe.gamma.gammaLevels(gammaLevelIndex);
+end
+
+function startsStops = gammaLevelStartsStops(cal, gammaBandIndex, gammaLevelIndex)
+    [starts,stops] = OLSettingsToStartsStops(cal,gammaLevelSettings(cal,gammaBandIndex,gammaLevelIndex));
+    startsStops = {starts, stops};
+end
@@ -6,8 +6,10 @@
 % 9/29/16   npc     Optionally record temperature
 % 12/21/16  npc     Updated for new class @LJTemperatureProbe
 % 06/13/18  npc     Updated with option to save progression of cal
+% 10/18/26          Trace the time spent here, with OLTrace.
 
 function cal = TakeHalfOnMeasurement(measurementIndex, cal0, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, theLJdev, varargin)
+    span = OLTraceSpan(['OLCalibrator.' mfilename()]); %#ok<NASGU>
 
     p = inputParser;
     p.addParameter('takeTemperatureMeasurements', false, @islogical);
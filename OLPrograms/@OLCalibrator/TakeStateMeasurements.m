@@ -8,19 +8,37 @@
 % 9/29/16   npc     Added parser for optional params: 'standAlone' and 'takeTemperatureMeasurements'
 % 12/21/16  npc     Updated for new class @LJTemperatureProbe
 % 06/13/18  npc     Updated with option to save progression of cal
+% 10/18/26          Append measurements to time series stores, with 'stateStoreDirectory'.
+% 10/18/26          Read the temperature, and convert the spectral shift settings, while
+%                   the mirrors settle for the power fluctuation measurement.
+% 10/18/26          Trace the time spent here, with OLTrace.
+%
+% With 'stateStoreDirectory', each measurement is also appended to an
+% OLTimeSeriesStore in that directory as soon as it is taken:
+% powerFluctuationMeas and spectralShiftsMeas for the SPDs, and temperature.
+% OLCalibrator.LoadStateMeasurements reads them back, for any time window.
+% When saving the progression of a cal, the stores default to the directory
+% next to the temporary file with _StateMeasurements added to its name.
 
 function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, theLJdev, varargin)
+    span = OLTraceSpan(['OLCalibrator.' mfilename()]); %#ok<NASGU>
 
     p = inputParser;
     p.addParameter('standAlone', false, @islogical);
     p.addParameter('takeTemperatureMeasurements', false, @islogical);
     p.addParameter('calProgressionTemporaryFileName', '', @ischar);
+    p.addParameter('stateStoreDirectory', '', @ischar);
     
     % Execute the parser
     p.parse(varargin{:});
     standAlone = p.Results.standAlone;
     takeTemperatureMeasurements = p.Results.takeTemperatureMeasurements;
     calProgressionTemporaryFileName = p.Results.calProgressionTemporaryFileName;
+    stateStoreDirectory = p.Results.stateStoreDirectory;
+    if (isempty(stateStoreDirectory) && ~isempty(calProgressionTemporaryFileName))
+        [fileDir, fileName] = fileparts(calProgressionTemporaryFileName);
+        stateStoreDirectory = fullfile(fileDir, [fileName '_StateMeasurements']);
+    end
     
     if standAlone
         calMeasOnly.describe = cal0.describe;
@@ -43,16 +61,25 @@ function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiome
     cal = cal0;
     cal.describe.stateTracking.stateMeasurementIndex = cal.describe.stateTracking.stateMeasurementIndex + 1;
 
+    if (takeTemperatureMeasurements)
+        temperatureProbe = theLJdev;
+    else
+        temperatureProbe = [];
+    end
     theSettings = cal.describe.stateTracking.stimSettings.powerFluctuationsStim;
     [starts,stops] = OLSettingsToStartsStops(cal,theSettings);
-    measTemp = OLTakeMeasurementOOC(ol, od, spectroRadiometerOBJ, starts, stops, cal.describe.S, meterToggle, nAverage);
+    [measTemp, ~, spectralShiftsStartsStops] = OLTakeMeasurementOOC(ol, od, spectroRadiometerOBJ, starts, stops, cal.describe.S, meterToggle, nAverage, ...
+        'temperatureProbe', temperatureProbe, ...
+        'whileSettling', @() settingsToStartsStops(cal, cal.describe.stateTracking.stimSettings.spectralShiftsStim));
+    if (takeTemperatureMeasurements)
+        temperatureValue = measTemp.temperature.value;
+    end
     if (standAlone)
         % SPD
         calMeasOnly.raw.powerFluctuationMeas.measSpd = measTemp.pr650.spectrum;
         calMeasOnly.raw.powerFluctuationMeas.t = measTemp.pr650.time(1);
         % Temperature
         if (takeTemperatureMeasurements)
-            [~, temperatureValue] = theLJdev.measure();
             calMeasOnly.raw.temperature.value = temperatureValue;
             calMeasOnly.raw.temperature.t = measTemp.pr650.time(1);
         end
@@ -63,12 +90,15 @@ function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiome
         cal.raw.powerFluctuationMeas.t(:, cal.describe.stateTracking.stateMeasurementIndex) = measTemp.pr650.time(1);
         % Temperature
         if (takeTemperatureMeasurements)
-            [~, temperatureValue] = theLJdev.measure();
             cal.raw.temperature.value(cal.describe.stateTracking.stateMeasurementIndex,:) = temperatureValue;
             cal.raw.temperature.t(cal.describe.stateTracking.stateMeasurementIndex,:) = measTemp.pr650.time(1);
         end
         fprintf('Done\n');
     end
+    appendToStateStore(stateStoreDirectory, 'powerFluctuationMeas', cal.describe.S, measTemp.pr650.time(1), measTemp.pr650.spectrum);
+    if (takeTemperatureMeasurements)
+        appendToStateStore(stateStoreDirectory, 'temperature', [], measTemp.pr650.time(1), temperatureValue);
+    end
 
     if (~isempty(calProgressionTemporaryFileName))
         % make spdData struct
@@ -91,8 +121,7 @@ function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiome
             spdData, temperatureData);
     end
     
-    theSettings = cal.describe.stateTracking.stimSettings.spectralShiftsStim;
-    [starts,stops] = OLSettingsToStartsStops(cal,theSettings);
+    [starts,stops] = deal(spectralShiftsStartsStops{:});
     measTemp = OLTakeMeasurementOOC(ol, od, spectroRadiometerOBJ, starts, stops, cal.describe.S, meterToggle, nAverage);
     if (standAlone)
         calMeasOnly.raw.spectralShiftsMeas.measSpd = measTemp.pr650.spectrum;
@@ -103,6 +132,7 @@ function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiome
         cal.raw.spectralShiftsMeas.t(:, cal.describe.stateTracking.stateMeasurementIndex) = measTemp.pr650.time(1);
         fprintf('Done\n');
     end
+    appendToStateStore(stateStoreDirectory, 'spectralShiftsMeas', cal.describe.S, measTemp.pr650.time(1), measTemp.pr650.spectrum);
     
     if (~isempty(calProgressionTemporaryFileName))
         % make spdData struct
@@ -125,3 +155,22 @@ function [cal, calMeasOnly] = TakeStateMeasurements(cal0, ol, od, spectroRadiome
             spdData, temperatureData);
     end
 end
+
+function appendToStateStore(stateStoreDirectory, name, S, t, values)
+    if (isempty(stateStoreDirectory))
+        return;
+    end
+    % A problem with the store should not cost us the measurements
+    try
+        store = OLTimeSeriesStore(fullfile(stateStoreDirectory, name), 'nValues', numel(values), 'S', S);
+        store.append(t, values(:));
+    catch e
+        warning('OLCalibrator:TakeStateMeasurements:StoreFailed', ...
+            'Could not append to the %s store in %s: %s', name, stateStoreDirectory, e.message);
+    end
+end
+
+function startsStops = settingsToStartsStops(cal, theSettings)
+    [starts,stops] = OLSettingsToStartsStops(cal,theSettings);
+    startsStops = {starts, stops};
+end
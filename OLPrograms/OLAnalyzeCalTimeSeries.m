@@ -3,19 +3,40 @@
 %     Analyze the time series of temperature, power fluctuation, and spectral
 %     shift data found in an OLcalibration file
 %
+%     Optionally, analyze the state measurements saved in time series
+%     stores (see OLCalibrator.TakeStateMeasurements) instead, reading
+%     only those in a given time window.
+%
+% Optional key/value pairs:
+%     'stateStoreDirectory' - Directory of the time series stores to
+%                             analyze. Default '' asks for a cal file.
+%     'timeWindow'          - [tStart tEnd] of the stored measurements to
+%                             analyze. Default [] analyzes all of them.
+%
 
 % History:
 %   5/31/2018  NPC Wrote it.
 %   6/05/2018  NPC Import calFile based on getpref('OneLightToolbox', 'OneLightCalData')
+%   10/18/2026     Analyze state measurements from time series stores
 %
 
-function OLAnalyzeCalTimeSeries
+function OLAnalyzeCalTimeSeries(varargin)
+    p = inputParser;
+    p.addParameter('stateStoreDirectory', '', @ischar);
+    p.addParameter('timeWindow', [], @(x) isempty(x) || numel(x) == 2);
+    p.parse(varargin{:});
+
     % Provide an estimate of the comb SPD peaks
     combSPDNominalPeaks = [468 530 590 645];
     
-    % Load calibrations
-    [cals, calFile] = loadCalData();
-    timeSeries = extractTimeSeries(cals);
+    if (isempty(p.Results.stateStoreDirectory))
+        % Load calibrations
+        [cals, calFile] = loadCalData();
+        timeSeries = extractTimeSeries(cals);
+    else
+        % Load stored state measurements
+        [timeSeries, calFile] = loadStateStoreData(p.Results.stateStoreDirectory, p.Results.timeWindow);
+    end
     
     % Plot the time series analysis
     plotTimeSeries(timeSeries, calFile, combSPDNominalPeaks);
@@ -374,6 +395,26 @@ function timeSeries = extractTimeSeries(cals)
     end
 end
 
+function [timeSeries, name] = loadStateStoreData(stateStoreDirectory, timeWindow)
+    stateMeas = OLCalibrator.LoadStateMeasurements(stateStoreDirectory, timeWindow);
+    [~, name] = fileparts(stateStoreDirectory);
+    timeEntry = struct(...
+        'date', stateMeas.dateCreated, ...
+        'waveAxis', SToWls(stateMeas.S), ...
+        'temperature', [], ...
+        'powerFluctuationMeas', [], ...
+        'spectralShiftsMeas', [] ...
+        );
+    fprintf('[1]: %s\n', timeEntry.date);
+    fieldNames = {'temperature', 'powerFluctuationMeas', 'spectralShiftsMeas'};
+    for k = 1:numel(fieldNames)
+        if (isfield(stateMeas, fieldNames{k}) && ~isempty(stateMeas.(fieldNames{k}).t))
+            timeEntry.(fieldNames{k}) = stateMeas.(fieldNames{k});
+        end
+    end
+    timeSeries = {timeEntry};
+end
+
 function [cals, file] = loadCalData()
     cals = {};
     systemInfo = GetComputerInfo();
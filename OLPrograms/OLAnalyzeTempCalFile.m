@@ -4,7 +4,7 @@ function OLAnalyzeTempCalFile
     approach = 'MELA_materials/Experiments/OLApproach_Psychophysics';
     temCalFile = 'OLBoxARandomizedLongCableAEyePiece3ND00_TMP.mat';
     
-    load(fullfile(rootDir, approach, 'OneLightCalData', temCalFile), 'calProgression');
+    calProgression = OLCalibrator.LoadCalProgressionData(fullfile(rootDir, approach, 'OneLightCalData', temCalFile));
     
     entriesNum = numel(calProgression);
     powerFluctuationSPDs = [];
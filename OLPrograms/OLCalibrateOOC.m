@@ -116,11 +116,16 @@ try
         tmpCalFileName = sprintf('OL%s_TMP', selectedCalType);
         calProgressionTemporaryFileName = ...
             fullfile(getpref('OneLightToolbox', 'OneLightCalData'), tmpCalFileName);
-        calProgression{1} = struct(...
-            'methodName', 'LOG START', ...
-            'spdData', struct(), ...
-            'temperatureData', struct());
-        save(calProgressionTemporaryFileName, 'calProgression');
+        % Start a new journal
+        [calProgressionDir, calProgressionName] = fileparts(calProgressionTemporaryFileName);
+        if (exist(fullfile(calProgressionDir, [calProgressionName '.journal']), 'file'))
+            delete(fullfile(calProgressionDir, [calProgressionName '.journal']));
+        end
+        % and new state measurement stores
+        if (exist(fullfile(calProgressionDir, [calProgressionName '_StateMeasurements']), 'dir'))
+            rmdir(fullfile(calProgressionDir, [calProgressionName '_StateMeasurements']), 's');
+        end
+        OLCalibrator.SaveCalProgressionData(calProgressionTemporaryFileName, 'LOG START', struct(), struct());
     else
         calProgressionTemporaryFileName = '';
     end
@@ -471,10 +476,10 @@ try
     fprintf('\n<strong>Calibration Complete</strong>\n\n');
     
     if (strcmpi(saveCalProgression, 'y'))
-        calProgression{numel(calProgression)+1} = struct(...
-            'methodName', 'LOG END', ...
-            'spdData', struct(), ...
-            'temperatureData', struct());
+        OLCalibrator.SaveCalProgressionData(calProgressionTemporaryFileName, 'LOG END', struct(), struct());
+        
+        % Also save the whole progression as a .mat file
+        calProgression = OLCalibrator.LoadCalProgressionData(calProgressionTemporaryFileName);
         save(calProgressionTemporaryFileName, 'calProgression');
         
         % If we reached this point, we can delete the temporary calibration
@@ -6,20 +6,30 @@
 %
 % Syntax:
 % monitoredData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage)
+% monitoredData = OLMonitorStateWindow(..., 'stateStoreDirectory', stateStoreDirectory)
+%
+% With 'stateStoreDirectory', each state measurement is appended to time
+% series stores in that directory as it is taken (see
+% OLCalibrator.TakeStateMeasurements), so that nothing is lost if a long
+% monitoring run does not finish.  OLVisualizeMonitoredData can be passed
+% the directory in place of monitoredData.
 %
 % See testOLMonitorStateWindow for usage of this function.
 %
 % 9/12/16   npc     Wrote it.
 % 9/29/16   npc     Optionally record temperature.
 % 12/21/16  npc     Updated for new class @LJTemperatureProbe
+% 10/18/26          Save measurements to time series stores as they are taken.
 
 function monitoredData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, varargin)
 
     p = inputParser;
     p.addParameter('takeTemperatureMeasurements', false, @islogical);
+    p.addParameter('stateStoreDirectory', '', @ischar);
     % Execute the parser
     p.parse(varargin{:});
     takeTemperatureMeasurements = p.Results.takeTemperatureMeasurements;
+    stateStoreDirectory = p.Results.stateStoreDirectory;
     
     
     measurementIndex = 0;
@@ -27,6 +37,7 @@ function monitoredData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ,
     referenceTime = [];
     referencePowerSPD = [];
     referenceCombSPD = [];
+    referenceFitParams = [];
     wavelengthIndices = [];
     spectralAxis = SToWls(cal.describe.S);
     
@@ -95,10 +106,8 @@ function monitoredData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ,
         try 
              % Measure and retrieve the data
              fprintf('Measuring state data (measurement index: %d) ... ', measurementIndex+1);
-             [~, calStateMeas] = OLCalibrator.TakeStateMeasurements(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, theLJdev, 'standAlone', true, 'takeTemperatureMeasurements', takeTemperatureMeasurements);
-    
-             % Initialize everything);
-             OLCalibrator.SaveStateMeasurements(cal, calStateMeas);
+             [~, calStateMeas] = OLCalibrator.TakeStateMeasurements(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, theLJdev, 'standAlone', true, 'takeTemperatureMeasurements', takeTemperatureMeasurements, ...
+                 'stateStoreDirectory', stateStoreDirectory);
              
              data.shiftSPD  = calStateMeas.raw.spectralShiftsMeas.measSpd;
              data.shiftSPDt = calStateMeas.raw.spectralShiftsMeas.t;
@@ -118,14 +127,14 @@ function monitoredData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ,
                  referenceCombSPD = data.shiftSPD;
                  referenceTime = data.powerSPDt;
                  monitoredData.spectralAxis = spectralAxis;
-                 [~, ~, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(referenceCombSPD, referenceCombSPD, combPeaks, spectralAxis);
+                 [~, ~, fitParams, ~, referenceFitParams] = OLComputeSpectralShiftBetweenCombSPDs(referenceCombSPD, referenceCombSPD, combPeaks, spectralAxis);
                  monitoredData.timeSeries = [];
                  monitoredData.powerRatioSeries = [];
                  monitoredData.spectralShiftSeries = [];
                  monitoredData.temperatureSeries = [];
              else
                  newSPDRatio = 1.0 / (data.powerSPD(wavelengthIndices) \ referencePowerSPD);
-                 [spectralShifts, refPeaks, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(data.shiftSPD, referenceCombSPD, combPeaks, spectralAxis);
+                 [spectralShifts, refPeaks, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(data.shiftSPD, referenceCombSPD, combPeaks, spectralAxis, 'referenceFitParams', referenceFitParams);
                  monitoredData.timeSeries = cat(2, monitoredData.timeSeries, (data.powerSPDt-referenceTime)/60);
                  monitoredData.powerRatioSeries = cat(2, monitoredData.powerRatioSeries, newSPDRatio);
                  monitoredData.spectralShiftSeries = cat(2, monitoredData.spectralShiftSeries, median(spectralShifts));
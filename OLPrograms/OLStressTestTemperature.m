@@ -1,13 +1,32 @@
-function OLStressTestTemperature(box)
+function OLStressTestTemperature(box, varargin)
 % Stress-test OneLight while recording temperature
+%
+% With 'temperatureLogger', true the temperature is taken from a running
+% LJTemperatureLogger (see OLLabJackLibrary/src/LJTemperatureLogger), which
+% has the probe open and keeps its own complete log, rather than from the
+% probe.  'temperatureLoggerName' is the name of its shared memory, by
+% default the logger's default.
+
+parser = inputParser;
+parser.addParameter('temperatureLogger', false, @islogical);
+parser.addParameter('temperatureLoggerName', '', @ischar);
+parser.parse(varargin{:});
+useLogger = parser.Results.temperatureLogger;
+loggerName = parser.Results.temperatureLoggerName;
 
 %% Open devices
 % Open OneLight
 oneLight = OneLight;
 
 % Open temperature probe
-temperatureProbe = LJTemperatureProbe();
-temperatureProbe.open();
+if useLogger
+    temperatureProbe = [];
+    [~, ~, ~, running] = LJTemperatureLoggerLatest(loggerName);
+    assert(running, 'LJTemperatureLogger is not running');
+else
+    temperatureProbe = LJTemperatureProbe();
+    temperatureProbe.open();
+end
 
 %% Open some file
 bulbLogsDir = getpref('OneLightToolbox','BulbLogsDir');
@@ -28,20 +47,27 @@ while true
     end
 
     %% Measure temperature
-    [~, temperature] = temperatureProbe.measure();
+    if useLogger
+        temperature = LJTemperatureLoggerLatest(loggerName);
+    else
+        [~, temperature] = temperatureProbe.measure();
+    end
 
     %% Save measured temperature to some file
     onString = {'ALLON','ALLOFF'};
-    fprintf(fileID,'%s,%s,%2.2f,%2.2f,\n',datestr(now,'HH:MM:SS.FFF'),onString{allOn+1},temperature);
+    timeString = datestr(now,'HH:MM:SS.FFF');
+    fprintf(fileID,'%s,%s,%2.2f,%2.2f,\n',timeString,onString{allOn+1},temperature);
 
     %% Print measured temperature to console
-    fprintf('\t%s\t%s\t%2.2f\t%2.2f\n',datestr(now,'HH:MM:SS.FFF'),onString{allOn+1},temperature);
+    fprintf('\t%s\t%s\t%2.2f\t%2.2f\n',timeString,onString{allOn+1},temperature);
 end
 
 end
 
 function cleanup(temperatureProbe, oneLight, fileID)
     try fclose(fileID); end
-    try temperatureProbe.close(); end
+    if ~isempty(temperatureProbe)
+        try temperatureProbe.close(); end
+    end
     try oneLight.close(); end
 end
\ No newline at end of file
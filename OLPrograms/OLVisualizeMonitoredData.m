@@ -2,20 +2,36 @@
 %
 % Syntax:
 % OLVisualizeMonitoredData(monitoredData);
+% OLVisualizeMonitoredData(monitoredData, cal);
+% OLVisualizeMonitoredData(stateStoreDirectory, cal, timeWindow);
+%
+% In place of monitoredData, the directory of the time series stores that
+% OLMonitorStateWindow saved the measurements in can be given, optionally
+% with the time window [tStart tEnd] of the measurements to show.  Only
+% those are read.
 %
 % See testOLMonitorStateWindow for usage of this function.
 %
 % 9/12/16   npc     Wrote it.
+% 10/18/26          Read measurements in a time window from time series stores.
 %
 
 function OLVisualizeMonitoredData(varargin)
     
     monitoredData = varargin{1};
-    if (nargin == 2)
+    if (nargin >= 2)
         cal = varargin{2};
     else
         cal = [];
     end
+    if (ischar(monitoredData))
+        if (nargin >= 3)
+            timeWindow = varargin{3};
+        else
+            timeWindow = [];
+        end
+        monitoredData = monitoredDataFromStateStore(monitoredData, timeWindow);
+    end
     
     cal.describe
     measurementsNum = numel(monitoredData.measurements);
@@ -199,7 +215,7 @@ function [timeSeries, fitParamsTimeSeries, powerRatioSeries, spectralShiftSeries
     timeSeries(1) = -20;
     powerRatioSeries(1) = 1.0;
     spectralShiftSeries(1) = 0.0;
-    [~, ~, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(referenceCombSPD, referenceCombSPD, combPeaks, spectralAxis);
+    [~, ~, fitParams, ~, referenceFitParams] = OLComputeSpectralShiftBetweenCombSPDs(referenceCombSPD, referenceCombSPD, combPeaks, spectralAxis);
     fitParamsTimeSeries(:,:,1) = fitParams;
     
     progressHandle = generateProgressBar('Re-analyzing state measurements ...');
@@ -213,7 +229,7 @@ function [timeSeries, fitParamsTimeSeries, powerRatioSeries, spectralShiftSeries
         %data.powerSPDt 
         %data.datestr
         newSPDRatio = 1.0 / (data.powerSPD(wavelengthIndices) \ referencePowerSPD);
-        [spectralShifts, refPeaks, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(data.shiftSPD, referenceCombSPD, combPeaks, spectralAxis);
+        [spectralShifts, refPeaks, fitParams] = OLComputeSpectralShiftBetweenCombSPDs(data.shiftSPD, referenceCombSPD, combPeaks, spectralAxis, 'referenceFitParams', referenceFitParams);
         
         timeSeries = cat(2, timeSeries, (data.shiftSPDt-referenceTime)/60);
         powerRatioSeries = cat(2, powerRatioSeries, newSPDRatio);
@@ -224,6 +240,34 @@ function [timeSeries, fitParamsTimeSeries, powerRatioSeries, spectralShiftSeries
     
 end
 
+function monitoredData = monitoredDataFromStateStore(stateStoreDirectory, timeWindow)
+    % Measurements as OLMonitorStateWindow returns them. Each power
+    % fluctuation SPD is measured just before its comb SPD, so a window may
+    % have an unpaired one at either end, which is dropped.
+    stateMeas = OLCalibrator.LoadStateMeasurements(stateStoreDirectory, timeWindow);
+    powerMeas = stateMeas.powerFluctuationMeas;
+    shiftMeas = stateMeas.spectralShiftsMeas;
+    if (~isempty(shiftMeas.t) && ~isempty(powerMeas.t) && shiftMeas.t(1) < powerMeas.t(1))
+        shiftMeas.t = shiftMeas.t(2:end);
+        shiftMeas.measSpd = shiftMeas.measSpd(:,2:end);
+    end
+    measurementsNum = min(numel(powerMeas.t), numel(shiftMeas.t));
+    if (measurementsNum == 0)
+        error('There are no state measurements in the time window in ''%s''', stateStoreDirectory);
+    end
+
+    monitoredData.spectralAxis = SToWls(stateMeas.S);
+    monitoredData.measurements = cell(1, measurementsNum);
+    for k = 1:measurementsNum
+        data.shiftSPD  = shiftMeas.measSpd(:,k);
+        data.shiftSPDt = shiftMeas.t(k);
+        data.powerSPD  = powerMeas.measSpd(:,k);
+        data.powerSPDt = powerMeas.t(k);
+        data.datestr   = stateMeas.dateCreated;
+        monitoredData.measurements{k} = data;
+    end
+end
+
 function progressHandle = generateProgressBar(initialMessage)
     progressHandle = waitbar(0, '');
     titleHandle = get(findobj(progressHandle,'Type','axes'),'Title');
@@ -6,6 +6,7 @@ function OmniScope
 %
 % 1/2/14  dhb  Wrote it.
 % 1/3/14  dhb  Add lamp adjustment loop.
+% 10/18/26     Plot from an OmniAcquisition, so the loop doesn't wait on the spectrometer.
 
 % Close figs
 close all;
@@ -31,6 +32,11 @@ try
     od.IntegrationTime = round(0.95*od.IntegrationTime);
     fprintf('- Using integration time of %d microseconds.\n', od.IntegrationTime);
     
+    % Spectra are acquired in the background from here on, and the loop
+    % plots the latest one.  Averaging is already done by the spectrometer.
+    acquisition = OmniAcquisition(od, 'averagingWindow', 1);
+    acquisition.start();
+    wavelengths = od.Wavelengths;
     
     % Adjustment loop
     fprintf('- Adjustment loop, hit any key to exit\n');
@@ -41,22 +47,28 @@ try
     sampleTrack = 1;
     while (1)
         
+        % Wait for the first spectrum
+        [spectrum, ~, info] = acquisition.latest(1);
+        if isempty(spectrum)
+            drawnow;
+            continue;
+        end
+        
         % Update plot
-        meas.omni.time(1) = mglGetSecs;
-        try
-            meas.omni.spectrum = od.getSpectrum' / od.IntegrationTime;
-            plotColor = 'k';
-        catch e
-            meas.omni.spectrum = ones(1, length(od.Wavelengths));
+        if (info.saturated || ~info.valid)
+            meas.omni.spectrum = ones(1, length(wavelengths));
             plotColor = 'r';
             fprintf('*** Spectrum saturated! ***\n');
+        else
+            meas.omni.spectrum = spectrum;
+            plotColor = 'k';
         end
-        meas.omni.time(2) = mglGetSecs;
-        timeMeas(sampleTrack) = meas.omni.time(2);
+        meas.omni.time = info.t;
+        timeMeas(sampleTrack) = meas.omni.time;
         currentSum(sampleTrack) = sum(meas.omni.spectrum);
         
         subplot(1, 2, 1);
-        area(od.Wavelengths, meas.omni.spectrum, 'FaceColor', plotColor); hold on;
+        area(wavelengths, meas.omni.spectrum, 'FaceColor', plotColor); hold on;
         pbaspect([1 1 1]);
         xlabel('Wavelength [nm]');
         ylabel('Power');
@@ -91,6 +103,7 @@ try
         end
     end
     GetChar;
+    acquisition.stop();
     
     
     
@@ -2,6 +2,7 @@
 %
 % 9/12/16   npc     Wrote it.
 % 9/29/16   npc     Optionally record temperature
+% 10/18/26          Save measurements to time series stores as they are taken
 %
 
 function testOLMonitorStateWindow
@@ -29,14 +30,18 @@ else
 end
 
 
-% Collect state data until the user closes the monitoring window
-monitoredStateData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, 'takeTemperatureMeasurements', takeTemperatureMeasurements);
-
-% Save the monitored state data (optional)
+% Where to save the monitored state data
 outDir = fullfile(getpref('OneLightToolbox', 'OneLightCalData'), 'MonitoredStateData', char(cal.describe.calType), strrep(strrep(cal.describe.date, ' ', '_'), ':', '_'), datestr(now, 'mmddyy'));
 if ~exist(outDir)
     mkdir(outDir);
 end
+
+% Collect state data until the user closes the monitoring window. Each
+% measurement is saved in the StateStore directory as soon as it is taken.
+monitoredStateData = OLMonitorStateWindow(cal, ol, od, spectroRadiometerOBJ, meterToggle, nAverage, 'takeTemperatureMeasurements', takeTemperatureMeasurements, ...
+    'stateStoreDirectory', fullfile(outDir, 'StateStore'));
+
+% Save the monitored state data (optional)
 fprintf('Saving data to ''%s.mat''.\n', fullfile(outDir, 'MonitoredStateData'));
 save(fullfile(outDir, 'MonitoredStateData'), 'monitoredStateData');
 
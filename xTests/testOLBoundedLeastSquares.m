@@ -0,0 +1,51 @@
+classdef testOLBoundedLeastSquares < matlab.unittest.TestCase
+% Tests for OLBoundedLeastSquares
+
+% History:
+%    10/18/26      Wrote it.
+
+    methods (Test)
+        function interiorSolutionIsUnconstrained(testCase)
+            % Solution inside box matches plain least squares
+            C = [eye(3) ; 1 1 1];
+            xTrue = [.2 .5 .7]';
+            d = C*xTrue;
+            x = OLBoundedLeastSquares(C'*C, C'*d, zeros(3,1), ones(3,1));
+            verifyEqual(testCase, x, xTrue, 'AbsTol', 1e-10);
+        end
+        function clampsToBounds(testCase)
+            % Independent variables are clamped to their bounds
+            C = eye(3);
+            d = [-.5 .5 1.5]';
+            x = OLBoundedLeastSquares(C'*C, C'*d, zeros(3,1), ones(3,1));
+            verifyEqual(testCase, x, [0 .5 1]', 'AbsTol', 1e-10);
+        end
+        function coupledVariables(testCase)
+            % Holding the first variable at 0 changes the best second one
+            C = [1 0 ; 1 1];
+            d = [-1 1]';
+            [x, info] = OLBoundedLeastSquares(C'*C, C'*d, zeros(2,1), ones(2,1));
+            verifyEqual(testCase, x, [0 1]', 'AbsTol', 1e-10);
+            verifyTrue(testCase, info.converged);
+            verifyEqual(testCase, info.atLower, [true false]');
+        end
+        function differentialBounds(testCase)
+            % Works with [-1,1] bounds
+            C = eye(2);
+            d = [-2 .3]';
+            x = OLBoundedLeastSquares(C'*C, C'*d, -ones(2,1), ones(2,1));
+            verifyEqual(testCase, x, [-1 .3]', 'AbsTol', 1e-10);
+        end
+        function warmStartGivesSameAnswer(testCase)
+            % Starting from a nearby point converges to same solution
+            C = [magic(4) ; eye(4)];
+            d = C*[1.5 -.2 .4 .9]';
+            H = C'*C; f = C'*d;
+            lb = zeros(4,1); ub = ones(4,1);
+            xCold = OLBoundedLeastSquares(H, f, lb, ub);
+            [xWarm, info] = OLBoundedLeastSquares(H, f, lb, ub, 'initialX', xCold + 0.01);
+            verifyEqual(testCase, xWarm, xCold, 'AbsTol', 1e-10);
+            verifyTrue(testCase, info.converged);
+        end
+    end
+end
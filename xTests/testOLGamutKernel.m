@@ -0,0 +1,34 @@
+classdef testOLGamutKernel < matlab.unittest.TestCase
+% Tests for OLGamutKernel
+
+% History:
+%    10/18/26      Wrote it.
+
+    methods (Test)
+        function matchesTruncateThenCheck(testCase)
+            % Same as OLTruncateGamutTolerance followed by OLCheckPrimaryValues
+            primaryValues = [.9 1.04 1.1 ; .1 -.04 -.1];
+            [truncated, inGamut, gamutMargins] = OLGamutKernel(primaryValues, [0 1], .05);
+            expected = OLTruncateGamutTolerance(primaryValues, [0 1], .05);
+            [expectedInGamut, expectedMargins] = OLCheckPrimaryValues(expected, [0 1]);
+            verifyEqual(testCase, truncated, expected);
+            verifyEqual(testCase, inGamut, expectedInGamut);
+            verifyEqual(testCase, gamutMargins, expectedMargins);
+        end
+        function withinToleranceIsInGamut(testCase)
+            % Small violations are truncated to gamut and count as in
+            [truncated, inGamut, gamutMargins] = OLGamutKernel([-1e-7 .5 1+1e-7], [0 1], 1e-6);
+            verifyEqual(testCase, truncated, [0 .5 1]);
+            verifyTrue(testCase, inGamut);
+            verifyEqual(testCase, gamutMargins, [0 0], 'AbsTol', 1e-12);
+        end
+        function largeWaveform(testCase)
+            % Primaries x frames matrix, differential gamut
+            primaryValues = 2.2*rand(54,5000) - 1.1;
+            [truncated, inGamut, gamutMargins] = OLGamutKernel(primaryValues, [-1 1], 1e-5);
+            verifyEqual(testCase, truncated, OLTruncateGamutTolerance(primaryValues, [-1 1], 1e-5));
+            verifyFalse(testCase, inGamut);
+            verifyEqual(testCase, gamutMargins, OLGamutMargins(truncated, [-1 1]));
+        end
+    end
+end
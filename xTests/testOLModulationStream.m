@@ -0,0 +1,54 @@
+classdef testOLModulationStream < matlab.unittest.TestCase
+% Tests for OLModulationStream
+
+% History:
+%    10/18/26      Wrote it.
+
+    properties
+        calibration;
+    end
+
+    methods (TestClassSetup)
+        function loadCalibration(testCase)
+            testCase.calibration = OLGetCalibrationStructure('CalibrationFolder',fileparts(which('OLDemoCal.mat')), ...
+                'CalibrationType','DemoCal','CalibrationDate','latest','WriteCacheFiles',false);
+        end
+    end
+
+    methods (Access = private)
+        function stream = makeStream(testCase, nFrames, cacheSize)
+            P = testCase.calibration.describe.numWavelengthBands;
+            waveform = [ones(1,nFrames) ; 0.4*sin(2*pi*(1:nFrames)/nFrames)];
+            primaryValues = [0.5*ones(P,1) linspace(-1,1,P)'];
+            stream = OLModulationStream(primaryValues, waveform, testCase.calibration, 'cacheSize', cacheSize);
+        end
+    end
+
+    methods (Test)
+        function prefetchAcrossWrap(testCase)
+            % NFrames not a multiple of CacheSize: the lookahead across the
+            % end of the modulation must not evict its own frames
+            stream = testCase.makeStream(250, 200);
+            stream.startsStops(240);
+            nConverted = 0;
+            while stream.prefetchNext()
+                nConverted = nConverted + 1;
+                assert(nConverted <= 250, 'prefetchNext never ran out of frames');
+            end
+            % Frames 241-250 and 1-40; frame 41 would take frame 241's slot
+            verifyEqual(testCase, nConverted, 50);
+            verifyTrue(testCase, all(stream.isCached([241:250 1:40])));
+        end
+        function prefetchedFramesMatch(testCase)
+            % Prefetched frames are the ones converted on request
+            stream = testCase.makeStream(30, 20);
+            stream.startsStops(1);
+            while stream.prefetchNext()
+            end
+            [starts, stops] = stream.startsStops(2:5);
+            [startsAll, stopsAll] = OLPrimaryToStartsStops(stream.primaryFrames(2:5), testCase.calibration);
+            verifyEqual(testCase, starts, startsAll);
+            verifyEqual(testCase, stops, stopsAll);
+        end
+    end
+end
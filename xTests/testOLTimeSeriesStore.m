@@ -0,0 +1,53 @@
+classdef testOLTimeSeriesStore < matlab.unittest.TestCase
+% Tests for OLTimeSeriesStore
+
+% History:
+%    10/18/26      Wrote it.
+
+    properties
+        directory;
+    end
+
+    methods (TestMethodSetup)
+        function makeDirectory(testCase)
+            testCase.directory = tempname;
+        end
+    end
+
+    methods (TestMethodTeardown)
+        function removeDirectory(testCase)
+            if exist(testCase.directory, 'dir')
+                rmdir(testCase.directory, 's');
+            end
+        end
+    end
+
+    methods (Test)
+        function firstAppendToNewStore(testCase)
+            % A new store takes its first sample, and gives it back
+            store = OLTimeSeriesStore(testCase.directory, 'nValues', 3);
+            store.append(10, [1 ; 2 ; 3]);
+            verifyEqual(testCase, store.Count, 1);
+            [t, values] = store.range(0, 20);
+            verifyEqual(testCase, t, 10);
+            verifyEqual(testCase, values, [1 ; 2 ; 3]);
+        end
+        function reopenedAcrossChunks(testCase)
+            % Samples spread over chunks are found again after reopening
+            store = OLTimeSeriesStore(testCase.directory, 'nValues', 2, 'chunkSize', 4);
+            values = reshape(1:20, 2, 10);
+            store.append(1:10, values);
+            store = OLTimeSeriesStore(testCase.directory);
+            verifyEqual(testCase, store.Count, 10);
+            [t, rangeValues] = store.range(3, 7);
+            verifyEqual(testCase, t, 3:7);
+            verifyEqual(testCase, rangeValues, values(:,3:7));
+        end
+        function decreasingTimeRejected(testCase)
+            store = OLTimeSeriesStore(testCase.directory, 'nValues', 1);
+            store.append(5, 1);
+            verifyError(testCase, @() store.append(4, 2), ...
+                'OneLightToolbox:OLTimeSeriesStore:TimeNotIncreasing');
+        end
+    end
+end
@@ -0,0 +1,82 @@
+classdef testOLTraceExport < matlab.unittest.TestCase
+% Tests for OLTrace and OLTraceExport
+
+% History:
+%    10/18/26      Wrote it.
+
+    properties
+        fileName;
+    end
+
+    methods (TestMethodSetup)
+        function startTrace(testCase)
+            testCase.fileName = [tempname '.json'];
+            OLTrace('clear');
+            OLTrace('enable');
+        end
+    end
+
+    methods (TestMethodTeardown)
+        function stopTrace(testCase)
+            OLTrace('disable');
+            OLTrace('clear');
+            if exist(testCase.fileName, 'file')
+                delete(testCase.fileName);
+            end
+        end
+    end
+
+    methods (Test)
+        function nestedSpans(testCase)
+            % Inner span lies within the outer one, in the file written
+            OLTrace('begin', 'outer');
+            OLTrace('begin', 'inner');
+            pause(0.01);
+            OLTrace('end', 'inner');
+            OLTrace('end', 'outer');
+            events = OLTraceExport(testCase.fileName);
+            verifyEqual(testCase, {events.name}, {'outer' 'inner' 'inner' 'outer'});
+            verifyEqual(testCase, [events.phase], 'BBEE');
+
+            spans = spanEvents(testCase.fileName);
+            verifyEqual(testCase, {spans.name}, {events.name});
+            verifyGreaterThanOrEqual(testCase, spans(3).ts - spans(2).ts, 10e3*0.9);
+            verifyGreaterThanOrEqual(testCase, spans(4).ts, spans(3).ts);
+        end
+        function spanEndsOnCleanup(testCase)
+            % The span of OLTraceSpan ends when its object is cleared
+            span = OLTraceSpan('scoped');
+            clear span;
+            events = OLTraceExport(testCase.fileName);
+            verifyEqual(testCase, [events.phase], 'BE');
+        end
+        function unmatchedEndsDropped(testCase)
+            % Ends of spans begun before tracing was enabled are left out
+            OLTrace('end', 'begunEarlier');
+            OLTrace('begin', 'quote"name');
+            OLTrace('end', 'quote"name');
+            events = OLTraceExport(testCase.fileName);
+            verifyEqual(testCase, {events.name}, {'quote"name' 'quote"name'});
+            spans = spanEvents(testCase.fileName);
+            verifyEqual(testCase, spans(1).name, 'quote"name');
+        end
+        function nothingWhenDisabled(testCase)
+            OLTrace('disable');
+            OLTrace('begin', 'ignored');
+            OLTrace('end', 'ignored');
+            events = OLTraceExport(testCase.fileName);
+            verifyEmpty(testCase, events);
+        end
+    end
+end
+
+function spans = spanEvents(fileName)
+% The begin and end events of a trace file, without the metadata events
+trace = jsondecode(fileread(fileName));
+traceEvents = trace.traceEvents;
+if (isstruct(traceEvents))
+    traceEvents = num2cell(traceEvents);
+end
+isSpan = cellfun(@(e) ~strcmp(e.ph, 'M'), traceEvents);
+spans = [traceEvents{isSpan}];
+end